@@ -253,6 +253,15 @@ public:
     bool
     fetch (void const* key, Handler&& handler);
 
+    /** Returns the index of the key file bucket holding a key.
+
+        Buckets split as the database grows, so the result is only
+        a hint. Callers use it to order a group of fetches so that
+        the key file is read front to back.
+    */
+    std::size_t
+    bucket_of (void const* key);
+
     /** Insert a value.
 
         Returns:
@@ -459,6 +468,17 @@ next:
     return fetch(h, key, b, handler);
 }
 
+template <class Hasher, class Codec, class File>
+std::size_t
+store<Hasher, Codec, File>::bucket_of (void const* key)
+{
+    using namespace detail;
+    auto const h = hash<Hasher>(
+        key, s_->kh.key_size, s_->kh.salt);
+    shared_lock_type m (m_);
+    return bucket_index(h, buckets_, modulus_);
+}
+
 template <class Hasher, class Codec, class File>
 bool
 store<Hasher, Codec, File>::insert (
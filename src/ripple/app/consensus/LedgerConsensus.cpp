@@ -34,6 +34,7 @@
 #include <ripple/app/tx/TransactionAcquire.h>
 #include <ripple/basics/CountedObject.h>
 #include <ripple/basics/Log.h>
+#include <ripple/basics/parallel_for.h>
 #include <ripple/core/Config.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/core/LoadFeeTrack.h>
@@ -42,6 +43,10 @@
 #include <ripple/overlay/predicates.h>
 #include <ripple/protocol/STValidation.h>
 #include <ripple/protocol/UintTypes.h>
+#include <atomic>
+#include <functional>
+#include <set>
+#include <vector>
 
 namespace ripple {
 
@@ -1053,7 +1058,13 @@ private:
             WriteLog (lsDEBUG, LedgerConsensus)
                 << "Applying consensus set transactions to the"
                 << " last closed ledger";
-            applyTransactions (set, newLCL, newLCL, retriableTransactions, false);
+            applyTransactions (set, newLCL, newLCL, retriableTransactions,
+                false, getConfig ().LEDGER_APPLY_THREADS,
+                [] (std::function <void ()> task)
+                {
+                    getApp().getJobQueue ().addJob (jtACCEPT,
+                        "applyTransactions", [task] (Job&) { task (); });
+                });
             newLCL->updateSkipList ();
             newLCL->setClosed ();
 
@@ -2001,19 +2012,16 @@ make_LedgerConsensus (LedgerConsensus::clock_type& clock, LocalTxs& localtx,
         prevLCLHash, previousLedger, closeTime, feeVote);
 }
 
-/** Apply a transaction to a ledger
+/** Choose the engine parameters for applying a transaction
 
-  @param engine       The transaction engine containing the ledger.
   @param txn          The transaction to be applied to ledger.
   @param openLedger   true if ledger is open
   @param retryAssured true if the transaction should be retried on failure.
-  @return             One of resultSuccess, resultFail or resultRetry.
 */
 static
-int applyTransaction (TransactionEngine& engine
-    , STTx::ref txn, bool openLedger, bool retryAssured)
+TransactionEngineParams applyParams (
+    STTx::ref txn, bool openLedger, bool retryAssured)
 {
-    // Returns false if the transaction has need not be retried.
     TransactionEngineParams parms = openLedger ? tapOPEN_LEDGER : tapNONE;
 
     if (retryAssured)
@@ -2027,42 +2035,244 @@ int applyTransaction (TransactionEngine& engine
         parms = static_cast<TransactionEngineParams>
             (parms | tapNO_CHECK_SIGN);
     }
+
+    return parms;
+}
+
+/** Classify the outcome of applying a transaction
+
+  @return             One of resultSuccess, resultFail or resultRetry.
+*/
+static
+int applyResult (TER result, bool didApply)
+{
+    if (didApply)
+    {
+        WriteLog (lsDEBUG, LedgerConsensus)
+        << "Transaction success: " << transHuman (result);
+        return LedgerConsensusImp::resultSuccess;
+    }
+
+    if (isTefFailure (result) || isTemMalformed (result) ||
+        isTelLocal (result))
+    {
+        // failure
+        WriteLog (lsDEBUG, LedgerConsensus)
+            << "Transaction failure: " << transHuman (result);
+        return LedgerConsensusImp::resultFail;
+    }
+
+    WriteLog (lsDEBUG, LedgerConsensus)
+        << "Transaction retry: " << transHuman (result);
+    return LedgerConsensusImp::resultRetry;
+}
+
+/** Apply a transaction to a ledger
+
+  @param engine       The transaction engine containing the ledger.
+  @param txn          The transaction to be applied to ledger.
+  @param parms        The parameters chosen by applyParams.
+  @return             One of resultSuccess, resultFail or resultRetry.
+*/
+static
+int applyTransaction (TransactionEngine& engine
+    , STTx::ref txn, TransactionEngineParams parms)
+{
     WriteLog (lsDEBUG, LedgerConsensus) << "TXN "
         << txn->getTransactionID ()
-        << (openLedger ? " open" : " closed")
-        << (retryAssured ? "/retry" : "/final");
+        << ((parms & tapOPEN_LEDGER) ? " open" : " closed")
+        << ((parms & tapRETRY) ? "/retry" : "/final");
     WriteLog (lsTRACE, LedgerConsensus) << txn->getJson (0);
 
     try
     {
         bool didApply;
         TER result = engine.applyTransaction (*txn, parms, didApply);
+        return applyResult (result, didApply);
+    }
+    catch (...)
+    {
+        WriteLog (lsWARNING, LedgerConsensus) << "Throws";
+        return LedgerConsensusImp::resultFail;
+    }
+}
+
+/** Apply a transaction to a ledger
+
+  @param engine       The transaction engine containing the ledger.
+  @param txn          The transaction to be applied to ledger.
+  @param openLedger   true if ledger is open
+  @param retryAssured true if the transaction should be retried on failure.
+  @return             One of resultSuccess, resultFail or resultRetry.
+*/
+static
+int applyTransaction (TransactionEngine& engine
+    , STTx::ref txn, bool openLedger, bool retryAssured)
+{
+    return applyTransaction (engine, txn,
+        applyParams (txn, openLedger, retryAssured));
+}
+
+// Pseudo-transactions change the fees and amendments of the ledger
+static
+bool isPseudoTx (STTx const& txn)
+{
+    auto const type = txn.getTxnType ();
+    return (type == ttAMENDMENT) || (type == ttFEE);
+}
+
+/** A transaction run ahead of time against a snapshot of the ledger. */
+struct SpeculativeTx
+{
+    STTx::pointer txn;
+    TransactionEngineParams parms;
 
-        if (didApply)
+    // Set if the transaction ran without throwing
+    bool prepared = false;
+    TER result = tesSUCCESS;
+    bool didApply = false;
+
+    // The changes it would make, and the state they depend on
+    LedgerEntrySet nodes;
+    std::shared_ptr<LedgerReadSet> reads;
+};
+
+/** Apply the candidate transactions of a set on several threads
+
+  Every candidate is first run on a worker thread against an immutable
+  snapshot of the ledger, recording the entries and key ranges it read.
+  The results are then committed to the ledger in the set's order. A
+  result is only used if nothing it read has been written by a
+  transaction committed before it; otherwise the transaction is applied
+  again, serially, against the real ledger. The ledger built is therefore
+  the same as the one built by applying the set serially.
+
+  Pseudo-transactions can change the fee schedule and amendments that
+  every transaction consults, so after one is committed the remaining
+  candidates are applied serially.
+
+  @param threads The number of threads, including the calling thread.
+  @param schedule Starts each helper task.
+*/
+static
+void applyInParallel (TransactionEngine& engine,
+    std::shared_ptr<SHAMap> const& set, Ledger::ref checkLedger,
+    CanonicalTXSet& retriableTransactions, bool openLgr, int threads,
+    std::function <void (std::function <void ()>)> const& schedule)
+{
+    std::vector<SpeculativeTx> candidates;
+
+    // Parameters are chosen in set order, as the serial pass would
+    for (auto const& item : *set)
+    {
+        // If the checkLedger doesn't have the transaction
+        if (checkLedger->hasTransaction (item->getTag ()))
+            continue;
+
+        WriteLog (lsINFO, LedgerConsensus) <<
+            "Processing candidate transaction: " << item->getTag ();
+        try
         {
-            WriteLog (lsDEBUG, LedgerConsensus)
-            << "Transaction success: " << transHuman (result);
-            return LedgerConsensusImp::resultSuccess;
+            SerialIter sit (item->peekSerializer ());
+            SpeculativeTx candidate;
+            candidate.txn = std::make_shared<STTx>(sit);
+            candidate.parms = applyParams (candidate.txn, openLgr, true);
+            candidates.push_back (std::move (candidate));
         }
-
-        if (isTefFailure (result) || isTemMalformed (result) ||
-            isTelLocal (result))
+        catch (...)
         {
-            // failure
-            WriteLog (lsDEBUG, LedgerConsensus)
-                << "Transaction failure: " << transHuman (result);
-            return LedgerConsensusImp::resultFail;
+            WriteLog (lsWARNING, LedgerConsensus) << "  Throws";
         }
-
-        WriteLog (lsDEBUG, LedgerConsensus)
-            << "Transaction retry: " << transHuman (result);
-        return LedgerConsensusImp::resultRetry;
     }
-    catch (...)
+
+    Ledger::pointer snapshot = std::make_shared<Ledger> (
+        *engine.getLedger (), false);
+
+    // Candidates are prepared by this thread and by up to threads - 1
+    // helper tasks, each against its own view of the snapshot
+    parallel_for (candidates.size (), threads - 1, schedule,
+        [&candidates, &snapshot] (std::size_t i)
+        {
+            SpeculativeTx& c = candidates[i];
+
+            if (isPseudoTx (*c.txn))
+                return true;
+
+            TransactionEngine spec (snapshot);
+            c.reads = std::make_shared<LedgerReadSet> ();
+            spec.view ().setReadSet (c.reads);
+
+            try
+            {
+                c.result = spec.prepareTransaction (
+                    *c.txn, c.parms, c.didApply);
+                spec.view ().swapWith (c.nodes);
+                c.prepared = true;
+            }
+            catch (...)
+            {
+                // Applied again, serially, to reproduce the failure
+            }
+
+            spec.view ().setReadSet (nullptr);
+            return true;
+        });
+
+    // Everything written to the ledger since the snapshot
+    std::set<uint256> written;
+    engine.trackWrites (&written);
+
+    bool stale = false;
+    int reused = 0;
+
+    for (auto& c : candidates)
     {
-        WriteLog (lsWARNING, LedgerConsensus) << "Throws";
-        return LedgerConsensusImp::resultFail;
+        int result;
+
+        if (!stale && c.prepared && !c.reads->intersects (written))
+        {
+            WriteLog (lsDEBUG, LedgerConsensus) << "TXN "
+                << c.txn->getTransactionID () << " speculative";
+
+            engine.adoptView (c.nodes);
+
+            try
+            {
+                bool didApply = c.didApply;
+                TER const ter = engine.commitTransaction (
+                    *c.txn, c.result, c.parms, didApply);
+                result = applyResult (ter, didApply);
+            }
+            catch (...)
+            {
+                WriteLog (lsWARNING, LedgerConsensus) << "Throws";
+                result = LedgerConsensusImp::resultFail;
+            }
+
+            ++reused;
+        }
+        else
+        {
+            result = applyTransaction (engine, c.txn, c.parms);
+        }
+
+        // On failure, stash the failed transaction for later retry.
+        if (result == LedgerConsensusImp::resultRetry)
+            retriableTransactions.push_back (c.txn);
+
+        if (isPseudoTx (*c.txn))
+            stale = true;
+
+        // Release the prepared changes as we go
+        c.nodes = LedgerEntrySet ();
+        c.reads.reset ();
     }
+
+    engine.trackWrites (nullptr);
+
+    WriteLog (lsDEBUG, LedgerConsensus) << "Applied " << reused << " of "
+        << candidates.size () << " transactions speculatively with up to "
+        << threads << " threads";
 }
 
 /** Apply a set of transactions to a ledger
@@ -2074,14 +2284,24 @@ int applyTransaction (TransactionEngine& engine
                                messages (typically new last closed ledger).
   @param retriableTransactions collect failed transactions in this set
   @param openLgr               true if applyLedger is open, else false.
+  @param threads               Threads to apply the set with; 1 applies
+                               it serially.
+  @param schedule              Starts the helper tasks for the other
+                               threads.
 */
 void applyTransactions (std::shared_ptr<SHAMap> const& set,
     Ledger::ref applyLedger, Ledger::ref checkLedger,
-    CanonicalTXSet& retriableTransactions, bool openLgr)
+    CanonicalTXSet& retriableTransactions, bool openLgr, int threads,
+    std::function <void (std::function <void ()>)> const& schedule)
 {
     TransactionEngine engine (applyLedger);
 
-    if (set)
+    if (set && (threads > 1) && schedule)
+    {
+        applyInParallel (engine, set, checkLedger,
+            retriableTransactions, openLgr, threads, schedule);
+    }
+    else if (set)
     {
         for (std::shared_ptr<SHAMapItem> item = set->peekFirstItem (); !!item;
             item = set->peekNextItem (item->getTag ()))
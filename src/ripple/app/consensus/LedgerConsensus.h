@@ -30,6 +30,7 @@
 #include <ripple/protocol/RippleLedgerHash.h>
 #include <beast/chrono/abstract_clock.h>
 #include <chrono>
+#include <functional>
 
 namespace ripple {
 
@@ -96,10 +97,20 @@ make_LedgerConsensus (LedgerConsensus::clock_type& clock, LocalTxs& localtx,
     LedgerHash const & prevLCLHash, Ledger::ref previousLedger,
         std::uint32_t closeTime, FeeVote& feeVote);
 
+/** Apply a set of transactions to a ledger.
+
+    With more than one thread, the candidate transactions are run against a
+    snapshot by the caller and by up to threads - 1 helper tasks started
+    through schedule, then committed in order, rerunning serially any whose
+    inputs changed. The result matches a serial application.
+*/
 void
 applyTransactions(std::shared_ptr<SHAMap> const& set, Ledger::ref applyLedger,
                   Ledger::ref checkLedger,
-                  CanonicalTXSet& retriableTransactions, bool openLgr);
+                  CanonicalTXSet& retriableTransactions, bool openLgr,
+                  int threads = 1,
+                  std::function <void (std::function <void ()>)> const&
+                      schedule = nullptr);
 
 } // ripple
 
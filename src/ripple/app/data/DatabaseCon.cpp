@@ -20,6 +20,8 @@
 #include <BeastConfig.h>
 #include <ripple/app/data/DatabaseCon.h>
 #include <ripple/app/data/SqliteDatabase.h>
+#include <ripple/basics/Log.h>
+#include <beast/insight/NullCollector.h>
 
 namespace ripple {
 
@@ -27,6 +29,9 @@ DatabaseCon::DatabaseCon (Setup const& setup,
         std::string const& strName,
         const char* initStrings[],
         int initCount)
+    : mName (boost::filesystem::path (strName).stem ().string ())
+    , mCollector (setup.collector ? setup.collector
+        : beast::insight::NullCollector::New ())
 {
     auto const useTempFiles  // Use temporary files or regular DB files?
         = setup.standAlone &&
@@ -41,14 +46,138 @@ DatabaseCon::DatabaseCon (Setup const& setup,
 
     for (int i = 0; i < initCount; ++i)
         mDatabase->executeSQL (initStrings[i], true);
+
+    // Temporary databases are private to their connection
+    if (!pPath.empty () && setup.readers > 0)
+        openReaders (pPath.string (), setup.readers);
 }
 
 DatabaseCon::~DatabaseCon ()
 {
+    for (auto& reader : mReaders)
+        reader->disconnect ();
+    mReaders.clear ();
+
     mDatabase->disconnect ();
     delete mDatabase;
 }
 
+void DatabaseCon::openReaders (std::string const& path, int count)
+{
+    // Without WAL a reader would block the writer, so there is no point
+    std::string mode;
+    if (!mDatabase->executeSQL ("PRAGMA journal_mode;", true) ||
+        !mDatabase->startIterRows ())
+        return;
+    mDatabase->getStr (0, mode);
+    mDatabase->endIterRows ();
+
+    if (mode != "wal")
+        return;
+
+    for (int i = 0; i < count; ++i)
+    {
+        std::unique_ptr <SqliteDatabase> reader (
+            new SqliteDatabase (path.c_str (), true));
+        reader->connect ();
+
+        if (reader->peekConnection () == nullptr)
+        {
+            WriteLog (lsWARNING, DatabaseCon) << "Can't open reader for " <<
+                path;
+            break;
+        }
+
+        mIdle.push_back (reader.get ());
+        mReaders.push_back (std::move (reader));
+    }
+}
+
+DatabaseCon::QueryEvents& DatabaseCon::events (std::string const& kind)
+{
+    std::lock_guard <std::mutex> sl (mPoolLock);
+
+    auto iter = mEvents.find (kind);
+
+    if (iter == mEvents.end ())
+    {
+        QueryEvents& events = mEvents[kind];
+        std::string const prefix = mName + "." + kind;
+        events.queue = mCollector->make_event (prefix + ".queue");
+        events.exec = mCollector->make_event (prefix + ".exec");
+        return events;
+    }
+
+    return iter->second;
+}
+
+DatabaseCon::Reader DatabaseCon::read (std::string const& kind)
+{
+    return Reader (*this, events (kind));
+}
+
+//------------------------------------------------------------------------------
+
+DatabaseCon::Reader::Reader (DatabaseCon& con, QueryEvents& events)
+    : mCon (&con)
+    , mPooled (nullptr)
+    , mDatabase (nullptr)
+    , mEvents (&events)
+{
+    auto const start = clock_type::now ();
+
+    if (con.mReaders.empty ())
+    {
+        mLock = con.lock ();
+        mDatabase = con.mDatabase;
+    }
+    else
+    {
+        std::unique_lock <std::mutex> sl (con.mPoolLock);
+        con.mPoolCond.wait (sl, [&con] { return !con.mIdle.empty (); });
+        mPooled = con.mIdle.back ();
+        con.mIdle.pop_back ();
+        mDatabase = mPooled;
+    }
+
+    mStart = clock_type::now ();
+    mEvents->queue.notify (mStart - start);
+}
+
+DatabaseCon::Reader::Reader (Reader&& other)
+    : mCon (other.mCon)
+    , mPooled (other.mPooled)
+    , mDatabase (other.mDatabase)
+    , mLock (std::move (other.mLock))
+    , mEvents (other.mEvents)
+    , mStart (other.mStart)
+{
+    other.mPooled = nullptr;
+    other.mDatabase = nullptr;
+    other.mEvents = nullptr;
+}
+
+DatabaseCon::Reader::~Reader ()
+{
+    if (mEvents == nullptr)
+        return;
+
+    mEvents->exec.notify (clock_type::now () - mStart);
+
+    if (mPooled != nullptr)
+    {
+        // A statement left open would hold back WAL checkpoints
+        mPooled->endIterRows ();
+
+        {
+            std::lock_guard <std::mutex> sl (mCon->mPoolLock);
+            mCon->mIdle.push_back (mPooled);
+        }
+
+        mCon->mPoolCond.notify_one ();
+    }
+}
+
 DatabaseCon::Setup
 setup_DatabaseCon (Config const& c)
 {
@@ -59,6 +188,7 @@ setup_DatabaseCon (Config const& c)
     setup.startUp = c.START_UP;
     setup.standAlone = c.RUN_STANDALONE;
     setup.dataDir = c.legacy ("database_path");
+    setup.readers = c.DATABASE_READERS;
 
     return setup;
 }
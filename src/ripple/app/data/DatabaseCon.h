@@ -22,13 +22,21 @@
 
 #include <ripple/app/data/Database.h>
 #include <ripple/core/Config.h>
+#include <beast/insight/Collector.h>
+#include <beast/insight/Event.h>
 #include <boost/filesystem/path.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 namespace ripple {
 
 class Database;
+class SqliteDatabase;
 
 // VFALCO NOTE This looks like a pointless class. Figure out
 //         what purpose it is really trying to serve and do it better.
@@ -41,6 +49,55 @@ public:
         Config::StartUpType startUp = Config::NORMAL;
         bool standAlone = false;
         boost::filesystem::path dataDir;
+
+        /** Read-only connections to open if the database uses WAL. */
+        int readers = 0;
+
+        /** Receives the queue and execution times of read queries. */
+        beast::insight::Collector::ptr collector;
+    };
+
+    typedef std::recursive_mutex mutex;
+
+private:
+    typedef std::chrono::steady_clock clock_type;
+
+    struct QueryEvents
+    {
+        beast::insight::Event queue;
+        beast::insight::Event exec;
+    };
+
+public:
+    /** A connection checked out for a read-only query.
+
+        The connection goes back to the pool when this is destroyed. If
+        the database has no readers, this holds the lock on the write
+        connection instead, exactly as lock() would.
+    */
+    class Reader
+    {
+    public:
+        Reader (Reader&& other);
+        Reader& operator= (Reader const&) = delete;
+        ~Reader ();
+
+        Database* getDB () const
+        {
+            return mDatabase;
+        }
+
+    private:
+        friend class DatabaseCon;
+
+        Reader (DatabaseCon& con, QueryEvents& events);
+
+        DatabaseCon* mCon;
+        SqliteDatabase* mPooled;
+        Database* mDatabase;
+        std::unique_lock<mutex> mLock;
+        QueryEvents* mEvents;
+        clock_type::time_point mStart;
     };
 
     DatabaseCon (Setup const& setup,
@@ -54,8 +111,6 @@ public:
         return mDatabase;
     }
 
-    typedef std::recursive_mutex mutex;
-
     std::unique_lock<mutex> lock ()
     {
         return std::unique_lock<mutex>(mLock);
@@ -66,9 +121,38 @@ public:
         return mLock;
     }
 
+    /** Check out a connection for a query that does not write.
+
+        Readers see the last committed state of the database and do not
+        wait on the write connection. When all of them are busy, this
+        blocks until one is returned.
+
+        @param kind Names the query in the queue and execution time
+                    events reported to the collector.
+    */
+    Reader read (std::string const& kind);
+
+    /** Returns the number of read-only connections, which may be zero. */
+    int readers () const
+    {
+        return static_cast <int> (mReaders.size ());
+    }
+
 private:
+    void openReaders (std::string const& path, int count);
+    QueryEvents& events (std::string const& kind);
+
     Database* mDatabase;
     mutex  mLock;
+
+    std::string mName;
+    beast::insight::Collector::ptr mCollector;
+
+    std::vector <std::unique_ptr <SqliteDatabase>> mReaders;
+    std::vector <SqliteDatabase*> mIdle;
+    std::map <std::string, QueryEvents> mEvents;
+    std::mutex mPoolLock;
+    std::condition_variable mPoolCond;
 };
 
 //------------------------------------------------------------------------------
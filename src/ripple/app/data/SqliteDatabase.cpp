@@ -53,13 +53,15 @@ SqliteStatement::~SqliteStatement ()
 
 //------------------------------------------------------------------------------
 
-SqliteDatabase::SqliteDatabase (const char* host)
+SqliteDatabase::SqliteDatabase (const char* host, bool readOnly)
     : Database (host)
     , Thread ("sqlitedb")
     , mWalQ (nullptr)
     , walRunning (false)
+    , mReadOnly (readOnly)
 {
-    startThread ();
+    if (! mReadOnly)
+        startThread ();
 
     mConnection     = nullptr;
     mAuxConnection  = nullptr;
@@ -74,13 +76,17 @@ SqliteDatabase::~SqliteDatabase ()
 
 void SqliteDatabase::connect ()
 {
-    int rc = sqlite3_open_v2 (mHost.c_str (), &mConnection,
-                SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX, nullptr);
+    int const flags = mReadOnly
+        ? (SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX)
+        : (SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX);
+
+    int rc = sqlite3_open_v2 (mHost.c_str (), &mConnection, flags, nullptr);
 
     if (rc)
     {
         WriteLog (lsFATAL, SqliteDatabase) << "Can't open " << mHost << " " << rc;
         sqlite3_close (mConnection);
+        mConnection = nullptr;
         assert ((rc != SQLITE_BUSY) && (rc != SQLITE_LOCKED));
     }
 }
@@ -419,7 +425,8 @@ Blob SqliteStatement::getBlob (int column)
 {
     int size = sqlite3_column_bytes (statement, column);
     Blob ret (size);
-    memcpy (& (ret.front ()), sqlite3_column_blob (statement, column), size);
+    if (size != 0)
+        memcpy (& (ret.front ()), sqlite3_column_blob (statement, column), size);
     return ret;
 }
 
@@ -34,7 +34,12 @@ class SqliteDatabase
     , private beast::Thread
 {
 public:
-    explicit SqliteDatabase (char const* host);
+    /** Create a database handle.
+        A read-only handle opens its connection without the mutex, so
+        the caller must not use it from two threads at once. It does not
+        run WAL checkpoints.
+    */
+    explicit SqliteDatabase (char const* host, bool readOnly = false);
     ~SqliteDatabase ();
 
     void connect ();
@@ -96,6 +101,7 @@ private:
 
     JobQueue*               mWalQ;
     bool                    walRunning;
+    bool                    mReadOnly;
 };
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,138 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/data/DatabaseCon.h>
+#include <beast/unit_test/suite.h>
+#include <boost/filesystem.hpp>
+#include <type_traits>
+
+namespace ripple {
+
+class DatabaseCon_test : public beast::unit_test::suite
+{
+public:
+    static
+    int
+    count (Database* db)
+    {
+        int result = -1;
+        if (db->executeSQL ("SELECT COUNT(*) FROM Items;") &&
+            db->startIterRows ())
+        {
+            result = db->getInt (0);
+            db->endIterRows ();
+        }
+        return result;
+    }
+
+    void
+    testReaders (boost::filesystem::path const& dir)
+    {
+        testcase ("readers");
+
+        const char* init[] =
+        {
+            "PRAGMA journal_mode=WAL;",
+            "CREATE TABLE IF NOT EXISTS Items (Value INTEGER);"
+        };
+
+        DatabaseCon::Setup setup;
+        setup.dataDir = dir;
+        setup.readers = 2;
+        DatabaseCon con (setup, "wal.db", init, std::extent<decltype(init)>::value);
+
+        expect (con.readers () == 2);
+        expect (con.getDB ()->executeSQL ("INSERT INTO Items VALUES (1);"));
+
+        {
+            auto first (con.read ("count"));
+            auto second (con.read ("count"));
+            expect (first.getDB () != con.getDB ());
+            expect (second.getDB () != con.getDB ());
+            expect (first.getDB () != second.getDB ());
+            expect (count (first.getDB ()) == 1);
+        }
+
+        {
+            // A reader neither waits on nor sees an open write
+            auto sl (con.lock ());
+            expect (con.getDB ()->executeSQL ("BEGIN TRANSACTION;"));
+            expect (con.getDB ()->executeSQL ("INSERT INTO Items VALUES (2);"));
+            expect (count (con.read ("count").getDB ()) == 1);
+            expect (con.getDB ()->executeSQL ("COMMIT TRANSACTION;"));
+        }
+
+        expect (count (con.read ("count").getDB ()) == 2);
+    }
+
+    void
+    testFallback (boost::filesystem::path const& dir)
+    {
+        testcase ("fallback");
+
+        const char* init[] =
+        {
+            "PRAGMA journal_mode=DELETE;",
+            "CREATE TABLE IF NOT EXISTS Items (Value INTEGER);"
+        };
+
+        {
+            // Without WAL, queries share the write connection
+            DatabaseCon::Setup setup;
+            setup.dataDir = dir;
+            setup.readers = 2;
+            DatabaseCon con (setup, "rollback.db", init,
+                std::extent<decltype(init)>::value);
+
+            expect (con.readers () == 0);
+            expect (con.read ("count").getDB () == con.getDB ());
+        }
+
+        {
+            // Temporary databases cannot be shared
+            DatabaseCon::Setup setup;
+            setup.standAlone = true;
+            setup.readers = 2;
+            DatabaseCon con (setup, "temp.db", init,
+                std::extent<decltype(init)>::value);
+
+            expect (con.readers () == 0);
+            expect (con.getDB ()->executeSQL ("INSERT INTO Items VALUES (1);"));
+            expect (count (con.read ("count").getDB ()) == 1);
+        }
+    }
+
+    void
+    run () override
+    {
+        auto const dir = boost::filesystem::temp_directory_path () /
+            boost::filesystem::unique_path ();
+        boost::filesystem::create_directories (dir);
+
+        testReaders (dir);
+        testFallback (dir);
+
+        boost::filesystem::remove_all (dir);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(DatabaseCon,app,ripple);
+
+} // ripple
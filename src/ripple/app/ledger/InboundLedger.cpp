@@ -27,12 +27,14 @@
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/basics/Log.h>
+#include <ripple/core/Config.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/overlay/Overlay.h>
 #include <ripple/resource/Fees.h>
 #include <ripple/protocol/HashPrefix.h>
 #include <ripple/protocol/JsonFields.h>
 #include <ripple/nodestore/Database.h>
+#include <algorithm>
 
 namespace ripple {
 
@@ -46,6 +48,12 @@ enum
 
     // how many timeouts before we get aggressive
     ,ledgerBecomeAggressiveThreshold = 6
+
+    // most nodes to ask one peer for in one request
+    ,ledgerNodesPerRequest = 128
+
+    // most missing nodes to look for in one pass over a map
+    ,ledgerMissingNodesMax = 4096
 };
 
 InboundLedger::InboundLedger (uint256 const& hash, std::uint32_t seq, fcReason reason,
@@ -61,6 +69,8 @@ InboundLedger::InboundLedger (uint256 const& hash, std::uint32_t seq, fcReason r
     , mSeq (seq)
     , mReason (reason)
     , mReceiveDispatched (false)
+    , mWindow (getConfig ().LEDGER_REQUEST_WINDOW,
+        std::chrono::milliseconds (ledgerAcquireTimeoutMillis))
 {
 
     if (m_journal.trace) m_journal.trace <<
@@ -243,6 +253,9 @@ void InboundLedger::onTimer (bool wasProgress, ScopedLockType&)
         return;
     }
 
+    // Free the window slots of requests that were never answered
+    mWindow.expire (m_clock.now ());
+
     if (getTimeouts () > ledgerTimeoutRetriesMax)
     {
         if (mSeq != 0)
@@ -565,17 +578,24 @@ void InboundLedger::trigger (Peer::ptr const& peer)
         }
         else
         {
+            // Every peer already has a full window of requests
+            int const slots = requestSlots ();
+            if (slots == 0)
+                return;
+
+            int const maxNodes = std::min (
+                slots * ledgerNodesPerRequest, int (ledgerMissingNodesMax));
+
             std::vector<SHAMapNodeID> nodeIDs;
             std::vector<uint256> nodeHashes;
-            // VFALCO Why 256? Make this a constant
-            nodeIDs.reserve (256);
-            nodeHashes.reserve (256);
+            nodeIDs.reserve (std::max (256, maxNodes));
+            nodeHashes.reserve (std::max (256, maxNodes));
             AccountStateSF filter;
 
             // Release the lock while we process the large state map
             sl.unlock();
             mLedger->peekAccountStateMap ()->getMissingNodes (
-                nodeIDs, nodeHashes, 256, &filter);
+                nodeIDs, nodeHashes, std::max (256, maxNodes), &filter);
             sl.lock();
 
             // Make sure nothing happened while we released the lock
@@ -595,24 +615,19 @@ void InboundLedger::trigger (Peer::ptr const& peer)
                 }
                 else
                 {
-                    // VFALCO Why 128? Make this a constant
                     if (!mAggressive)
-                        filterNodes (nodeIDs, nodeHashes, 128, !isProgress ());
+                        filterNodes (nodeIDs, nodeHashes, maxNodes, !isProgress ());
 
                     if (!nodeIDs.empty ())
                     {
                         tmGL.set_itype (protocol::liAS_NODE);
-                        for (auto const& id : nodeIDs)
-                        {
-                            * (tmGL.add_nodeids ()) = id.getRawString ();
-                        }
                         if (m_journal.trace) m_journal.trace <<
                             "Sending AS node " << nodeIDs.size () <<
                                 " request to " << (
                                     peer ? "selected peer" : "all peers");
                         if (nodeIDs.size () == 1 && m_journal.trace) m_journal.trace <<
                             "AS node: " << nodeIDs[0];
-                        sendRequest (tmGL, peer);
+                        sendNodeRequests (tmGL, nodeIDs, peer);
                         return;
                     }
                     else
@@ -644,13 +659,20 @@ void InboundLedger::trigger (Peer::ptr const& peer)
         }
         else
         {
+            int const slots = requestSlots ();
+            if (slots == 0)
+                return;
+
+            int const maxNodes = std::min (
+                slots * ledgerNodesPerRequest, int (ledgerMissingNodesMax));
+
             std::vector<SHAMapNodeID> nodeIDs;
             std::vector<uint256> nodeHashes;
-            nodeIDs.reserve (256);
-            nodeHashes.reserve (256);
+            nodeIDs.reserve (std::max (256, maxNodes));
+            nodeHashes.reserve (std::max (256, maxNodes));
             TransactionStateSF filter;
             mLedger->peekTransactionMap ()->getMissingNodes (
-                nodeIDs, nodeHashes, 256, &filter);
+                nodeIDs, nodeHashes, std::max (256, maxNodes), &filter);
 
             if (nodeIDs.empty ())
             {
@@ -667,20 +689,16 @@ void InboundLedger::trigger (Peer::ptr const& peer)
             else
             {
                 if (!mAggressive)
-                    filterNodes (nodeIDs, nodeHashes, 128, !isProgress ());
+                    filterNodes (nodeIDs, nodeHashes, maxNodes, !isProgress ());
 
                 if (!nodeIDs.empty ())
                 {
                     tmGL.set_itype (protocol::liTX_NODE);
-                    for (auto const& id : nodeIDs)
-                    {
-                        * (tmGL.add_nodeids ()) = id.getRawString ();
-                    }
                     if (m_journal.trace) m_journal.trace <<
                         "Sending TX node " << nodeIDs.size () <<
                         " request to " << (
                             peer ? "selected peer" : "all peers");
-                    sendRequest (tmGL, peer);
+                    sendNodeRequests (tmGL, nodeIDs, peer);
                     return;
                 }
                 else
@@ -701,6 +719,60 @@ void InboundLedger::trigger (Peer::ptr const& peer)
     }
 }
 
+/** Returns the number of node requests that may be sent now
+    Call with a lock
+*/
+int InboundLedger::requestSlots () const
+{
+    // Without tracked peers we send one request at a time
+    if (mWindow.size () == 0)
+        return 1;
+
+    return static_cast<int> (mWindow.available ());
+}
+
+/** Ask for nodes, dividing them among the peers that have room in their
+    request window. Each peer gets a different range of the nodes.
+    Call with a lock
+*/
+void InboundLedger::sendNodeRequests (protocol::TMGetLedger& tmGL,
+    std::vector<SHAMapNodeID> const& nodeIDs, Peer::ptr const& peer)
+{
+    if (mWindow.size () == 0)
+    {
+        for (auto const& id : nodeIDs)
+            * (tmGL.add_nodeids ()) = id.getRawString ();
+        sendRequest (tmGL, peer);
+        return;
+    }
+
+    auto const requests = mWindow.assign (
+        nodeIDs, ledgerNodesPerRequest, m_clock.now ());
+
+    for (auto const& request : requests)
+    {
+        Peer::ptr target (
+            getApp().overlay ().findPeerByShortID (request.first));
+
+        if (!target)
+        {
+            mWindow.removePeer (request.first);
+            continue;
+        }
+
+        tmGL.clear_nodeids ();
+        for (auto const& id : request.second)
+            * (tmGL.add_nodeids ()) = id.getRawString ();
+
+        target->send (std::make_shared<Message> (
+            tmGL, protocol::mtGET_LEDGER));
+    }
+
+    if (m_journal.trace) m_journal.trace <<
+        "Sent " << requests.size () << " node requests, " <<
+            mWindow.outstanding () << " outstanding";
+}
+
 void InboundLedger::filterNodes (std::vector<SHAMapNodeID>& nodeIDs,
     std::vector<uint256>& nodeHashes, int max, bool aggressive)
 {
@@ -1126,6 +1198,7 @@ int InboundLedger::processData (std::shared_ptr<Peer> peer,
             if (m_journal.info) m_journal.info <<
                 "Got response with no nodes";
             peer->charge (Resource::feeInvalidRequest);
+            mWindow.onReply (peer->id (), 0, m_clock.now ());
             return -1;
         }
 
@@ -1138,6 +1211,7 @@ int InboundLedger::processData (std::shared_ptr<Peer> peer,
                 if (m_journal.warning) m_journal.warning <<
                     "Got bad node";
                 peer->charge (Resource::feeInvalidRequest);
+                mWindow.onReply (peer->id (), 0, m_clock.now ());
                 return -1;
             }
 
@@ -1162,6 +1236,8 @@ int InboundLedger::processData (std::shared_ptr<Peer> peer,
                 "Ledger AS node stats: " << ret.get();
         }
 
+        mWindow.onReply (peer->id (), ret.getGood (), m_clock.now ());
+
         if (!ret.isInvalid ())
             progress ();
         else
@@ -1249,6 +1325,12 @@ Json::Value InboundLedger::getJson (int)
 
     ret[jss::timeouts] = getTimeouts ();
 
+    ret[jss::nodes] = static_cast<Json::UInt> (mWindow.nodes ());
+    ret[jss::nodes_per_second] = mWindow.nodesPerSecond ();
+
+    if (!mComplete && !mFailed)
+        ret[jss::outstanding] = static_cast<Json::UInt> (mWindow.outstanding ());
+
     if (mHaveHeader && !mHaveState)
     {
         Json::Value hv (Json::arrayValue);
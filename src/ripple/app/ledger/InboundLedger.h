@@ -21,6 +21,7 @@
 #define RIPPLE_APP_LEDGER_INBOUNDLEDGER_H_INCLUDED
 
 #include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/ledger/LedgerRequestWindow.h>
 #include <ripple/app/peers/PeerSet.h>
 #include <ripple/basics/CountedObject.h>
 #include <set>
@@ -114,9 +115,14 @@ private:
 
     void newPeer (Peer::ptr const& peer)
     {
+        mWindow.addPeer (peer->id ());
         trigger (peer);
     }
 
+    int requestSlots () const;
+    void sendNodeRequests (protocol::TMGetLedger& tmGL,
+        std::vector<SHAMapNodeID> const& nodeIDs, Peer::ptr const& peer);
+
     std::weak_ptr <PeerSet> pmDowncast ();
 
     int processData (std::shared_ptr<Peer> peer, protocol::TMLedgerData& data);
@@ -152,6 +158,9 @@ private:
     std::vector <PeerDataPairType> mReceivedData;
     bool mReceiveDispatched;
 
+    // Outstanding node requests and observed peer performance
+    LedgerRequestWindow mWindow;
+
     std::vector <std::function <void (InboundLedger::pointer)> > mOnComplete;
 };
 
@@ -22,6 +22,7 @@
 #include <ripple/app/ledger/AcceptedLedger.h>
 #include <ripple/app/ledger/InboundLedgers.h>
 #include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/ledger/LedgerSQLWriter.h>
 #include <ripple/app/ledger/LedgerTiming.h>
 #include <ripple/app/ledger/LedgerToJson.h>
 #include <ripple/app/ledger/OrderBookDB.h>
@@ -36,6 +37,7 @@
 #include <ripple/basics/StringUtilities.h>
 #include <ripple/protocol/Indexes.h>
 #include <ripple/protocol/JsonFields.h>
+#include <ripple/protocol/TxFormats.h>
 #include <ripple/core/Config.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/core/LoadFeeTrack.h>
@@ -625,29 +627,9 @@ uint256 Ledger::getHash ()
 
 bool Ledger::saveValidatedLedger (bool current)
 {
-    // TODO(tom): Fix this hard-coded SQL!
     WriteLog (lsTRACE, Ledger)
         << "saveValidatedLedger "
         << (current ? "" : "fromAcquire ") << getLedgerSeq ();
-    static boost::format deleteLedger (
-        "DELETE FROM Ledgers WHERE LedgerSeq = %u;");
-    static boost::format deleteTrans1 (
-        "DELETE FROM Transactions WHERE LedgerSeq = %u;");
-    static boost::format deleteTrans2 (
-        "DELETE FROM AccountTransactions WHERE LedgerSeq = %u;");
-    static boost::format deleteAcctTrans (
-        "DELETE FROM AccountTransactions WHERE TransID = '%s';");
-    static boost::format transExists (
-        "SELECT Status FROM Transactions WHERE TransID = '%s';");
-    static boost::format updateTx (
-        "UPDATE Transactions SET LedgerSeq = %u, Status = '%c', TxnMeta = %s "
-        "WHERE TransID = '%s';");
-    static boost::format addLedger (
-        "INSERT OR REPLACE INTO Ledgers "
-        "(LedgerHash,LedgerSeq,PrevHash,TotalCoins,ClosingTime,PrevClosingTime,"
-        "CloseTimeRes,CloseFlags,AccountSetHash,TransSetHash) VALUES "
-        "('%s','%u','%s','%s','%u','%u','%d','%u','%s','%s');");
-
     if (!getAccountHash ().isNonZero ())
     {
         WriteLog (lsFATAL, Ledger) << "AH is zero: "
@@ -693,95 +675,61 @@ bool Ledger::saveValidatedLedger (bool current)
         return false;
     }
 
-    {
-        auto sl (getApp().getLedgerDB ().lock ());
-        getApp().getLedgerDB ().getDB ()->executeSQL (
-            boost::str (deleteLedger % mLedgerSeq));
-    }
+    auto& writer = getApp().getLedgerSQLWriter ();
 
-    {
-        auto db = getApp().getTxnDB ().getDB ();
-        auto dbLock (getApp().getTxnDB ().lock ());
-        db->executeSQL ("BEGIN TRANSACTION;");
-
-        db->executeSQL (boost::str (deleteTrans1 % getLedgerSeq ()));
-        db->executeSQL (boost::str (deleteTrans2 % getLedgerSeq ()));
+    writer.deleteLedger (mLedgerSeq);
 
-        std::string const ledgerSeq (std::to_string (getLedgerSeq ()));
+    {
+        std::vector <LedgerSQLWriter::Txn> txns;
+        txns.reserve (aLedger->getMap ().size ());
 
         for (auto const& vt : aLedger->getMap ())
         {
-            uint256 transactionID = vt.second->getTransactionID ();
+            uint256 const transactionID = vt.second->getTransactionID ();
 
             getApp().getMasterTransaction ().inLedger (
                 transactionID, getLedgerSeq ());
 
-            std::string const txnId (to_string (transactionID));
-            std::string const txnSeq (std::to_string (vt.second->getTxnSeq ()));
+            STTx const& stx = *vt.second->getTxn ();
+            auto const format =
+                TxFormats::getInstance ().findByType (stx.getTxnType ());
+            assert (format != nullptr);
 
-            db->executeSQL (boost::str (deleteAcctTrans % transactionID));
+            txns.emplace_back ();
+            LedgerSQLWriter::Txn& txn = txns.back ();
+            txn.id = transactionID;
+            txn.type = format->getName ();
+            txn.account = stx.getSourceAccount ().humanAccountID ();
+            txn.sequence = stx.getSequence ();
+            txn.txnSeq = vt.second->getTxnSeq ();
 
-            auto const& accts = vt.second->getAffected ();
-
-            if (!accts.empty ())
-            {
-                std::string sql ("INSERT INTO AccountTransactions "
-                                 "(TransID, Account, LedgerSeq, TxnSeq) VALUES ");
+            Serializer s;
+            stx.add (s);
+            txn.raw = std::move (s.modData ());
+            txn.meta = vt.second->getRawMeta ();
 
-                // Try to make an educated guess on how much space we'll need
-                // for our arguments. In argument order we have:
-                // 64 + 34 + 10 + 10 = 118 + 10 extra = 128 bytes
-                sql.reserve (sql.length () + (accts.size () * 128));
-
-                bool first = true;
-                for (auto const& it : accts)
-                {
-                    if (!first)
-                        sql += ", ('";
-                    else
-                    {
-                        sql += "('";
-                        first = false;
-                    }
-
-                    sql += txnId;
-                    sql += "','";
-                    sql += it.humanAccountID ();
-                    sql += "',";
-                    sql += ledgerSeq;
-                    sql += ",";
-                    sql += txnSeq;
-                    sql += ")";
-                }
-                sql += ";";
-                if (ShouldLog (lsTRACE, Ledger))
-                {
-                    WriteLog (lsTRACE, Ledger) << "ActTx: " << sql;
-                }
-                db->executeSQL (sql);
-            }
-            else
-                WriteLog (lsWARNING, Ledger)
-                    << "Transaction in ledger " << mLedgerSeq
-                    << " affects no accounts";
-
-            db->executeSQL (
-                STTx::getMetaSQLInsertReplaceHeader () +
-                vt.second->getTxn ()->getMetaSQL (
-                    getLedgerSeq (), vt.second->getEscMeta ()) + ";");
+            auto const& accts = vt.second->getAffected ();
+            txn.affected.reserve (accts.size ());
+            for (auto const& it : accts)
+                txn.affected.push_back (it.humanAccountID ());
         }
-        db->executeSQL ("COMMIT TRANSACTION;");
+
+        writer.saveTransactions (getLedgerSeq (), txns);
     }
 
     {
-        auto sl (getApp().getLedgerDB ().lock ());
-
-        // TODO(tom): ARG!
-        getApp().getLedgerDB ().getDB ()->executeSQL (boost::str (addLedger %
-                to_string (getHash ()) % mLedgerSeq % to_string (mParentHash) %
-                beast::lexicalCastThrow <std::string> (mTotCoins) % mCloseTime %
-                mParentCloseTime % mCloseResolution % mCloseFlags %
-                to_string (mAccountHash) % to_string (mTransHash)));
+        LedgerSQLWriter::Header header;
+        header.hash = getHash ();
+        header.seq = mLedgerSeq;
+        header.parentHash = mParentHash;
+        header.totalCoins = mTotCoins;
+        header.closeTime = mCloseTime;
+        header.parentCloseTime = mParentCloseTime;
+        header.closeResolution = mCloseResolution;
+        header.closeFlags = mCloseFlags;
+        header.accountHash = mAccountHash;
+        header.transHash = mTransHash;
+        writer.saveLedger (header);
     }
 
     {
@@ -1346,21 +1294,17 @@ bool Ledger::visitAccountItems (
     }
 }
 
-static void visitHelper (
-    std::function<void (SLE::ref)>& function, std::shared_ptr<SHAMapItem> const& item)
-{
-    function (std::make_shared<SLE> (item->peekSerializer (), item->getTag ()));
-}
-
 void Ledger::visitStateItems (std::function<void (SLE::ref)> function) const
 {
     try
     {
         if (mAccountStateMap)
         {
-            mAccountStateMap->visitLeaves(
-                std::bind(&visitHelper, std::ref(function),
-                          std::placeholders::_1));
+            for (auto const& item : *mAccountStateMap)
+            {
+                function (std::make_shared<SLE> (
+                    item->peekSerializer (), item->getTag ()));
+            }
         }
     }
     catch (SHAMapMissingNode&)
@@ -53,7 +53,7 @@ void LedgerEntrySet::clear ()
 
 LedgerEntrySet LedgerEntrySet::duplicate () const
 {
-    return LedgerEntrySet (mLedger, mEntries, mSet, mSeq + 1);
+    return LedgerEntrySet (mLedger, mEntries, mSet, mSeq + 1, mReads);
 }
 
 void LedgerEntrySet::swapWith (LedgerEntrySet& e)
@@ -63,6 +63,30 @@ void LedgerEntrySet::swapWith (LedgerEntrySet& e)
     mSet.swap (e.mSet);
     std::swap (mParams, e.mParams);
     std::swap (mSeq, e.mSeq);
+    std::swap (mReads, e.mReads);
+}
+
+bool LedgerReadSet::intersects (std::set<uint256> const& written) const
+{
+    if (written.empty ())
+        return false;
+
+    for (auto const& index : mEntries)
+    {
+        if (written.count (index))
+            return true;
+    }
+
+    for (auto const& range : mRanges)
+    {
+        auto const it = written.upper_bound (range.first);
+
+        if ((it != written.end ()) &&
+                (range.second.isZero () || (*it <= range.second)))
+            return true;
+    }
+
+    return false;
 }
 
 // Find an entry in the set.  If it has the wrong sequence number, copy it and update the sequence number.
@@ -111,6 +135,9 @@ SLE::pointer LedgerEntrySet::entryCache (LedgerEntryType letType, uint256 const&
             assert (action != taaDELETE);
             sleEntry = mImmutable ? mLedger->getSLEi (index) : mLedger->getSLE (index);
 
+            if (mReads)
+                mReads->addEntry (index);
+
             if (sleEntry)
                 entryCache (sleEntry);
         }
@@ -999,6 +1026,9 @@ uint256 LedgerEntrySet::getNextLedgerIndex (uint256 const& uHash)
     }
     while ((it != mEntries.end ()) && (it->second.mAction == taaDELETE));
 
+    if (mReads)
+        mReads->addRange (uHash, ledgerNext);
+
     // find next node in LES that isn't deleted
     for (it = mEntries.upper_bound (uHash); it != mEntries.end (); ++it)
     {
@@ -23,6 +23,10 @@
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/basics/CountedObject.h>
 #include <ripple/protocol/STLedgerEntry.h>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
 
 namespace ripple {
 
@@ -81,6 +85,37 @@ public:
     }
 };
 
+/** The ledger state a transaction depended on.
+
+    When a transaction is applied speculatively against a snapshot, its
+    LedgerEntrySet records here every entry it read from the ledger,
+    including entries it looked for and did not find, and every key range
+    it scanned. The result is still valid for the real ledger if no entry
+    in the set was written since the snapshot was taken.
+*/
+class LedgerReadSet
+{
+public:
+    void addEntry (uint256 const& index)
+    {
+        mEntries.push_back (index);
+    }
+
+    // Keys after `after` up to and including `last`, or to the end of
+    // the ledger if `last` is zero.
+    void addRange (uint256 const& after, uint256 const& last)
+    {
+        mRanges.emplace_back (after, last);
+    }
+
+    /** Returns `true` if any of the written keys was read. */
+    bool intersects (std::set<uint256> const& written) const;
+
+private:
+    std::vector<uint256> mEntries;
+    std::vector<std::pair<uint256, uint256>> mRanges;
+};
+
 /** An LES is a LedgerEntrySet.
 
     It's a view into a ledger used while a transaction is processing.
@@ -146,6 +181,20 @@ public:
         return mLedger;
     }
 
+    void setLedger (Ledger::ref ledger)
+    {
+        mLedger = ledger;
+    }
+
+    /** Record the ledger state read through this set and its duplicates.
+
+        Pass null to stop recording.
+    */
+    void setReadSet (std::shared_ptr<LedgerReadSet> const& reads)
+    {
+        mReads = reads;
+    }
+
     bool enforceFreeze () const
     {
         return mLedger->enforceFreeze ();
@@ -302,12 +351,14 @@ private:
     TransactionEngineParams mParams;
     int mSeq;
     bool mImmutable;
+    std::shared_ptr<LedgerReadSet> mReads;
 
     LedgerEntrySet (
         Ledger::ref ledger, const std::map<uint256, LedgerEntrySetEntry>& e,
-        const TransactionMetaSet & s, int m) :
+        const TransactionMetaSet & s, int m,
+        std::shared_ptr<LedgerReadSet> const& reads) :
         mLedger (ledger), mEntries (e), mSet (s), mParams (tapNONE), mSeq (m),
-        mImmutable (false)
+        mImmutable (false), mReads (reads)
     {}
 
     SLE::pointer getForMod (
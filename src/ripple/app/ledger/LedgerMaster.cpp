@@ -399,6 +399,54 @@ public:
         return result;
     }
 
+    void doTransactions (std::vector <OpenTransaction>& txns)
+    {
+        Ledger::pointer ledger;
+        TransactionEngine engine;
+        bool anyApplied = false;
+
+        {
+            ScopedLockType sl (m_mutex);
+            ledger = mCurrentLedger.getMutable ();
+            engine.setLedger (ledger);
+
+            for (auto& tx : txns)
+            {
+                tx.didApply = false;
+
+                // A transaction that throws fails on its own, without
+                // losing the ones already applied to the snapshot
+                try
+                {
+                    tx.result = engine.applyTransaction (
+                        *tx.txn, tx.params, tx.didApply);
+                }
+                catch (...)
+                {
+                    WriteLog (lsWARNING, LedgerMaster) <<
+                        "Exception applying transaction " <<
+                        tx.txn->getTransactionID ();
+                    tx.result = tefEXCEPTION;
+                    tx.didApply = false;
+                }
+
+                anyApplied = anyApplied || tx.didApply;
+            }
+        }
+
+        if (anyApplied)
+        {
+            mCurrentLedger.set (ledger);
+
+            for (auto const& tx : txns)
+            {
+                if (tx.didApply)
+                    getApp().getOPs ().pubProposedTransaction (
+                        ledger, tx.txn, tx.result);
+            }
+        }
+    }
+
     bool haveLedgerRange (std::uint32_t from, std::uint32_t to)
     {
         ScopedLockType sl (mCompleteLock);
@@ -1052,7 +1100,8 @@ public:
                         WriteLog(lsDEBUG, LedgerMaster) <<
                             "tryAdvance publishing seq " << ledger->getLedgerSeq();
 
-                        setFullLedger(ledger, true, true);
+                        setFullLedger(ledger,
+                            ! getConfig ().ASYNC_LEDGER_SAVE, true);
                         getApp().getOPs().pubLedger(ledger);
                     }
 
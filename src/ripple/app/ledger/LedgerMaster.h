@@ -28,6 +28,7 @@
 #include <beast/threads/Stoppable.h>
 #include <beast/threads/UnlockGuard.h>
 #include <beast/utility/PropertyStream.h>
+#include <vector>
 
 namespace ripple {
 
@@ -79,6 +80,22 @@ public:
         STTx::ref txn,
             TransactionEngineParams params, bool& didApply) = 0;
 
+    /** A transaction to apply to the open ledger, and its outcome. */
+    struct OpenTransaction
+    {
+        STTx::pointer txn;
+        TransactionEngineParams params;
+        TER result;
+        bool didApply;
+    };
+
+    /** Apply transactions to the open ledger, in order.
+        The open ledger is snapshotted and replaced once for the whole
+        batch, rather than once per transaction. A transaction that throws
+        gets tefEXCEPTION and the rest of the batch is still applied.
+    */
+    virtual void doTransactions (std::vector <OpenTransaction>& txns) = 0;
+
     virtual int getMinValidations () = 0;
 
     virtual void setMinValidations (int v) = 0;
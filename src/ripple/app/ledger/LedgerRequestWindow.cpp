@@ -0,0 +1,231 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/LedgerRequestWindow.h>
+#include <algorithm>
+
+namespace ripple {
+
+LedgerRequestWindow::LedgerRequestWindow (
+        std::size_t window, clock_type::duration timeout)
+    : window_ (std::max <std::size_t> (window, 1))
+    , timeout_ (timeout)
+{
+}
+
+void LedgerRequestWindow::addPeer (PeerID id)
+{
+    peers_.emplace (id, PeerState ());
+}
+
+void LedgerRequestWindow::removePeer (PeerID id)
+{
+    peers_.erase (id);
+}
+
+std::size_t LedgerRequestWindow::available () const
+{
+    std::size_t ret = 0;
+
+    for (auto const& peer : peers_)
+        ret += window_ - peer.second.sent.size ();
+
+    return ret;
+}
+
+std::size_t LedgerRequestWindow::outstanding () const
+{
+    std::size_t ret = 0;
+
+    for (auto const& peer : peers_)
+        ret += peer.second.sent.size ();
+
+    return ret;
+}
+
+bool LedgerRequestWindow::better (PeerState const& lhs, PeerState const& rhs)
+{
+    // Peers we have not measured yet go first
+    if ((lhs.replies == 0) != (rhs.replies == 0))
+        return lhs.replies == 0;
+
+    if (lhs.throughput != rhs.throughput)
+        return lhs.throughput > rhs.throughput;
+
+    return lhs.latency < rhs.latency;
+}
+
+std::vector <LedgerRequestWindow::PeerID> LedgerRequestWindow::ranking () const
+{
+    std::vector <std::pair <PeerID, PeerState const*>> peers;
+    peers.reserve (peers_.size ());
+
+    for (auto const& peer : peers_)
+        peers.emplace_back (peer.first, &peer.second);
+
+    std::stable_sort (peers.begin (), peers.end (),
+        [](std::pair <PeerID, PeerState const*> const& lhs,
+           std::pair <PeerID, PeerState const*> const& rhs)
+        {
+            return better (*lhs.second, *rhs.second);
+        });
+
+    std::vector <PeerID> ret;
+    ret.reserve (peers.size ());
+
+    for (auto const& peer : peers)
+        ret.push_back (peer.first);
+
+    return ret;
+}
+
+std::vector <LedgerRequestWindow::Request>
+LedgerRequestWindow::assign (std::vector <SHAMapNodeID> nodes,
+    std::size_t maxPerRequest, time_point now)
+{
+    std::vector <Request> ret;
+
+    if (nodes.empty () || (maxPerRequest == 0))
+        return ret;
+
+    // Take each peer's first free slot in rank order, then each
+    // peer's second, and so on, so work is spread across peers
+    // before any one peer's window fills.
+    auto const order = ranking ();
+    std::vector <PeerID> slots;
+
+    for (std::size_t round = 0; round < window_; ++round)
+    {
+        for (auto const id : order)
+        {
+            if ((peers_[id].sent.size () + round) < window_)
+                slots.push_back (id);
+        }
+    }
+
+    if (slots.empty ())
+        return ret;
+
+    // Nodes that are adjacent in key order share a subtree, so cutting
+    // the sorted list into ranges keeps each request's nodes together.
+    std::sort (nodes.begin (), nodes.end (),
+        [](SHAMapNodeID const& lhs, SHAMapNodeID const& rhs)
+        {
+            if (lhs.getNodeID () != rhs.getNodeID ())
+                return lhs.getNodeID () < rhs.getNodeID ();
+            return lhs.getDepth () < rhs.getDepth ();
+        });
+
+    std::size_t const count = std::min (
+        nodes.size (), slots.size () * maxPerRequest);
+    std::size_t const requests = std::min (slots.size (), count);
+
+    ret.reserve (requests);
+    auto first = nodes.begin ();
+
+    for (std::size_t i = 0; i < requests; ++i)
+    {
+        std::size_t const n =
+            (count / requests) + ((i < (count % requests)) ? 1 : 0);
+
+        ret.emplace_back (slots[i],
+            std::vector <SHAMapNodeID> (first, first + n));
+        first += n;
+
+        peers_[slots[i]].sent.push_back (now);
+    }
+
+    if (!started_)
+    {
+        started_ = true;
+        start_ = now;
+        last_ = now;
+    }
+
+    return ret;
+}
+
+void LedgerRequestWindow::onReply (
+    PeerID id, std::size_t nodes, time_point now)
+{
+    nodes_ += nodes;
+
+    if (started_ && (nodes != 0))
+        last_ = std::max (last_, now);
+
+    auto const iter = peers_.find (id);
+
+    // Replies to requests sent to every peer are not tracked
+    if ((iter == peers_.end ()) || iter->second.sent.empty ())
+        return;
+
+    PeerState& peer = iter->second;
+
+    double const elapsed = std::max (0.001,
+        std::chrono::duration <double> (now - peer.sent.front ()).count ());
+    double const rate = nodes / elapsed;
+    peer.sent.pop_front ();
+
+    if (peer.replies++ == 0)
+    {
+        peer.latency = elapsed;
+        peer.throughput = rate;
+    }
+    else
+    {
+        peer.latency += (elapsed - peer.latency) / 4;
+        peer.throughput += (rate - peer.throughput) / 4;
+    }
+}
+
+void LedgerRequestWindow::expire (time_point now)
+{
+    double const timeout =
+        std::chrono::duration <double> (timeout_).count ();
+
+    for (auto& entry : peers_)
+    {
+        PeerState& peer = entry.second;
+
+        while (!peer.sent.empty () && ((now - peer.sent.front ()) > timeout_))
+        {
+            peer.sent.pop_front ();
+
+            // Count the timeout as a slow reply with nothing in it
+            ++peer.replies;
+            peer.latency = std::max (peer.latency, timeout);
+            peer.throughput /= 2;
+        }
+    }
+}
+
+double LedgerRequestWindow::nodesPerSecond () const
+{
+    if (!started_)
+        return 0;
+
+    double const elapsed =
+        std::chrono::duration <double> (last_ - start_).count ();
+
+    return (elapsed > 0) ? (nodes_ / elapsed) : 0;
+}
+
+} // ripple
@@ -0,0 +1,128 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_APP_LEDGER_LEDGERREQUESTWINDOW_H_INCLUDED
+#define RIPPLE_APP_LEDGER_LEDGERREQUESTWINDOW_H_INCLUDED
+
+#include <ripple/overlay/Peer.h>
+#include <ripple/shamap/SHAMapNodeID.h>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace ripple {
+
+/** Schedules the node requests for a ledger acquired from several peers.
+
+    Each peer may have up to a fixed number of requests outstanding, so
+    a peer is given more work before its earlier replies arrive. The
+    missing nodes are sorted by key and cut into contiguous ranges, one
+    per request, so each peer works on a different part of the tree.
+
+    Peers are ranked by the throughput and latency seen in their replies
+    and the best peers are offered work first. A peer that has not
+    replied yet ranks first, so that every peer gets measured.
+
+    This class does no locking and sends nothing; InboundLedger calls it
+    while holding its lock and sends the requests it returns.
+*/
+class LedgerRequestWindow
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+    using time_point = clock_type::time_point;
+    using PeerID = Peer::id_t;
+
+    /** A request to send: the peer and the nodes to ask it for. */
+    using Request = std::pair <PeerID, std::vector <SHAMapNodeID>>;
+
+    LedgerRequestWindow (std::size_t window, clock_type::duration timeout);
+
+    /** Add a peer to the set we request from. */
+    void addPeer (PeerID id);
+
+    /** Remove a peer, forgetting its outstanding requests. */
+    void removePeer (PeerID id);
+
+    /** Returns the number of peers. */
+    std::size_t size () const
+    {
+        return peers_.size ();
+    }
+
+    /** Returns the number of requests that may still be sent. */
+    std::size_t available () const;
+
+    /** Returns the number of requests awaiting a reply. */
+    std::size_t outstanding () const;
+
+    /** Divide nodes among the peers with room in their window.
+        At most maxPerRequest nodes go in one request. Nodes that do not
+        fit are left for a later call. The requests are recorded as
+        sent at time now.
+    */
+    std::vector <Request> assign (std::vector <SHAMapNodeID> nodes,
+        std::size_t maxPerRequest, time_point now);
+
+    /** Record a reply from a peer that carried the given useful nodes. */
+    void onReply (PeerID id, std::size_t nodes, time_point now);
+
+    /** Forget requests that have waited longer than the timeout. */
+    void expire (time_point now);
+
+    /** Returns the useful nodes received so far. */
+    std::size_t nodes () const
+    {
+        return nodes_;
+    }
+
+    /** Returns the useful nodes received per second, from the first
+        request sent to the last reply received.
+    */
+    double nodesPerSecond () const;
+
+    /** Returns the peers in the order work is offered to them. */
+    std::vector <PeerID> ranking () const;
+
+private:
+    struct PeerState
+    {
+        std::deque <time_point> sent;   // outstanding requests, oldest first
+        double latency = 0;             // seconds, moving average
+        double throughput = 0;          // nodes per second, moving average
+        std::size_t replies = 0;
+    };
+
+    static bool better (PeerState const& lhs, PeerState const& rhs);
+
+    std::size_t window_;
+    clock_type::duration timeout_;
+    std::map <PeerID, PeerState> peers_;
+    std::size_t nodes_ = 0;
+    time_point start_;
+    time_point last_;
+    bool started_ = false;
+};
+
+} // ripple
+
+#endif
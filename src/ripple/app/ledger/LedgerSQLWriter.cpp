@@ -0,0 +1,153 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/LedgerSQLWriter.h>
+#include <ripple/basics/Log.h>
+#include <ripple/protocol/STTx.h>
+
+namespace ripple {
+
+LedgerSQLWriter::LedgerSQLWriter (DatabaseCon& ledgerDB, DatabaseCon& txnDB)
+    : m_ledgerDB (ledgerDB)
+    , m_txnDB (txnDB)
+    , m_deleteLedger (ledgerDB.getDB ()->getSqliteDB (),
+        "DELETE FROM Ledgers WHERE LedgerSeq = ?;")
+    , m_addLedger (ledgerDB.getDB ()->getSqliteDB (),
+        "INSERT OR REPLACE INTO Ledgers "
+        "(LedgerHash,LedgerSeq,PrevHash,TotalCoins,ClosingTime,PrevClosingTime,"
+        "CloseTimeRes,CloseFlags,AccountSetHash,TransSetHash) VALUES "
+        "(?,?,?,?,?,?,?,?,?,?);")
+    , m_begin (txnDB.getDB ()->getSqliteDB (),
+        "BEGIN TRANSACTION;")
+    , m_commit (txnDB.getDB ()->getSqliteDB (),
+        "COMMIT TRANSACTION;")
+    , m_deleteTrans (txnDB.getDB ()->getSqliteDB (),
+        "DELETE FROM Transactions WHERE LedgerSeq = ?;")
+    , m_deleteAcctTransBySeq (txnDB.getDB ()->getSqliteDB (),
+        "DELETE FROM AccountTransactions WHERE LedgerSeq = ?;")
+    , m_deleteAcctTransById (txnDB.getDB ()->getSqliteDB (),
+        "DELETE FROM AccountTransactions WHERE TransID = ?;")
+    , m_addAcctTrans (txnDB.getDB ()->getSqliteDB (),
+        "INSERT INTO AccountTransactions "
+        "(TransID, Account, LedgerSeq, TxnSeq) VALUES (?,?,?,?);")
+    , m_addTrans (txnDB.getDB ()->getSqliteDB (),
+        "INSERT OR REPLACE INTO Transactions "
+        "(TransID, TransType, FromAcct, FromSeq, LedgerSeq, Status, RawTxn, TxnMeta)"
+        " VALUES (?,?,?,?,?,?,?,?);")
+{
+}
+
+void LedgerSQLWriter::deleteLedger (std::uint32_t seq)
+{
+    auto sl (m_ledgerDB.lock ());
+
+    m_deleteLedger.bind (1, seq);
+    step (m_deleteLedger);
+}
+
+void LedgerSQLWriter::saveLedger (Header const& header)
+{
+    auto sl (m_ledgerDB.lock ());
+
+    m_addLedger.bind (1, to_string (header.hash));
+    m_addLedger.bind (2, header.seq);
+    m_addLedger.bind (3, to_string (header.parentHash));
+    m_addLedger.bind (4, std::to_string (header.totalCoins));
+    m_addLedger.bind (5, header.closeTime);
+    m_addLedger.bind (6, header.parentCloseTime);
+    m_addLedger.bind (7, static_cast <std::uint32_t> (header.closeResolution));
+    m_addLedger.bind (8, header.closeFlags);
+    m_addLedger.bind (9, to_string (header.accountHash));
+    m_addLedger.bind (10, to_string (header.transHash));
+    step (m_addLedger);
+}
+
+std::size_t LedgerSQLWriter::saveTransactions (std::uint32_t seq,
+    std::vector <Txn> const& txns)
+{
+    std::size_t rows = 0;
+    std::string const status (1, TXN_SQL_VALIDATED);
+
+    auto sl (m_txnDB.lock ());
+
+    step (m_begin);
+
+    m_deleteTrans.bind (1, seq);
+    step (m_deleteTrans);
+    m_deleteAcctTransBySeq.bind (1, seq);
+    step (m_deleteAcctTransBySeq);
+
+    for (auto const& txn : txns)
+    {
+        std::string const id (to_string (txn.id));
+
+        m_deleteAcctTransById.bind (1, id);
+        step (m_deleteAcctTransById);
+
+        if (txn.affected.empty ())
+        {
+            WriteLog (lsWARNING, Ledger)
+                << "Transaction in ledger " << seq
+                << " affects no accounts";
+        }
+
+        // The id, sequence and position are the same for every account
+        m_addAcctTrans.bindStatic (1, id);
+        m_addAcctTrans.bind (3, seq);
+        m_addAcctTrans.bind (4, txn.txnSeq);
+        for (auto const& account : txn.affected)
+        {
+            m_addAcctTrans.bindStatic (2, account);
+            step (m_addAcctTrans);
+            ++rows;
+        }
+
+        m_addTrans.bindStatic (1, id);
+        m_addTrans.bindStatic (2, txn.type);
+        m_addTrans.bindStatic (3, txn.account);
+        m_addTrans.bind (4, txn.sequence);
+        m_addTrans.bind (5, seq);
+        m_addTrans.bindStatic (6, status);
+        m_addTrans.bindStatic (7, txn.raw.data (), txn.raw.size ());
+        m_addTrans.bindStatic (8, txn.meta.data (), txn.meta.size ());
+        step (m_addTrans);
+        ++rows;
+    }
+
+    step (m_commit);
+
+    return rows;
+}
+
+// Runs a statement which returns no rows, then readies it for reuse.
+void LedgerSQLWriter::step (SqliteStatement& statement)
+{
+    int const result = statement.step ();
+
+    if (! statement.isDone (result))
+    {
+        WriteLog (lsWARNING, Ledger)
+            << "SQL step failed: " << statement.getError (result);
+    }
+
+    statement.reset ();
+}
+
+} // ripple
@@ -0,0 +1,111 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_LEDGER_LEDGERSQLWRITER_H_INCLUDED
+#define RIPPLE_APP_LEDGER_LEDGERSQLWRITER_H_INCLUDED
+
+#include <ripple/app/data/DatabaseCon.h>
+#include <ripple/app/data/SqliteDatabase.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/basics/Blob.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+/** Writes the SQL rows describing a validated ledger.
+
+    The statements are prepared once and reused for every ledger, with
+    all values passed as bound parameters. Each method acquires the lock
+    of the database it writes to.
+*/
+class LedgerSQLWriter
+{
+public:
+    /** The row stored in the Ledgers table. */
+    struct Header
+    {
+        uint256 hash;
+        std::uint32_t seq;
+        uint256 parentHash;
+        std::uint64_t totalCoins;
+        std::uint32_t closeTime;
+        std::uint32_t parentCloseTime;
+        int closeResolution;
+        std::uint32_t closeFlags;
+        uint256 accountHash;
+        uint256 transHash;
+    };
+
+    /** The rows stored for one transaction in a validated ledger. */
+    struct Txn
+    {
+        uint256 id;
+        std::string type;           // The transaction format name
+        std::string account;        // The source account, in base58
+        std::uint32_t sequence;     // The source account sequence
+        std::uint32_t txnSeq;       // The position within the ledger
+        Blob raw;
+        Blob meta;
+        std::vector <std::string> affected; // Affected accounts, in base58
+    };
+
+    LedgerSQLWriter (DatabaseCon& ledgerDB, DatabaseCon& txnDB);
+
+    LedgerSQLWriter (LedgerSQLWriter const&) = delete;
+    LedgerSQLWriter& operator= (LedgerSQLWriter const&) = delete;
+
+    /** Remove the Ledgers row for a sequence. */
+    void deleteLedger (std::uint32_t seq);
+
+    /** Insert or replace the Ledgers row. */
+    void saveLedger (Header const& header);
+
+    /** Replace the transaction rows for a ledger.
+
+        The existing rows for the ledger are removed and the new rows are
+        written in a single SQL transaction.
+
+        @return The number of rows inserted.
+    */
+    std::size_t saveTransactions (std::uint32_t seq,
+        std::vector <Txn> const& txns);
+
+private:
+    void step (SqliteStatement& statement);
+
+    DatabaseCon& m_ledgerDB;
+    DatabaseCon& m_txnDB;
+
+    SqliteStatement m_deleteLedger;
+    SqliteStatement m_addLedger;
+
+    SqliteStatement m_begin;
+    SqliteStatement m_commit;
+    SqliteStatement m_deleteTrans;
+    SqliteStatement m_deleteAcctTransBySeq;
+    SqliteStatement m_deleteAcctTransById;
+    SqliteStatement m_addAcctTrans;
+    SqliteStatement m_addTrans;
+};
+
+} // ripple
+
+#endif
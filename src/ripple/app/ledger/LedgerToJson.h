@@ -133,7 +133,8 @@ void fillJson (Object& json, LedgerFill const& fill)
                 {
                     SerialIter sit (item->peekSerializer ());
                     STTx txn (sit);
-                    txns.append (txn.getJson (0));
+                    auto&& txJson = Json::appendObject (txns);
+                    writeJson (txJson, txn, 0);
                 }
                 else if (type == SHAMapTreeNode::tnTRANSACTION_MD)
                 {
@@ -145,9 +146,10 @@ void fillJson (Object& json, LedgerFill const& fill)
 
                     TransactionMetaSet meta (
                         item->getTag (), ledger.getLedgerSeq(), sit.getVL ());
-                    Json::Value txJson = txn.getJson (0);
-                    txJson[jss::metaData] = meta.getJson (0);
-                    txns.append (txJson);
+                    auto&& txJson = Json::appendObject (txns);
+                    writeJson (txJson, txn, 0);
+                    auto&& metaJson = Json::addObject (txJson, jss::metaData);
+                    writeJson (metaJson, meta.getAsObject (), 0);
                 }
                 else
                 {
@@ -172,7 +174,8 @@ void fillJson (Object& json, LedgerFill const& fill)
                 [&array, &count] (SLE::ref sle)
                 {
                     count.yield();
-                    array.append (sle->getJson(0));
+                    auto&& entry = Json::appendObject (array);
+                    writeJson (entry, *sle, 0);
                 });
         }
         else
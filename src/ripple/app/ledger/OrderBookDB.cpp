@@ -31,6 +31,7 @@ namespace ripple {
 OrderBookDB::OrderBookDB (Stoppable& parent)
     : Stoppable ("OrderBookDB", parent)
     , mSeq (0)
+    , mRebuilding (false)
 {
 }
 
@@ -38,31 +39,70 @@ void OrderBookDB::invalidate ()
 {
     ScopedLockType sl (mLock);
     mSeq = 0;
+    mRebuilding = false;
+    mPending.clear ();
+}
+
+// Apply the book directories each transaction created or deleted, then
+// drop the books added ahead of validation that the ledger did not create
+static void applyLedgerMeta (OrderBookIndex& books, AcceptedLedger const& ledger)
+{
+    for (auto const& item : ledger.getMap ())
+    {
+        if (auto const& meta = item.second->getMeta ())
+            books.applyMeta (*meta);
+    }
+    books.removeUncounted ();
 }
 
 void OrderBookDB::setup (Ledger::ref ledger)
 {
+    // An open ledger holds its parent's state plus whatever has been
+    // applied to it, so it matches no sequence that will be published.
+    if (! ledger->isClosed ())
+    {
+        WriteLog (lsWARNING, OrderBookDB)
+            << "Not rebuilding from open ledger " << ledger->getLedgerSeq ();
+        return;
+    }
+
     {
         ScopedLockType sl (mLock);
         auto seq = ledger->getLedgerSeq ();
 
-        // Do a full update every 256 ledgers
+        // Published ledgers keep the books current, so only rebuild
+        // when we have none or the ledger is not the next one.
         if (mSeq != 0)
         {
-            if (seq == mSeq)
-                return;
-            if ((seq > mSeq) && ((seq - mSeq) < 256))
+            if ((seq == mSeq) || (seq == (mSeq + 1)))
                 return;
             if ((seq < mSeq) && ((mSeq - seq) < 16))
                 return;
         }
+    }
+
+    rebuild (ledger);
+}
+
+void OrderBookDB::rebuild (Ledger::ref ledger)
+{
+    {
+        ScopedLockType sl (mLock);
+        auto seq = ledger->getLedgerSeq ();
 
         WriteLog (lsDEBUG, OrderBookDB)
-            << "Advancing from " << mSeq << " to " << seq;
+            << "Rebuilding from " << mSeq << " to " << seq;
 
         mSeq = seq;
+        mRebuilding = true;
+        mPending.clear ();
     }
 
+    scheduleUpdate (ledger);
+}
+
+void OrderBookDB::scheduleUpdate (Ledger::ref ledger)
+{
     if (getConfig().RUN_STANDALONE)
         update(ledger);
     else
@@ -70,128 +110,121 @@ void OrderBookDB::setup (Ledger::ref ledger)
             std::bind(&OrderBookDB::update, this, ledger));
 }
 
-static void updateHelper (SLE::ref entry,
-    hash_set< uint256 >& seen,
-    OrderBookDB::IssueToOrderBook& destMap,
-    OrderBookDB::IssueToOrderBook& sourceMap,
-    hash_set< Issue >& XRPBooks,
-    int& books)
+void OrderBookDB::onRebuilt ()
 {
-    if (entry->getType () == ltDIR_NODE &&
-        entry->isFieldPresent (sfExchangeRate) &&
-        entry->getFieldH256 (sfRootIndex) == entry->getIndex())
-    {
-        Book book;
-        book.in.currency.copyFrom (entry->getFieldH160 (sfTakerPaysCurrency));
-        book.in.account.copyFrom (entry->getFieldH160 (sfTakerPaysIssuer));
-        book.out.account.copyFrom (entry->getFieldH160 (sfTakerGetsIssuer));
-        book.out.currency.copyFrom (entry->getFieldH160 (sfTakerGetsCurrency));
-
-        uint256 index = getBookBase (book);
-        if (seen.insert (index).second)
-        {
-            auto orderBook = std::make_shared<OrderBook> (index, book);
-            sourceMap[book.in].push_back (orderBook);
-            destMap[book.out].push_back (orderBook);
-            if (isXRP(book.out))
-                XRPBooks.insert(book.in);
-            ++books;
-        }
-    }
+    getApp().getLedgerMaster().newOrderBookDB();
 }
 
 void OrderBookDB::update (Ledger::pointer ledger)
 {
-    hash_set< uint256 > seen;
-    OrderBookDB::IssueToOrderBook destMap;
-    OrderBookDB::IssueToOrderBook sourceMap;
-    hash_set< Issue > XRPBooks;
+    OrderBookIndex books;
 
     WriteLog (lsDEBUG, OrderBookDB) << "OrderBookDB::update>";
 
     // walk through the entire ledger looking for orderbook entries
-    int books = 0;
-
     try
     {
-        ledger->visitStateItems(std::bind(&updateHelper, std::placeholders::_1,
-                                          std::ref(seen), std::ref(destMap),
-            std::ref(sourceMap), std::ref(XRPBooks), std::ref(books)));
+        ledger->visitStateItems (
+            [&books](SLE::ref entry)
+            {
+                books.addEntry (*entry);
+            });
     }
     catch (const SHAMapMissingNode&)
     {
         WriteLog (lsINFO, OrderBookDB)
             << "OrderBookDB::update encountered a missing node";
         ScopedLockType sl (mLock);
-        mSeq = 0;
+        if (mSeq == ledger->getLedgerSeq ())
+        {
+            mSeq = 0;
+            mRebuilding = false;
+            mPending.clear ();
+        }
         return;
     }
 
     WriteLog (lsDEBUG, OrderBookDB)
-        << "OrderBookDB::update< " << books << " books found";
+        << "OrderBookDB::update< " << books.size () << " books found";
     {
         ScopedLockType sl (mLock);
 
-        mXRPBooks.swap(XRPBooks);
-        mSourceMap.swap(sourceMap);
-        mDestMap.swap(destMap);
+        // A later rebuild replaced this one
+        if (mSeq != ledger->getLedgerSeq ())
+            return;
+
+        mBooks.swap (books);
+
+        // Catch up with ledgers published while we were walking
+        for (auto const& pending : mPending)
+        {
+            auto const seq = pending->getLedgerSeq ();
+            if (seq <= mSeq)
+                continue;
+            if (seq != (mSeq + 1))
+                break;
+            applyLedgerMeta (mBooks, *pending);
+            mSeq = seq;
+        }
+
+        mPending.clear ();
+        mRebuilding = false;
     }
-    getApp().getLedgerMaster().newOrderBookDB();
+    onRebuilt ();
 }
 
-void OrderBookDB::addOrderBook(Book const& book)
+void OrderBookDB::applyLedger (AcceptedLedger::pointer const& ledger)
 {
-    bool toXRP = isXRP (book.out);
-    ScopedLockType sl (mLock);
-
-    if (toXRP)
     {
-        // We don't want to search through all the to-XRP or from-XRP order
-        // books!
-        for (auto ob: mSourceMap[book.in])
+        ScopedLockType sl (mLock);
+        std::uint32_t const seq = ledger->getLedgerSeq ();
+
+        if (mRebuilding)
         {
-            if (isXRP (ob->getCurrencyOut ())) // also to XRP
-                return;
+            if (seq > mSeq)
+                mPending.push_back (ledger);
+            return;
         }
-    }
-    else
-    {
-        for (auto ob: mDestMap[book.out])
+
+        if ((mSeq != 0) && (seq <= mSeq))
+            return;
+
+        if ((mSeq != 0) && (seq == (mSeq + 1)))
         {
-            if (ob->getCurrencyIn() == book.in.currency &&
-                ob->getIssuerIn() == book.in.account)
-            {
-                return;
-            }
+            applyLedgerMeta (mBooks, *ledger);
+            mSeq = seq;
+            return;
         }
+
+        WriteLog (lsDEBUG, OrderBookDB)
+            << "Gap applying ledger " << seq << " to books at " << mSeq;
     }
-    uint256 index = getBookBase(book);
-    auto orderBook = std::make_shared<OrderBook> (index, book);
 
-    mSourceMap[book.in].push_back (orderBook);
-    mDestMap[book.out].push_back (orderBook);
-    if (toXRP)
-        mXRPBooks.insert(book.in);
+    rebuild (ledger->getLedger ());
+}
+
+void OrderBookDB::addOrderBook(Book const& book)
+{
+    ScopedLockType sl (mLock);
+    mBooks.addBook (book);
 }
 
 // return list of all orderbooks that want this issuerID and currencyID
 OrderBook::List OrderBookDB::getBooksByTakerPays (Issue const& issue)
 {
     ScopedLockType sl (mLock);
-    auto it = mSourceMap.find (issue);
-    return it == mSourceMap.end () ? OrderBook::List() : it->second;
+    return mBooks.getBooksByTakerPays (issue);
 }
 
 int OrderBookDB::getBookSize(Issue const& issue) {
     ScopedLockType sl (mLock);
-    auto it = mSourceMap.find (issue);
-    return it == mSourceMap.end () ? 0 : it->second.size();
+    return mBooks.getBookSize (issue);
 }
 
 bool OrderBookDB::isBookToXRP(Issue const& issue)
 {
     ScopedLockType sl (mLock);
-    return mXRPBooks.count(issue) > 0;
+    return mBooks.isBookToXRP (issue);
 }
 
 BookListeners::pointer OrderBookDB::makeBookListeners (Book const& book)
@@ -20,8 +20,10 @@
 #ifndef RIPPLE_APP_LEDGER_ORDERBOOKDB_H_INCLUDED
 #define RIPPLE_APP_LEDGER_ORDERBOOKDB_H_INCLUDED
 
+#include <ripple/app/ledger/AcceptedLedger.h>
 #include <ripple/app/ledger/AcceptedLedgerTx.h>
 #include <ripple/app/ledger/BookListeners.h>
+#include <ripple/app/ledger/OrderBookIndex.h>
 #include <ripple/app/misc/OrderBook.h>
 
 namespace ripple {
@@ -32,8 +34,22 @@ class OrderBookDB
 public:
     explicit OrderBookDB (Stoppable& parent);
 
+    virtual ~OrderBookDB () = default;
+
+    /** Rebuild the books from a closed ledger unless they are already
+        current. Open ledgers are ignored.
+    */
     void setup (Ledger::ref ledger);
+
+    /** Rebuild the books by walking the ledger's state map. */
     void update (Ledger::pointer ledger);
+
+    /** Bring the books forward by one published ledger.
+        The ledger's metadata is applied if it directly follows the ledger
+        the books reflect, otherwise the books are rebuilt from it.
+    */
+    void applyLedger (AcceptedLedger::pointer const& ledger);
+
     void invalidate ();
 
     void addOrderBook(Book const&);
@@ -56,19 +72,20 @@ public:
         Ledger::ref ledger, const AcceptedLedgerTx& alTx,
         Json::Value const& jvObj);
 
-    typedef hash_map <Issue, OrderBook::List> IssueToOrderBook;
+    typedef OrderBookIndex::IssueToOrderBook IssueToOrderBook;
 
-private:
-    void rawAddBook(Book const&);
+protected:
+    /** Run update for the ledger, on a job unless standalone. */
+    virtual void scheduleUpdate (Ledger::ref ledger);
 
-    // by ci/ii
-    IssueToOrderBook mSourceMap;
+    /** Called once update has replaced the books. */
+    virtual void onRebuilt ();
 
-    // by co/io
-    IssueToOrderBook mDestMap;
+private:
+    // Start walking the ledger, queuing ledgers published meanwhile
+    void rebuild (Ledger::ref ledger);
 
-    // does an order book to XRP exist
-    hash_set <Issue> mXRPBooks;
+    OrderBookIndex mBooks;
 
     typedef RippleRecursiveMutex LockType;
     typedef std::lock_guard <LockType> ScopedLockType;
@@ -79,7 +96,14 @@ private:
 
     BookToListenersMap mListeners;
 
+    // The ledger the books reflect, or are being rebuilt from
     std::uint32_t mSeq;
+
+    // True while update is rebuilding the books
+    bool mRebuilding;
+
+    // Ledgers published during a rebuild, applied once it finishes
+    std::vector <AcceptedLedger::pointer> mPending;
 };
 
 } // ripple
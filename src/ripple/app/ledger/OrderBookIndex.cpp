@@ -0,0 +1,221 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/OrderBookIndex.h>
+#include <ripple/app/tx/TransactionMeta.h>
+#include <ripple/protocol/Indexes.h>
+#include <algorithm>
+
+namespace ripple {
+
+// Metadata leaves out fields holding default values, so a missing
+// currency or issuer means XRP.
+static uint160 getH160 (STObject const& object, SField const& field)
+{
+    if (object.isFieldPresent (field))
+        return object.getFieldH160 (field);
+    return uint160 ();
+}
+
+// Returns true and fills in the book if the fields describe the root
+// of a book directory at the given index.
+static bool getDirectoryBook (STObject const& fields,
+    uint256 const& index, Book& book)
+{
+    if (! fields.isFieldPresent (sfExchangeRate) ||
+        ! fields.isFieldPresent (sfRootIndex) ||
+        fields.getFieldH256 (sfRootIndex) != index)
+        return false;
+
+    book.in.currency.copyFrom (getH160 (fields, sfTakerPaysCurrency));
+    book.in.account.copyFrom (getH160 (fields, sfTakerPaysIssuer));
+    book.out.currency.copyFrom (getH160 (fields, sfTakerGetsCurrency));
+    book.out.account.copyFrom (getH160 (fields, sfTakerGetsIssuer));
+    return true;
+}
+
+void OrderBookIndex::addEntry (SLE const& entry)
+{
+    Book book;
+    if (entry.getType () == ltDIR_NODE &&
+        getDirectoryBook (entry, entry.getIndex (), book))
+    {
+        addDirectory (book);
+    }
+}
+
+void OrderBookIndex::applyMeta (TransactionMetaSet& meta)
+{
+    for (auto const& node : meta.getNodes ())
+        applyNode (node);
+}
+
+void OrderBookIndex::applyNode (STObject const& node)
+{
+    if (node.getFieldU16 (sfLedgerEntryType) != ltDIR_NODE)
+        return;
+
+    bool created;
+    SField const* field;
+    if (node.getFName () == sfCreatedNode)
+    {
+        created = true;
+        field = &sfNewFields;
+    }
+    else if (node.getFName () == sfDeletedNode)
+    {
+        created = false;
+        field = &sfFinalFields;
+    }
+    else
+    {
+        return;
+    }
+
+    auto const fields = dynamic_cast <STObject const*> (
+        node.peekAtPField (*field));
+
+    Book book;
+    if (fields && getDirectoryBook (
+            *fields, node.getFieldH256 (sfLedgerIndex), book))
+    {
+        if (created)
+            addDirectory (book);
+        else
+            removeDirectory (book);
+    }
+}
+
+OrderBookIndex::Entry& OrderBookIndex::insert (Book const& book)
+{
+    uint256 const base = getBookBase (book);
+    auto it = mBooks.find (base);
+    if (it != mBooks.end ())
+        return it->second;
+
+    auto orderBook = std::make_shared <OrderBook> (base, book);
+    mSourceMap[book.in].push_back (orderBook);
+    mDestMap[book.out].push_back (orderBook);
+    if (isXRP (book.out))
+        ++mXRPBooks[book.in];
+    return mBooks.emplace (base, Entry {orderBook, 0}).first->second;
+}
+
+void OrderBookIndex::addBook (Book const& book)
+{
+    if (insert (book).directories <= 0)
+        mAdded.insert (getBookBase (book));
+}
+
+void OrderBookIndex::addDirectory (Book const& book)
+{
+    ++insert (book).directories;
+}
+
+void OrderBookIndex::removeDirectory (Book const& book)
+{
+    auto const it = mBooks.find (getBookBase (book));
+    if (it == mBooks.end ())
+        return;
+
+    if (--it->second.directories > 0)
+        return;
+
+    erase (it);
+}
+
+void OrderBookIndex::removeUncounted ()
+{
+    for (auto const& base : mAdded)
+    {
+        auto const it = mBooks.find (base);
+        if (it != mBooks.end () && it->second.directories <= 0)
+            erase (it);
+    }
+    mAdded.clear ();
+}
+
+OrderBookIndex::BookMap::iterator
+OrderBookIndex::erase (BookMap::iterator it)
+{
+    Book const& book = it->second.book->book ();
+
+    // Erase the book from a list, and the list if it becomes empty
+    auto const eraseFrom = [&it](IssueToOrderBook& map, Issue const& issue)
+    {
+        auto const list = map.find (issue);
+        if (list == map.end ())
+            return;
+        list->second.erase (std::remove (list->second.begin (),
+            list->second.end (), it->second.book), list->second.end ());
+        if (list->second.empty ())
+            map.erase (list);
+    };
+
+    eraseFrom (mSourceMap, book.in);
+    eraseFrom (mDestMap, book.out);
+
+    if (isXRP (book.out))
+    {
+        auto const xrp = mXRPBooks.find (book.in);
+        if (xrp != mXRPBooks.end () && --xrp->second <= 0)
+            mXRPBooks.erase (xrp);
+    }
+
+    return mBooks.erase (it);
+}
+
+OrderBook::List OrderBookIndex::getBooksByTakerPays (Issue const& issue) const
+{
+    auto it = mSourceMap.find (issue);
+    return it == mSourceMap.end () ? OrderBook::List() : it->second;
+}
+
+int OrderBookIndex::getBookSize (Issue const& issue) const
+{
+    auto it = mSourceMap.find (issue);
+    return it == mSourceMap.end () ? 0 : it->second.size();
+}
+
+bool OrderBookIndex::isBookToXRP (Issue const& issue) const
+{
+    return mXRPBooks.count (issue) > 0;
+}
+
+std::vector <uint256> OrderBookIndex::getBookBases () const
+{
+    std::vector <uint256> bases;
+    bases.reserve (mBooks.size ());
+    for (auto const& book : mBooks)
+        bases.push_back (book.first);
+    return bases;
+}
+
+void OrderBookIndex::swap (OrderBookIndex& other)
+{
+    mBooks.swap (other.mBooks);
+    mSourceMap.swap (other.mSourceMap);
+    mDestMap.swap (other.mDestMap);
+    mXRPBooks.swap (other.mXRPBooks);
+    mAdded.swap (other.mAdded);
+}
+
+} // ripple
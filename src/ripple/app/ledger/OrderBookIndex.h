@@ -0,0 +1,122 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_APP_LEDGER_ORDERBOOKINDEX_H_INCLUDED
+#define RIPPLE_APP_LEDGER_ORDERBOOKINDEX_H_INCLUDED
+
+#include <ripple/protocol/Book.h>
+#include <ripple/protocol/STLedgerEntry.h>
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/app/misc/OrderBook.h>
+#include <cstddef>
+#include <vector>
+
+namespace ripple {
+
+class TransactionMetaSet;
+
+/** The order books present in a ledger, indexed by issue.
+
+    A book exists while at least one of its quality directories does, so
+    each book counts the directory roots that refer to it. The index can
+    be built from a full walk of the state map with addEntry, then kept
+    current from each following ledger's metadata with applyMeta.
+*/
+class OrderBookIndex
+{
+public:
+    typedef hash_map <Issue, OrderBook::List> IssueToOrderBook;
+
+    /** Count the entry if it is the root of a book directory. */
+    void addEntry (SLE const& entry);
+
+    /** Apply the directory roots a transaction created or deleted. */
+    void applyMeta (TransactionMetaSet& meta);
+
+    /** Apply one CreatedNode or DeletedNode from transaction metadata. */
+    void applyNode (STObject const& node);
+
+    /** Make sure the book is present, without counting a directory.
+        Used for books seen before the ledger that creates them is
+        validated. They are removed by removeUncounted if no directory
+        refers to them by then.
+    */
+    void addBook (Book const& book);
+
+    /** Remove the books that no directory refers to. */
+    void removeUncounted ();
+
+    /** Return all books taking the given issue. */
+    OrderBook::List getBooksByTakerPays (Issue const& issue) const;
+
+    /** Return the number of books taking the given issue. */
+    int getBookSize (Issue const& issue) const;
+
+    /** Return true if a book converts the given issue to XRP. */
+    bool isBookToXRP (Issue const& issue) const;
+
+    /** Return the number of books. */
+    std::size_t size () const
+    {
+        return mBooks.size ();
+    }
+
+    /** Return the base index of every book, in no particular order. */
+    std::vector <uint256> getBookBases () const;
+
+    void swap (OrderBookIndex& other);
+
+private:
+    struct Entry
+    {
+        OrderBook::pointer book;
+        int directories;
+    };
+
+    // Returns the book's entry, adding it with no directories if needed
+    Entry& insert (Book const& book);
+
+    typedef hash_map <uint256, Entry> BookMap;
+
+    void addDirectory (Book const& book);
+    void removeDirectory (Book const& book);
+
+    // Removes the book from every map, returning the next book
+    BookMap::iterator erase (BookMap::iterator it);
+
+    // Book base to book and directory count
+    BookMap mBooks;
+
+    // Books added by addBook, which may have no directory
+    hash_set <uint256> mAdded;
+
+    // by ci/ii
+    IssueToOrderBook mSourceMap;
+
+    // by co/io
+    IssueToOrderBook mDestMap;
+
+    // issues with a book to XRP, and how many such books
+    hash_map <Issue, int> mXRPBooks;
+};
+
+} // ripple
+
+#endif
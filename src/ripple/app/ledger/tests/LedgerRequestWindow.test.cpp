@@ -0,0 +1,240 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/LedgerRequestWindow.h>
+#include <beast/unit_test/suite.h>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <set>
+
+namespace ripple {
+namespace test {
+
+class LedgerRequestWindow_test : public beast::unit_test::suite
+{
+public:
+    using PeerID = LedgerRequestWindow::PeerID;
+    using time_point = LedgerRequestWindow::time_point;
+
+    static time_point at (long micros)
+    {
+        return time_point () + std::chrono::microseconds (micros);
+    }
+
+    static std::vector<SHAMapNodeID> children (SHAMapNodeID const& node)
+    {
+        std::vector<SHAMapNodeID> ret;
+        for (int branch = 0; branch < 16; ++branch)
+            ret.push_back (node.getChildNodeID (branch));
+        return ret;
+    }
+
+    void testAssign ()
+    {
+        testcase ("assign");
+
+        LedgerRequestWindow w (2, std::chrono::seconds (1));
+        w.addPeer (1);
+        w.addPeer (2);
+        w.addPeer (3);
+        expect (w.available () == 6, "bad window");
+
+        auto nodes = children (SHAMapNodeID ());
+        std::reverse (nodes.begin (), nodes.end ());
+
+        auto const requests = w.assign (nodes, 4, at (0));
+        expect (requests.size () == 6, "bad request count");
+        expect (w.available () == 0, "window not full");
+        expect (w.outstanding () == 6, "bad outstanding count");
+
+        // Each node is asked for once and each request is a key range
+        std::size_t total = 0;
+        std::vector<uint256> keys;
+        for (auto const& request : requests)
+        {
+            expect (request.second.size () <= 4, "request too large");
+            total += request.second.size ();
+            for (auto const& id : request.second)
+                keys.push_back (id.getNodeID ());
+        }
+        expect (total == nodes.size (), "nodes lost");
+        expect (std::is_sorted (keys.begin (), keys.end ()), "ranges overlap");
+
+        // Every peer gets a request before any peer gets a second
+        std::set<PeerID> first;
+        for (std::size_t i = 0; i < 3; ++i)
+            first.insert (requests[i].first);
+        expect (first.size () == 3, "peer skipped");
+
+        expect (w.assign (nodes, 4, at (0)).empty (), "window overrun");
+    }
+
+    void testRanking ()
+    {
+        testcase ("ranking");
+
+        LedgerRequestWindow w (1, std::chrono::seconds (1));
+        w.addPeer (1);
+        w.addPeer (2);
+        w.addPeer (3);
+        w.assign (children (SHAMapNodeID ()), 128, at (0));
+
+        w.onReply (1, 100, at (400000));
+        w.onReply (2, 100, at (100000));
+
+        // A peer that has not replied is tried first
+        auto ranking = w.ranking ();
+        expect (ranking.size () == 3 && ranking[0] == 3, "bad ranking");
+        expect (w.outstanding () == 1, "bad outstanding count");
+
+        // Until its request times out
+        w.expire (at (1500000));
+        ranking = w.ranking ();
+        expect (ranking == std::vector<PeerID> ({ 2, 1, 3 }), "bad ranking");
+        expect (w.outstanding () == 0, "request not expired");
+        expect (w.available () == 3, "bad window");
+
+        expect (w.nodes () == 200, "bad node count");
+        expect (std::abs (w.nodesPerSecond () - 500) < 1e-6, "bad rate");
+
+        w.removePeer (2);
+        expect (w.size () == 2, "peer not removed");
+    }
+
+    // Fetches every node of a full tree of the given depth from simulated
+    // peers, and returns the simulated microseconds it took.
+    //
+    // A request reaches a peer after half its round trip latency, waits
+    // for the peer's earlier requests, is served at a fixed time per node,
+    // and the reply takes the other half of the latency to return.
+    long simulate (std::vector<long> const& latencies,
+        std::size_t window, int depth)
+    {
+        long const nodeCost = 100;
+        std::size_t const perRequest = 128;
+
+        struct Reply
+        {
+            long when;
+            PeerID peer;
+            std::vector<SHAMapNodeID> nodes;
+
+            bool operator> (Reply const& other) const
+            {
+                return when > other.when;
+            }
+        };
+
+        LedgerRequestWindow w (window, std::chrono::seconds (60));
+        std::vector<long> busy (latencies.size (), 0);
+        for (PeerID id = 0; id < latencies.size (); ++id)
+            w.addPeer (id);
+
+        std::priority_queue<Reply, std::vector<Reply>,
+            std::greater<Reply>> pending;
+        std::vector<SHAMapNodeID> missing = children (SHAMapNodeID ());
+        std::size_t received = 0;
+        long now = 0;
+
+        auto const send = [&]()
+        {
+            std::size_t const n = std::min (
+                missing.size (), w.available () * perRequest);
+            if (n == 0)
+                return;
+
+            std::vector<SHAMapNodeID> ask (missing.begin (),
+                missing.begin () + n);
+            missing.erase (missing.begin (), missing.begin () + n);
+
+            for (auto& request : w.assign (ask, perRequest, at (now)))
+            {
+                long const latency = latencies[request.first];
+                long& free = busy[request.first];
+                free = std::max (free, now + latency / 2) +
+                    nodeCost * request.second.size ();
+                pending.push (Reply {free + latency / 2,
+                    request.first, std::move (request.second)});
+            }
+        };
+
+        send ();
+        while (!pending.empty ())
+        {
+            Reply reply = pending.top ();
+            pending.pop ();
+            now = reply.when;
+
+            w.onReply (reply.peer, reply.nodes.size (), at (now));
+            received += reply.nodes.size ();
+
+            for (auto const& node : reply.nodes)
+            {
+                if (node.getDepth () < depth)
+                {
+                    auto const more = children (node);
+                    missing.insert (missing.end (), more.begin (), more.end ());
+                }
+            }
+
+            send ();
+        }
+
+        std::size_t total = 0;
+        for (std::size_t i = 0, n = 16; i < depth; ++i, n *= 16)
+            total += n;
+        expect (received == total, "nodes lost");
+        expect (missing.empty (), "nodes not requested");
+
+        return now;
+    }
+
+    void testSimulation ()
+    {
+        testcase ("simulation");
+
+        std::vector<long> const latencies = { 100000, 100000, 150000, 200000 };
+        int const depth = 3;
+
+        // One request at a time to one peer, as before windowing
+        long const single = simulate ({ latencies[0] }, 1, depth);
+        long const windowed = simulate (latencies, 4, depth);
+
+        log << "single peer: " << single / 1000 << "ms, " <<
+            latencies.size () << " peers windowed: " << windowed / 1000 << "ms";
+
+        expect (windowed * 2 < single, "no speedup");
+    }
+
+    void run ()
+    {
+        testAssign ();
+        testRanking ();
+        testSimulation ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(LedgerRequestWindow,app,ripple);
+
+} // test
+} // ripple
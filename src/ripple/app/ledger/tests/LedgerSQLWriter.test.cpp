@@ -0,0 +1,135 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/LedgerSQLWriter.h>
+#include <ripple/app/data/DBInit.h>
+#include <ripple/basics/tests/benchmark.h>
+#include <ripple/protocol/RippleAddress.h>
+#include <beast/module/core/maths/Random.h>
+#include <beast/unit_test/suite.h>
+
+namespace ripple {
+
+// Measures the rate at which validated ledger rows are written to
+// temporary SQL databases.
+class LedgerSQLWriter_test : public beast::unit_test::suite
+{
+public:
+#ifndef NDEBUG
+    std::size_t const default_ledgers = 100;
+#else
+    std::size_t const default_ledgers = 1000; // release
+#endif
+    std::size_t const txns_per_ledger = 200;
+    std::size_t const accounts = 1000;
+
+    static
+    uint256
+    random_hash (beast::Random& r)
+    {
+        uint256 hash;
+        r.fillBitsRandomly (hash.begin (), hash.size ());
+        return hash;
+    }
+
+    static
+    Blob
+    random_blob (beast::Random& r, std::size_t size)
+    {
+        Blob blob (size);
+        r.fillBitsRandomly (blob.data (), blob.size ());
+        return blob;
+    }
+
+    void
+    run () override
+    {
+        std::size_t ledgers = default_ledgers;
+        if (! arg().empty())
+            ledgers = std::stoul (arg());
+
+        DatabaseCon::Setup setup;
+        setup.standAlone = true;
+        DatabaseCon ledgerDB (setup, "ledger.db", LedgerDBInit, LedgerDBCount);
+        DatabaseCon txnDB (setup, "transaction.db", TxnDBInit, TxnDBCount);
+        LedgerSQLWriter writer (ledgerDB, txnDB);
+
+        beast::Random r;
+
+        std::vector <std::string> ids;
+        ids.reserve (accounts);
+        for (std::size_t i = 0; i < accounts; ++i)
+        {
+            Account id;
+            r.fillBitsRandomly (id.begin (), id.size ());
+            RippleAddress a;
+            a.setAccountID (id);
+            ids.push_back (a.humanAccountID ());
+        }
+
+        testcase ("save " + std::to_string (ledgers) + " ledgers");
+
+        std::size_t rows = 0;
+        test::benchmark_clock::duration elapsed {};
+        std::vector <LedgerSQLWriter::Txn> txns (txns_per_ledger);
+        for (std::uint32_t seq = 1; seq <= ledgers; ++seq)
+        {
+            for (std::size_t i = 0; i < txns.size (); ++i)
+            {
+                LedgerSQLWriter::Txn& txn = txns[i];
+                txn.id = random_hash (r);
+                txn.type = "Payment";
+                txn.account = ids[r.nextInt (accounts)];
+                txn.sequence = seq;
+                txn.txnSeq = i;
+                txn.raw = random_blob (r, 180);
+                txn.meta = random_blob (r, 400);
+                txn.affected = { txn.account, ids[r.nextInt (accounts)] };
+            }
+
+            LedgerSQLWriter::Header header;
+            header.hash = random_hash (r);
+            header.seq = seq;
+            header.parentHash = random_hash (r);
+            header.totalCoins = 100000000000000000ull;
+            header.closeTime = seq * 10;
+            header.parentCloseTime = (seq - 1) * 10;
+            header.closeResolution = 10;
+            header.closeFlags = 0;
+            header.accountHash = random_hash (r);
+            header.transHash = random_hash (r);
+
+            auto const start = test::benchmark_clock::now();
+            writer.deleteLedger (seq);
+            rows += writer.saveTransactions (seq, txns);
+            writer.saveLedger (header);
+            elapsed += test::benchmark_clock::now() - start;
+            ++rows;
+        }
+
+        expect (rows == ledgers * (1 + txns_per_ledger * 3));
+        log << rows << " rows: " << test::format_rate (test::per_second (
+            rows, test::to_seconds (elapsed))) << " rows/s";
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(LedgerSQLWriter,app,ripple);
+
+}
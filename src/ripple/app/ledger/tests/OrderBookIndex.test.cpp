@@ -0,0 +1,539 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/OrderBookDB.h>
+#include <ripple/app/ledger/OrderBookIndex.h>
+#include <ripple/app/tests/common_ledger.h>
+#include <beast/threads/Stoppable.h>
+#include <beast/unit_test/suite.h>
+#include <algorithm>
+#include <random>
+#include <ratio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+// Keeps an OrderBookIndex current from the metadata of offers applied to
+// a run of ledgers, and checks it against a full rebuild after each one.
+class OrderBookIndex_test : public beast::unit_test::suite
+{
+public:
+    static std::uint64_t const xrp = std::mega::num;
+
+    struct Env
+    {
+        TestAccount master;
+        TestAccount gw;
+        std::vector <TestAccount> users;
+        std::vector <std::string> currencies;
+        Ledger::pointer LCL;
+        Ledger::pointer ledger;
+    };
+
+    // Closes the open ledger and opens the next one
+    static void
+    advance (Env& env)
+    {
+        env.LCL = close_and_advance (env.ledger, env.LCL);
+        env.ledger = std::make_shared <Ledger> (false, *env.LCL);
+    }
+
+    // Funded users holding every currency the gateway issues
+    static void
+    setup (Env& env)
+    {
+        env.master = createAccount ("masterpassphrase", KeyType::secp256k1);
+        env.gw = createAccount ("gw", KeyType::secp256k1);
+        for (int i = 0; i < 3; ++i)
+            env.users.push_back (createAccount (
+                "user" + std::to_string (i), KeyType::secp256k1));
+        env.currencies = { "FOO", "BAR", "BAZ" };
+
+        env.LCL = createGenesisLedger (100000 * xrp, env.master);
+        env.ledger = std::make_shared <Ledger> (false, *env.LCL);
+
+        makeAndApplyPayment (env.master, env.gw, 10000 * xrp, env.ledger);
+        for (auto& user : env.users)
+            makeAndApplyPayment (env.master, user, 10000 * xrp, env.ledger);
+        advance (env);
+
+        for (auto& user : env.users)
+            for (auto const& currency : env.currencies)
+                makeTrustSet (user, env.gw, currency, 1000, env.ledger);
+        advance (env);
+
+        for (auto& user : env.users)
+            for (auto const& currency : env.currencies)
+                makeAndApplyPayment (env.gw, user, currency, "100",
+                    env.ledger);
+        advance (env);
+    }
+
+    // An amount of a gateway currency, or of XRP for an empty currency
+    static Json::Value
+    amount (Env const& env, std::string const& currency, int value)
+    {
+        if (currency.empty ())
+            return std::to_string (value * xrp);
+        return Amount (value, currency, env.gw).getJson ();
+    }
+
+    static Issue
+    issue (Env const& env, std::string const& currency)
+    {
+        if (currency.empty ())
+            return xrpIssue ();
+        return Issue (to_currency (currency), env.gw.pk.getAccountID ());
+    }
+
+    // Places an offer and returns its sequence
+    static unsigned
+    offer (TestAccount& from, Json::Value const& pays,
+        Json::Value const& gets, Ledger::pointer const& ledger)
+    {
+        Json::Value tx_json;
+        tx_json["TransactionType"] = "OfferCreate";
+        tx_json["Fee"] = std::to_string (10);
+        tx_json["Account"] = from.pk.humanAccountID ();
+        tx_json["TakerPays"] = pays;
+        tx_json["TakerGets"] = gets;
+        tx_json["Sequence"] = ++from.sequence;
+        applyTransaction (ledger, parseTransaction (from, tx_json));
+        return from.sequence;
+    }
+
+    static void
+    cancel (TestAccount& from, unsigned offerSequence,
+        Ledger::pointer const& ledger)
+    {
+        Json::Value tx_json;
+        tx_json["TransactionType"] = "OfferCancel";
+        tx_json["Fee"] = std::to_string (10);
+        tx_json["Account"] = from.pk.humanAccountID ();
+        tx_json["OfferSequence"] = offerSequence;
+        tx_json["Sequence"] = ++from.sequence;
+        applyTransaction (ledger, parseTransaction (from, tx_json));
+    }
+
+    // Apply the metadata of every transaction in a closed ledger, the
+    // way OrderBookDB does for a published ledger
+    static void
+    applyLedger (OrderBookIndex& books, Ledger::ref ledger)
+    {
+        for (auto const& item : *ledger->peekTransactionMap ())
+        {
+            TransactionMetaSet::pointer meta;
+            if (ledger->getTransactionMeta (item->getTag (), meta))
+                books.applyMeta (*meta);
+        }
+        books.removeUncounted ();
+    }
+
+    static void
+    rebuild (OrderBookIndex& books, Ledger::ref ledger)
+    {
+        ledger->visitStateItems (
+            [&books](SLE::ref entry)
+            {
+                books.addEntry (*entry);
+            });
+    }
+
+    bool
+    same (OrderBookIndex const& lhs, OrderBookIndex const& rhs,
+        std::vector <Issue> const& issues)
+    {
+        auto a = lhs.getBookBases ();
+        auto b = rhs.getBookBases ();
+        std::sort (a.begin (), a.end ());
+        std::sort (b.begin (), b.end ());
+        if (a != b)
+            return false;
+
+        for (auto const& issue : issues)
+        {
+            if (lhs.getBookSize (issue) != rhs.getBookSize (issue))
+                return false;
+            if (lhs.isBookToXRP (issue) != rhs.isBookToXRP (issue))
+                return false;
+        }
+        return true;
+    }
+
+    void
+    testIncremental ()
+    {
+        testcase ("incremental");
+
+        Env env;
+        setup (env);
+
+        // The gateway currencies, and XRP
+        std::vector <std::string> currencies (env.currencies);
+        currencies.push_back ("");
+
+        std::vector <Issue> issues;
+        for (auto const& currency : currencies)
+            issues.push_back (issue (env, currency));
+
+        OrderBookIndex incremental;
+        rebuild (incremental, env.LCL);
+        expect (incremental.size () == 0);
+
+        // Offers still open, by user and sequence
+        std::vector <std::pair <std::size_t, unsigned>> open;
+
+        std::mt19937 gen (7);
+        std::uniform_int_distribution <std::size_t> user (
+            0, env.users.size () - 1);
+        std::uniform_int_distribution <std::size_t> currency (
+            0, currencies.size () - 1);
+        std::uniform_int_distribution <int> rate (1, 3);
+        std::uniform_int_distribution <int> ops (1, 6);
+
+        bool ok = true;
+        std::size_t most = 0;
+
+        for (int ledger = 0; ok && ledger < 20; ++ledger)
+        {
+            for (int n = ops (gen); n > 0; --n)
+            {
+                if (open.empty () || (gen () % 3 != 0))
+                {
+                    // Offers in opposite directions at matching rates
+                    // cross, deleting directories as well as creating them
+                    auto const in = currencies[currency (gen)];
+                    auto const out = currencies[currency (gen)];
+                    if (in == out)
+                        continue;
+                    auto const u = user (gen);
+                    open.emplace_back (u, offer (env.users[u],
+                        amount (env, in, rate (gen)), amount (env, out, 1),
+                        env.ledger));
+                }
+                else
+                {
+                    auto const it = open.begin () + gen () % open.size ();
+                    cancel (env.users[it->first], it->second, env.ledger);
+                    open.erase (it);
+                }
+            }
+
+            advance (env);
+            applyLedger (incremental, env.LCL);
+
+            OrderBookIndex rebuilt;
+            rebuild (rebuilt, env.LCL);
+            most = std::max (most, rebuilt.size ());
+
+            if (! same (incremental, rebuilt, issues))
+            {
+                log << "ledger " << env.LCL->getLedgerSeq () << ": " <<
+                    incremental.size () << " books incrementally, " <<
+                    rebuilt.size () << " rebuilt";
+                ok = false;
+            }
+        }
+
+        expect (ok, "incremental books differ from a rebuild");
+        expect (most > 3, "too few books");
+    }
+
+    void
+    testProvisional ()
+    {
+        testcase ("provisional");
+
+        Env env;
+        setup (env);
+
+        Issue const foo = issue (env, "FOO");
+        Issue const bar = issue (env, "BAR");
+
+        OrderBookIndex index;
+        rebuild (index, env.LCL);
+
+        // Books seen before validation are present but not counted
+        index.addBook (Book (foo, xrpIssue ()));
+        index.addBook (Book (bar, foo));
+        expect (index.size () == 2);
+        expect (index.isBookToXRP (foo));
+
+        // Only the second book is created by the ledger
+        offer (env.users[0], amount (env, "BAR", 2), amount (env, "FOO", 1),
+            env.ledger);
+        advance (env);
+        applyLedger (index, env.LCL);
+
+        expect (index.size () == 1);
+        expect (index.getBookSize (bar) == 1);
+        expect (! index.isBookToXRP (foo));
+
+        OrderBookIndex rebuilt;
+        rebuild (rebuilt, env.LCL);
+        expect (same (index, rebuilt, { foo, bar, xrpIssue () }));
+
+        // Seeing an existing book again leaves it counted
+        index.addBook (Book (bar, foo));
+        advance (env);
+        applyLedger (index, env.LCL);
+        expect (index.getBookSize (bar) == 1);
+    }
+
+    void
+    run ()
+    {
+        testIncremental ();
+        testProvisional ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(OrderBookIndex,app,ripple);
+
+//------------------------------------------------------------------------------
+
+// Checks the order in which OrderBookDB sees ledgers: the startup setup,
+// then each published ledger, with rebuilds run when the test chooses.
+class OrderBookDB_test : public beast::unit_test::suite
+{
+public:
+    typedef OrderBookIndex_test::Env Env;
+
+    // Holds rebuilds until the test runs them, instead of using a job
+    class TestOrderBookDB : public OrderBookDB
+    {
+    public:
+        explicit TestOrderBookDB (Stoppable& parent)
+            : OrderBookDB (parent)
+            , rebuilt (0)
+        {
+        }
+
+        // Runs the rebuilds scheduled so far
+        void
+        runUpdates ()
+        {
+            auto ledgers = std::move (scheduled);
+            scheduled.clear ();
+            for (auto const& ledger : ledgers)
+                update (ledger);
+        }
+
+        std::vector <Ledger::pointer> scheduled;
+        int rebuilt;
+
+    private:
+        void
+        scheduleUpdate (Ledger::ref ledger) override
+        {
+            scheduled.push_back (ledger);
+        }
+
+        void
+        onRebuilt () override
+        {
+            ++rebuilt;
+        }
+    };
+
+    static void
+    publish (OrderBookDB& db, Ledger::ref ledger)
+    {
+        db.applyLedger (AcceptedLedger::makeAcceptedLedger (ledger));
+    }
+
+    // True if the books match a walk of the ledger's state
+    bool
+    same (OrderBookDB& db, Ledger::ref ledger,
+        std::vector <Issue> const& issues)
+    {
+        OrderBookIndex rebuilt;
+        OrderBookIndex_test::rebuild (rebuilt, ledger);
+
+        for (auto const& issue : issues)
+        {
+            if (db.getBookSize (issue) != rebuilt.getBookSize (issue))
+                return false;
+            if (db.isBookToXRP (issue) != rebuilt.isBookToXRP (issue))
+                return false;
+
+            auto a = db.getBooksByTakerPays (issue);
+            auto b = rebuilt.getBooksByTakerPays (issue);
+            auto const byBase = [](OrderBook::ref lhs, OrderBook::ref rhs)
+            {
+                return lhs->getBookBase () < rhs->getBookBase ();
+            };
+            std::sort (a.begin (), a.end (), byBase);
+            std::sort (b.begin (), b.end (), byBase);
+            if (! std::equal (a.begin (), a.end (), b.begin (),
+                    [](OrderBook::ref lhs, OrderBook::ref rhs)
+                    {
+                        return lhs->getBookBase () == rhs->getBookBase ();
+                    }))
+                return false;
+        }
+        return true;
+    }
+
+    void
+    testStartup ()
+    {
+        testcase ("setup then publish");
+
+        Env env;
+        OrderBookIndex_test::setup (env);
+
+        Issue const foo = OrderBookIndex_test::issue (env, "FOO");
+        Issue const bar = OrderBookIndex_test::issue (env, "BAR");
+        std::vector <Issue> const issues { foo, bar, xrpIssue () };
+
+        beast::RootStoppable root ("root");
+        TestOrderBookDB db (root);
+
+        // The open ledger matches no published sequence
+        db.setup (env.ledger);
+        expect (db.scheduled.empty (), "rebuilt from an open ledger");
+
+        db.setup (env.LCL);
+        expect (db.scheduled.size () == 1);
+        db.runUpdates ();
+        expect (db.rebuilt == 1);
+        expect (same (db, env.LCL, issues));
+
+        // A book seen in the open ledger, created by the next published one
+        db.addOrderBook (Book (foo, xrpIssue ()));
+        OrderBookIndex_test::offer (env.users[0],
+            OrderBookIndex_test::amount (env, "FOO", 2),
+            OrderBookIndex_test::amount (env, "", 1), env.ledger);
+        OrderBookIndex_test::advance (env);
+        publish (db, env.LCL);
+
+        expect (db.scheduled.empty (), "rebuilt instead of applying");
+        expect (db.isBookToXRP (foo), "published offer's book missing");
+        expect (same (db, env.LCL, issues));
+
+        // The next ledger follows on from the metadata
+        OrderBookIndex_test::offer (env.users[1],
+            OrderBookIndex_test::amount (env, "BAR", 2),
+            OrderBookIndex_test::amount (env, "FOO", 1), env.ledger);
+        OrderBookIndex_test::advance (env);
+        publish (db, env.LCL);
+
+        expect (db.scheduled.empty (), "rebuilt instead of applying");
+        expect (db.getBookSize (bar) == 1);
+        expect (same (db, env.LCL, issues));
+
+        // Publishing a ledger again changes nothing
+        publish (db, env.LCL);
+        expect (db.scheduled.empty ());
+        expect (db.rebuilt == 1);
+        expect (same (db, env.LCL, issues));
+    }
+
+    void
+    testPublishWhileRebuilding ()
+    {
+        testcase ("publish while rebuilding");
+
+        Env env;
+        OrderBookIndex_test::setup (env);
+
+        Issue const foo = OrderBookIndex_test::issue (env, "FOO");
+        Issue const bar = OrderBookIndex_test::issue (env, "BAR");
+        std::vector <Issue> const issues { foo, bar, xrpIssue () };
+
+        beast::RootStoppable root ("root");
+        TestOrderBookDB db (root);
+
+        db.setup (env.LCL);
+        expect (db.scheduled.size () == 1);
+
+        // Both ledgers arrive before the walk of the first finishes
+        auto const seq = OrderBookIndex_test::offer (env.users[0],
+            OrderBookIndex_test::amount (env, "FOO", 2),
+            OrderBookIndex_test::amount (env, "", 1), env.ledger);
+        OrderBookIndex_test::advance (env);
+        publish (db, env.LCL);
+
+        OrderBookIndex_test::cancel (env.users[0], seq, env.ledger);
+        OrderBookIndex_test::offer (env.users[1],
+            OrderBookIndex_test::amount (env, "BAR", 2),
+            OrderBookIndex_test::amount (env, "FOO", 1), env.ledger);
+        OrderBookIndex_test::advance (env);
+        publish (db, env.LCL);
+
+        expect (db.scheduled.size () == 1, "publish restarted the rebuild");
+        db.runUpdates ();
+
+        expect (db.rebuilt == 1);
+        expect (! db.isBookToXRP (foo), "cancelled offer's book kept");
+        expect (db.getBookSize (bar) == 1);
+        expect (same (db, env.LCL, issues));
+    }
+
+    void
+    testGap ()
+    {
+        testcase ("gap");
+
+        Env env;
+        OrderBookIndex_test::setup (env);
+
+        Issue const foo = OrderBookIndex_test::issue (env, "FOO");
+        std::vector <Issue> const issues { foo, xrpIssue () };
+
+        beast::RootStoppable root ("root");
+        TestOrderBookDB db (root);
+
+        db.setup (env.LCL);
+        db.runUpdates ();
+
+        // A ledger that is never published forces a rebuild
+        OrderBookIndex_test::offer (env.users[0],
+            OrderBookIndex_test::amount (env, "FOO", 2),
+            OrderBookIndex_test::amount (env, "", 1), env.ledger);
+        OrderBookIndex_test::advance (env);
+        OrderBookIndex_test::advance (env);
+        publish (db, env.LCL);
+
+        expect (db.scheduled.size () == 1, "gap did not rebuild");
+        db.runUpdates ();
+        expect (db.rebuilt == 2);
+        expect (db.isBookToXRP (foo));
+        expect (same (db, env.LCL, issues));
+    }
+
+    void
+    run ()
+    {
+        testStartup ();
+        testPublishWhileRebuilding ();
+        testGap ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(OrderBookDB,app,ripple);
+
+} // test
+} // ripple
@@ -26,6 +26,7 @@
 #include <ripple/app/ledger/AcceptedLedger.h>
 #include <ripple/app/ledger/InboundLedgers.h>
 #include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/ledger/LedgerSQLWriter.h>
 #include <ripple/app/ledger/OrderBookDB.h>
 #include <ripple/app/main/CollectorManager.h>
 #include <ripple/app/main/LoadManager.h>
@@ -110,6 +111,8 @@ private:
     TreeNodeCache treecache_;
     FullBelowCache fullbelow_;
     NodeStore::Database& db_;
+    beast::insight::Event flush_;
+    beast::insight::Counter flushed_;
 
 public:
     AppFamily (AppFamily const&) = delete;
@@ -123,6 +126,10 @@ public:
             collectorManager.collector(),
                 fullBelowTargetSize, fullBelowExpirationSeconds)
         , db_ (db)
+        , flush_ (collectorManager.collector()->make_event (
+            "shamap", "flush"))
+        , flushed_ (collectorManager.collector()->make_counter (
+            "shamap", "flushed_nodes"))
     {
     }
 
@@ -167,6 +174,20 @@ public:
     {
         getApp().getOPs().missingNodeInLedger (refNum);
     }
+
+    void
+    on_flush (int nodes, std::chrono::milliseconds elapsed) override
+    {
+        flush_.notify (elapsed);
+        flushed_.increment (nodes);
+    }
+
+    void
+    schedule_task (std::function <void()> task) override
+    {
+        getApp().getJobQueue ().addJob (jtWRITE, "SHAMap::flush",
+            [task] (Job&) { task (); });
+    }
 };
 
 } // detail
@@ -291,6 +312,8 @@ public:
     std::unique_ptr <DatabaseCon> mTxnDB;
     std::unique_ptr <DatabaseCon> mLedgerDB;
     std::unique_ptr <DatabaseCon> mWalletDB;
+    // Declared after the databases its statements are prepared on
+    std::unique_ptr <LedgerSQLWriter> mLedgerSQLWriter;
     std::unique_ptr <Overlay> m_overlay;
     std::vector <std::unique_ptr<beast::Stoppable>> websocketServers_;
 
@@ -620,6 +643,11 @@ public:
         assert (mWalletDB.get() != nullptr);
         return *mWalletDB;
     }
+    LedgerSQLWriter& getLedgerSQLWriter ()
+    {
+        assert (mLedgerSQLWriter.get() != nullptr);
+        return *mLedgerSQLWriter;
+    }
 
     bool isShutdown ()
     {
@@ -636,6 +664,7 @@ public:
         assert (mWalletDB.get () == nullptr);
 
         DatabaseCon::Setup setup = setup_DatabaseCon (getConfig());
+        setup.collector = m_collectorManager->group ("sqlite");
         mRpcDB = std::make_unique <DatabaseCon> (setup, "rpc.db", RpcDBInit,
                 RpcDBCount);
         mTxnDB = std::make_unique <DatabaseCon> (setup, "transaction.db",
@@ -644,6 +673,8 @@ public:
                 LedgerDBInit, LedgerDBCount);
         mWalletDB = std::make_unique <DatabaseCon> (setup, "wallet.db",
                 WalletDBInit, WalletDBCount);
+        mLedgerSQLWriter = std::make_unique <LedgerSQLWriter> (
+            *mLedgerDB, *mTxnDB);
 
         return
             mRpcDB.get() != nullptr &&
@@ -757,7 +788,7 @@ public:
         else
             startNewLedger ();
 
-        m_orderBookDB.setup (getApp().getLedgerMaster ().getCurrentLedger ());
+        m_orderBookDB.setup (getApp().getLedgerMaster ().getClosedLedger ());
 
         // Begin validation and ip maintenance.
         //
@@ -50,6 +50,7 @@ class UniqueNodeList;
 class JobQueue;
 class InboundLedgers;
 class LedgerMaster;
+class LedgerSQLWriter;
 class LoadManager;
 class NetworkOPs;
 class OrderBookDB;
@@ -127,6 +128,9 @@ public:
     virtual DatabaseCon& getTxnDB () = 0;
     virtual DatabaseCon& getLedgerDB () = 0;
 
+    /** The prepared statements that save validated ledgers. */
+    virtual LedgerSQLWriter& getLedgerSQLWriter () = 0;
+
     virtual std::chrono::milliseconds getIOLatency () = 0;
 
     /** Retrieve the "wallet database"
@@ -0,0 +1,125 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/misc/AccountTxPaging.h>
+#include <ripple/app/data/SqliteDatabase.h>
+#include <ripple/protocol/JsonFields.h>
+
+namespace ripple {
+
+void
+accountTxPage (
+    Database& db,
+    RippleAddress const& account,
+    std::int32_t minLedger,
+    std::int32_t maxLedger,
+    bool forward,
+    Json::Value& token,
+    std::uint32_t numberOfResults,
+    std::function <void (std::uint32_t, std::string const&,
+        Blob const&, Blob const&)> const& onTransaction,
+    beast::Journal journal)
+{
+    std::uint32_t findLedger = 0, findSeq = 0;
+
+    if (token.isObject ())
+    {
+        try
+        {
+            if (!token.isMember(jss::ledger) || !token.isMember(jss::seq))
+                return;
+            findLedger = token[jss::ledger].asInt();
+            findSeq = token[jss::seq].asInt();
+        }
+        catch (...)
+        {
+            return;
+        }
+    }
+
+    // ST NOTE We're using the token reference both for passing inputs and
+    //         outputs, so we need to clear it in between.
+    token = Json::nullValue;
+
+    // The marker is the first row of the page. Seeking to it through
+    // AcctTxIndex skips the rows before it, instead of reading them all
+    // again on every page. Without a marker, no row has LedgerSeq 0.
+    static char const* const forwardSQL =
+        "SELECT AccountTransactions.LedgerSeq,AccountTransactions.TxnSeq,"
+        "Status,RawTxn,TxnMeta "
+        "FROM AccountTransactions INDEXED BY AcctTxIndex "
+        "INNER JOIN Transactions "
+        "ON Transactions.TransID = AccountTransactions.TransID "
+        "WHERE AccountTransactions.Account = ? "
+        "AND AccountTransactions.LedgerSeq BETWEEN ? AND ? "
+        "AND (AccountTransactions.LedgerSeq <> ? "
+        "OR AccountTransactions.TxnSeq >= ?) "
+        "ORDER BY AccountTransactions.LedgerSeq ASC, "
+        "AccountTransactions.TxnSeq ASC, AccountTransactions.TransID ASC "
+        "LIMIT ?;";
+
+    static char const* const backwardSQL =
+        "SELECT AccountTransactions.LedgerSeq,AccountTransactions.TxnSeq,"
+        "Status,RawTxn,TxnMeta "
+        "FROM AccountTransactions INDEXED BY AcctTxIndex "
+        "INNER JOIN Transactions "
+        "ON Transactions.TransID = AccountTransactions.TransID "
+        "WHERE AccountTransactions.Account = ? "
+        "AND AccountTransactions.LedgerSeq BETWEEN ? AND ? "
+        "AND (AccountTransactions.LedgerSeq <> ? "
+        "OR AccountTransactions.TxnSeq <= ?) "
+        "ORDER BY AccountTransactions.LedgerSeq DESC, "
+        "AccountTransactions.TxnSeq DESC, AccountTransactions.TransID DESC "
+        "LIMIT ?;";
+
+    SqliteStatement pSt (db.getSqliteDB (),
+        forward ? forwardSQL : backwardSQL);
+
+    pSt.bind (1, account.humanAccountID ());
+    pSt.bind (2, static_cast<std::uint32_t> (
+        (forward && (findLedger != 0)) ? findLedger : minLedger));
+    pSt.bind (3, static_cast<std::uint32_t> (
+        (!forward && (findLedger != 0)) ? findLedger : maxLedger));
+    pSt.bind (4, findLedger);
+    pSt.bind (5, findSeq);
+    pSt.bind (6, numberOfResults + 1);
+
+    int iRet;
+    while (pSt.isRow (iRet = pSt.step ()))
+    {
+        if (numberOfResults == 0)
+        {
+            token = Json::objectValue;
+            token[jss::ledger] = pSt.getUInt32 (0);
+            token[jss::seq] = pSt.getUInt32 (1);
+            break;
+        }
+
+        onTransaction (pSt.getUInt32 (0), pSt.getString (2),
+            pSt.getBlob (3), pSt.getBlob (4));
+        --numberOfResults;
+    }
+
+    if (pSt.isError (iRet))
+        journal.warning << "account_tx query failed: " <<
+            pSt.getError (iRet);
+}
+
+} // ripple
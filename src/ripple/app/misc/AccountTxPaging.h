@@ -0,0 +1,63 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_MISC_ACCOUNTTXPAGING_H_INCLUDED
+#define RIPPLE_APP_MISC_ACCOUNTTXPAGING_H_INCLUDED
+
+#include <ripple/app/data/Database.h>
+#include <ripple/basics/Blob.h>
+#include <ripple/json/json_value.h>
+#include <ripple/protocol/RippleAddress.h>
+#include <beast/utility/Journal.h>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace ripple {
+
+/** Reads one page of an account's transactions from the transaction database.
+
+    The marker in token is the (ledger, seq) of the first row of the page.
+    It replaces the end of the ledger range the page starts from: minLedger
+    when paging forward, maxLedger when paging backward. Without a marker
+    the page starts at that end of the range.
+
+    On return token holds the marker for the next page, or is null if no
+    rows remain. A malformed marker reads nothing and is left in token.
+
+    @param onTransaction Called for each row of the page, in page order,
+                         with the row's ledger sequence, status, raw
+                         transaction and raw metadata.
+*/
+void
+accountTxPage (
+    Database& db,
+    RippleAddress const& account,
+    std::int32_t minLedger,
+    std::int32_t maxLedger,
+    bool forward,
+    Json::Value& token,
+    std::uint32_t numberOfResults,
+    std::function <void (std::uint32_t, std::string const&,
+        Blob const&, Blob const&)> const& onTransaction,
+    beast::Journal journal);
+
+} // ripple
+
+#endif
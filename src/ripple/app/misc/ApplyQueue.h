@@ -0,0 +1,128 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_MISC_APPLYQUEUE_H_INCLUDED
+#define RIPPLE_APP_MISC_APPLYQUEUE_H_INCLUDED
+
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+/** Applies items submitted from many threads in batches.
+
+    A thread submits an item, then acquires a lock supplied by the caller,
+    such as the master lock. The first thread to get the lock takes every
+    waiting item and passes them all to the handler in one call, still
+    holding the lock. Threads whose items were taken that way find them
+    applied once they get the lock and return at once. The expensive part
+    of the handler's work is then done once per batch instead of once per
+    item.
+
+    Because every thread acquires the lock itself before it can apply or
+    wait for anything, a caller may already hold the lock if it is
+    recursive.
+
+    Items are applied in the order they were submitted.
+
+    @tparam Item The type of a submitted item. Items are referenced by
+                 pointer and must stay valid until apply returns.
+*/
+template <class Item>
+class ApplyQueue
+{
+public:
+    typedef std::vector <Item*> Batch;
+
+    ApplyQueue () = default;
+    ApplyQueue (ApplyQueue const&) = delete;
+    ApplyQueue& operator= (ApplyQueue const&) = delete;
+
+    /** Submit an item and return once it has been applied.
+
+        The handler is called with signature void (Batch&) while mutex is
+        held. It may be called on this thread for items submitted by other
+        threads. If the handler throws, the exception is rethrown on every
+        thread whose item was in the batch.
+    */
+    template <class Mutex, class Handler>
+    void apply (Item& item, Mutex& mutex, Handler&& handler)
+    {
+        std::shared_ptr <Pending> pending;
+        {
+            std::lock_guard <std::mutex> lock (m_mutex);
+            if (! m_pending)
+                m_pending = std::make_shared <Pending> ();
+            m_pending->items.push_back (&item);
+            pending = m_pending;
+        }
+
+        {
+            std::lock_guard <Mutex> lock (mutex);
+
+            // Whoever took the batch held the lock until it was applied,
+            // so the batch is either applied already or ours to apply.
+            if (! pending->done)
+            {
+                {
+                    std::lock_guard <std::mutex> lock (m_mutex);
+                    m_pending.reset ();
+                }
+
+                try
+                {
+                    handler (pending->items);
+                }
+                catch (...)
+                {
+                    pending->error = std::current_exception ();
+                }
+                pending->done = true;
+            }
+        }
+
+        if (pending->error)
+            std::rethrow_exception (pending->error);
+    }
+
+    /** Returns the number of items waiting for the next batch. */
+    std::size_t size () const
+    {
+        std::lock_guard <std::mutex> lock (m_mutex);
+        return m_pending ? m_pending->items.size () : 0;
+    }
+
+private:
+    // A batch and its outcome, shared by the threads that submitted to it
+    struct Pending
+    {
+        Batch items;
+        bool done = false;
+        std::exception_ptr error;
+    };
+
+    std::mutex mutable m_mutex;
+    std::shared_ptr <Pending> m_pending;
+};
+
+} // ripple
+
+#endif
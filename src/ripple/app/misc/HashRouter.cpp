@@ -22,8 +22,10 @@
 #include <ripple/basics/CountedObject.h>
 #include <ripple/basics/UnorderedContainers.h>
 #include <ripple/basics/UptimeTimer.h>
-#include <map>
+#include <algorithm>
+#include <array>
 #include <mutex>
+#include <vector>
 
 namespace ripple {
 
@@ -93,6 +95,13 @@ public:
     explicit HashRouter (int holdTime)
         : mHoldTime (holdTime)
     {
+        int const now = UptimeTimer::getInstance ().getElapsedSeconds ();
+
+        for (auto& shard : mShards)
+        {
+            shard.wheel.resize (std::max (holdTime, 1));
+            shard.swept = now;
+        }
     }
 
     bool addSuppression (uint256 const& index);
@@ -106,30 +115,80 @@ public:
     bool swapSet (uint256 const& index, std::set<PeerShortID>& peers, int flag);
 
 private:
-    Entry getEntry (uint256 const& );
-
-    Entry& findCreateEntry (uint256 const& , bool& created);
-
     using LockType = std::mutex;
     using ScopedLockType = std::lock_guard <LockType>;
-    LockType mLock;
 
-    // Stores all suppressed hashes and their expiration time
-    hash_map <uint256, Entry> mSuppressionMap;
+    /** One independently locked slice of the suppression table.
+
+        Hashes are spread over the shards by their first byte, so peers
+        relaying different messages rarely wait on each other.
+
+        Expiration uses a time wheel with one slot per second of hold
+        time: a hash is appended to the slot for the second it was
+        created, and that slot is emptied, and its hashes erased, when
+        the wheel comes back around to it mHoldTime seconds later.
+    */
+    struct Shard
+    {
+        LockType lock;
+
+        // All suppressed hashes in this shard
+        hash_map <uint256, Entry> entries;
+
+        // Hashes created in each second, indexed by second % wheel.size()
+        std::vector <std::vector <uint256>> wheel;
+
+        // The last second whose slot has been reclaimed
+        int swept;
+    };
+
+    // Must be a power of two
+    static std::size_t const shardCount = 32;
+
+    Shard& getShard (uint256 const& index)
+    {
+        return mShards[*index.begin () & (shardCount - 1)];
+    }
+
+    Entry& findCreateEntry (Shard&, uint256 const& , bool& created);
+
+    void expire (Shard&, int now);
 
-    // Stores all expiration times and the hashes indexed for them
-    std::map< int, std::list<uint256> > mSuppressionTimes;
+    std::array <Shard, shardCount> mShards;
 
     int mHoldTime;
 };
 
 //------------------------------------------------------------------------------
 
-HashRouter::Entry& HashRouter::findCreateEntry (uint256 const& index, bool& created)
+void HashRouter::expire (Shard& shard, int now)
 {
-    hash_map<uint256, Entry>::iterator fit = mSuppressionMap.find (index);
+    auto const size = static_cast<int> (shard.wheel.size ());
 
-    if (fit != mSuppressionMap.end ())
+    // After a full turn every slot has been emptied once, so there is
+    // no need to walk the wheel again for a longer gap.
+    if (now - shard.swept > size)
+        shard.swept = now - size;
+
+    while (shard.swept < now)
+    {
+        ++shard.swept;
+
+        auto& slot = shard.wheel[shard.swept % size];
+
+        for (auto const& index : slot)
+            shard.entries.erase (index);
+
+        slot.clear ();
+    }
+}
+
+HashRouter::Entry& HashRouter::findCreateEntry (
+    Shard& shard, uint256 const& index, bool& created)
+{
+    auto fit = shard.entries.find (index);
+
+    if (fit != shard.entries.end ())
     {
         created = false;
         return fit->second;
@@ -137,55 +196,41 @@ HashRouter::Entry& HashRouter::findCreateEntry (uint256 const& index, bool& crea
 
     created = true;
 
-    int now = UptimeTimer::getInstance ().getElapsedSeconds ();
-    int expireTime = now - mHoldTime;
+    int const now = UptimeTimer::getInstance ().getElapsedSeconds ();
 
-    // See if any supressions need to be expired
-    std::map< int, std::list<uint256> >::iterator it = mSuppressionTimes.begin ();
+    expire (shard, now);
 
-    if ((it != mSuppressionTimes.end ()) && (it->first <= expireTime))
-    {
-        for(auto const& lit : it->second)
-            mSuppressionMap.erase (lit);
-        mSuppressionTimes.erase (it);
-    }
-
-    mSuppressionTimes[now].push_back (index);
-    return mSuppressionMap.emplace (index, Entry ()).first->second;
+    shard.wheel[now % shard.wheel.size ()].push_back (index);
+    return shard.entries.emplace (index, Entry ()).first->second;
 }
 
 bool HashRouter::addSuppression (uint256 const& index)
 {
-    ScopedLockType sl (mLock);
+    Shard& shard = getShard (index);
+    ScopedLockType sl (shard.lock);
 
     bool created;
-    findCreateEntry (index, created);
+    findCreateEntry (shard, index, created);
     return created;
 }
 
-HashRouter::Entry HashRouter::getEntry (uint256 const& index)
-{
-    ScopedLockType sl (mLock);
-
-    bool created;
-    return findCreateEntry (index, created);
-}
-
 bool HashRouter::addSuppressionPeer (uint256 const& index, PeerShortID peer)
 {
-    ScopedLockType sl (mLock);
+    Shard& shard = getShard (index);
+    ScopedLockType sl (shard.lock);
 
     bool created;
-    findCreateEntry (index, created).addPeer (peer);
+    findCreateEntry (shard, index, created).addPeer (peer);
     return created;
 }
 
 bool HashRouter::addSuppressionPeer (uint256 const& index, PeerShortID peer, int& flags)
 {
-    ScopedLockType sl (mLock);
+    Shard& shard = getShard (index);
+    ScopedLockType sl (shard.lock);
 
     bool created;
-    Entry& s = findCreateEntry (index, created);
+    Entry& s = findCreateEntry (shard, index, created);
     s.addPeer (peer);
     flags = s.getFlags ();
     return created;
@@ -193,18 +238,20 @@ bool HashRouter::addSuppressionPeer (uint256 const& index, PeerShortID peer, int
 
 int HashRouter::getFlags (uint256 const& index)
 {
-    ScopedLockType sl (mLock);
+    Shard& shard = getShard (index);
+    ScopedLockType sl (shard.lock);
 
     bool created;
-    return findCreateEntry (index, created).getFlags ();
+    return findCreateEntry (shard, index, created).getFlags ();
 }
 
 bool HashRouter::addSuppressionFlags (uint256 const& index, int flag)
 {
-    ScopedLockType sl (mLock);
+    Shard& shard = getShard (index);
+    ScopedLockType sl (shard.lock);
 
     bool created;
-    findCreateEntry (index, created).setFlag (flag);
+    findCreateEntry (shard, index, created).setFlag (flag);
     return created;
 }
 
@@ -217,10 +264,11 @@ bool HashRouter::setFlag (uint256 const& index, int flag)
     // return: true = changed, false = unchanged
     assert (flag != 0);
 
-    ScopedLockType sl (mLock);
+    Shard& shard = getShard (index);
+    ScopedLockType sl (shard.lock);
 
     bool created;
-    Entry& s = findCreateEntry (index, created);
+    Entry& s = findCreateEntry (shard, index, created);
 
     if ((s.getFlags () & flag) == flag)
         return false;
@@ -231,10 +279,11 @@ bool HashRouter::setFlag (uint256 const& index, int flag)
 
 bool HashRouter::swapSet (uint256 const& index, std::set<PeerShortID>& peers, int flag)
 {
-    ScopedLockType sl (mLock);
+    Shard& shard = getShard (index);
+    ScopedLockType sl (shard.lock);
 
     bool created;
-    Entry& s = findCreateEntry (index, created);
+    Entry& s = findCreateEntry (shard, index, created);
 
     if ((s.getFlags () & flag) == flag)
         return false;
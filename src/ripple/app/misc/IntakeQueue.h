@@ -0,0 +1,184 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_MISC_INTAKEQUEUE_H_INCLUDED
+#define RIPPLE_APP_MISC_INTAKEQUEUE_H_INCLUDED
+
+#include <ripple/basics/UnorderedContainers.h>
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace ripple {
+
+/** A bounded queue of items ordered by fee level and arrival.
+
+    Items are removed highest fee level first and, among equal levels,
+    in the order they arrived. Each key, typically the sending account,
+    may hold at most a fixed number of items, so that one sender cannot
+    fill the queue. When the queue is full a new item replaces the
+    lowest ranked one if it pays a strictly higher level, and is dropped
+    otherwise.
+
+    The queue is not synchronized; callers provide their own locking.
+
+    @tparam Key  Identifies the sender of an item.
+    @tparam Item The type of a queued item.
+*/
+template <class Key, class Item, class Hash = beast::uhash<>>
+class IntakeQueue
+{
+public:
+    IntakeQueue (std::size_t capacity, std::size_t perKey)
+        : m_capacity (capacity)
+        , m_perKey (perKey)
+        , m_arrivals (0)
+        , m_dropped (0)
+    {
+    }
+
+    IntakeQueue (IntakeQueue const&) = delete;
+    IntakeQueue& operator= (IntakeQueue const&) = delete;
+
+    /** Add an item.
+
+        The handler is called with signature void (Item&) for the item
+        dropped to make room, or for `item` itself if it was not queued.
+
+        @return `true` if the item was queued, `false` if it was dropped
+                because its key or the queue is full.
+    */
+    template <class Handler>
+    bool push (Key const& key, std::uint64_t level, Item item,
+        Handler&& onDropped)
+    {
+        auto const count = m_counts.find (key);
+
+        if ((count != m_counts.end ()) && (count->second >= m_perKey))
+        {
+            ++m_dropped;
+            onDropped (item);
+            return false;
+        }
+
+        Rank const rank {level, m_arrivals++};
+
+        if (m_entries.size () >= m_capacity)
+        {
+            if (m_entries.empty () || !Order () (rank, m_entries.rbegin ()->first))
+            {
+                ++m_dropped;
+                onDropped (item);
+                return false;
+            }
+
+            // Make room by dropping the lowest ranked item
+            auto const last = std::prev (m_entries.end ());
+            release (last->second.first);
+            ++m_dropped;
+            onDropped (last->second.second);
+            m_entries.erase (last);
+        }
+
+        ++m_counts[key];
+        m_entries.emplace (rank, std::make_pair (key, std::move (item)));
+        return true;
+    }
+
+    bool push (Key const& key, std::uint64_t level, Item item)
+    {
+        return push (key, level, std::move (item), [](Item&) { });
+    }
+
+    /** Remove up to `max` items, best ranked first. */
+    std::vector <Item> pop (std::size_t max)
+    {
+        std::vector <Item> items;
+        items.reserve (std::min (max, m_entries.size ()));
+
+        while (!m_entries.empty () && (items.size () < max))
+        {
+            auto const first = m_entries.begin ();
+            release (first->second.first);
+            items.push_back (std::move (first->second.second));
+            m_entries.erase (first);
+        }
+
+        return items;
+    }
+
+    /** Returns the number of items waiting. */
+    std::size_t size () const
+    {
+        return m_entries.size ();
+    }
+
+    bool empty () const
+    {
+        return m_entries.empty ();
+    }
+
+    std::size_t capacity () const
+    {
+        return m_capacity;
+    }
+
+    /** Returns the number of items dropped or replaced since construction. */
+    std::uint64_t dropped () const
+    {
+        return m_dropped;
+    }
+
+private:
+    // Fee level and arrival number
+    typedef std::pair <std::uint64_t, std::uint64_t> Rank;
+
+    // Higher levels first, then earlier arrivals
+    struct Order
+    {
+        bool operator() (Rank const& lhs, Rank const& rhs) const
+        {
+            if (lhs.first != rhs.first)
+                return lhs.first > rhs.first;
+            return lhs.second < rhs.second;
+        }
+    };
+
+    void release (Key const& key)
+    {
+        auto const iter = m_counts.find (key);
+
+        if (--iter->second == 0)
+            m_counts.erase (iter);
+    }
+
+    std::size_t const m_capacity;
+    std::size_t const m_perKey;
+    std::map <Rank, std::pair <Key, Item>, Order> m_entries;
+    hash_map <Key, std::size_t, Hash> m_counts;
+    std::uint64_t m_arrivals;
+    std::uint64_t m_dropped;
+};
+
+} // ripple
+
+#endif
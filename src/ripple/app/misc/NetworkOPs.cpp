@@ -21,7 +21,10 @@
 #include <ripple/app/book/Quality.h>
 #include <ripple/app/consensus/LedgerConsensus.h>
 #include <ripple/app/data/DatabaseCon.h>
+#include <ripple/app/data/SqliteDatabase.h>
 #include <ripple/app/main/Application.h>
+#include <ripple/app/misc/AccountTxPaging.h>
+#include <ripple/app/misc/ApplyQueue.h>
 #include <ripple/app/misc/FeeVote.h>
 #include <ripple/app/ledger/AcceptedLedger.h>
 #include <ripple/app/ledger/InboundLedger.h>
@@ -33,11 +36,13 @@
 #include <ripple/app/main/LoadManager.h>
 #include <ripple/app/main/LocalCredentials.h>
 #include <ripple/app/misc/IHashRouter.h>
+#include <ripple/app/misc/IntakeQueue.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/app/misc/Validations.h>
 #include <ripple/app/peers/ClusterNodeStatus.h>
 #include <ripple/app/peers/UniqueNodeList.h>
 #include <ripple/app/tx/TransactionMaster.h>
+#include <ripple/basics/DecayingSample.h>
 #include <ripple/basics/Log.h>
 #include <ripple/basics/Time.h>
 #include <ripple/basics/StringUtilities.h>
@@ -64,6 +69,13 @@
 
 namespace ripple {
 
+// Relayed transactions held for the open ledger, in total and per account
+static std::size_t const txQueueCapacity = 2000;
+static std::size_t const txQueuePerAccount = 10;
+
+// Relayed transactions applied to the open ledger at a time
+static std::size_t const txQueueBatch = 256;
+
 class NetworkOPsImp
     : public NetworkOPs
     , public beast::DeadlineTimer::Listener
@@ -107,6 +119,9 @@ public:
         , mFetchSeq (0)
         , mLastLoadBase (256)
         , mLastLoadFactor (256)
+        , mTxQueue (txQueueCapacity, txQueuePerAccount)
+        , mTxQueuePending (false)
+        , mTxQueueApplied (std::chrono::steady_clock::now ())
         , m_job_queue (job_queue)
         , m_standalone (standalone)
         , m_network_quorum (network_quorum)
@@ -215,6 +230,11 @@ public:
         Job&, STTx::pointer,
         stCallback callback = stCallback ());
 
+    bool queueTransaction (STTx::pointer const& stx, int flags,
+        std::weak_ptr <Peer> const& peer) override;
+    void applyQueuedTransactions (Job&);
+    Json::Value getTransactionQueueJson () override;
+
     Transaction::pointer submitTransactionSync (
         Transaction::ref tpTrans,
         bool bAdmin, bool bLocal, bool bFailHard, bool bSubmit);
@@ -527,6 +547,17 @@ private:
         Ledger::ref lpCurrent, const AcceptedLedgerTx& alTransaction,
         bool isAccepted);
 
+    typedef std::vector <InfoSub::pointer> Subscribers;
+
+    // Appends the live subscribers in subMap to subs, dropping expired ones.
+    // The caller must hold mLock.
+    static void collectSubscribers (SubMapType& subMap, Subscribers& subs);
+
+    // Serializes jvObj once and sends it to each subscriber.
+    // Must not be called with mLock held.
+    static void sendToSubscribers (
+        Subscribers const& subs, Json::Value const& jvObj);
+
     void pubServer ();
 
     std::string getHostId (bool forAdmin);
@@ -596,6 +627,59 @@ private:
     std::uint32_t mLastLoadBase;
     std::uint32_t mLastLoadFactor;
 
+    // A transaction waiting to be applied to the open ledger
+    struct TransactionStatus
+    {
+        Transaction::pointer transaction;
+        bool admin;
+        bool local;
+        bool failHard;
+        stCallback callback;
+        TER result;
+        bool relay;
+
+        TransactionStatus (Transaction::pointer t,
+                bool a, bool l, bool f, stCallback cb)
+            : transaction (std::move (t))
+            , admin (a)
+            , local (l)
+            , failHard (f)
+            , callback (std::move (cb))
+            , result (tefEXCEPTION)
+            , relay (false)
+        {
+        }
+    };
+
+    void applyTransactions (ApplyQueue <TransactionStatus>::Batch& batch);
+    void relayTransaction (Transaction::ref trans);
+
+    // Transactions are applied to the open ledger in batches, so that
+    // concurrent submissions are applied in one pass under the master lock.
+    ApplyQueue <TransactionStatus> mApplyQueue;
+
+    // A relayed transaction waiting for the open ledger
+    struct QueuedTransaction
+    {
+        STTx::pointer stx;
+        int flags;
+        std::weak_ptr <Peer> peer;
+    };
+
+    // Returns the number of transactions applied and sets failure if
+    // any of them hit tefFAILURE
+    std::size_t applyQueuedBatch (
+        std::vector <QueuedTransaction> const& queued, bool& failure);
+
+    // Clears mTxQueuePending, or schedules the next batch if any remain
+    void finishQueuedTransactions (std::size_t applied);
+
+    // Relayed transactions, applied in batches highest fee first
+    std::mutex mTxQueueLock;
+    IntakeQueue <Account, QueuedTransaction> mTxQueue;
+    bool mTxQueuePending;
+    DecayingSample <10, std::chrono::steady_clock> mTxQueueApplied;
+
     JobQueue& m_job_queue;
 
     // Whether we are in standalone mode
@@ -936,6 +1020,191 @@ void NetworkOPsImp::submitTransaction (
                    callback));
 }
 
+bool NetworkOPsImp::queueTransaction (STTx::pointer const& stx, int flags,
+    std::weak_ptr <Peer> const& peer)
+{
+    // Every transaction type costs the same number of fee units, so the
+    // fee paid orders them by fee level.
+    std::uint64_t const level = stx->getTransactionFee ().isNative () ?
+        stx->getTransactionFee ().getNValue () : 0;
+
+    std::lock_guard <std::mutex> sl (mTxQueueLock);
+
+    bool const queued = mTxQueue.push (
+        stx->getSourceAccount ().getAccountID (), level,
+        QueuedTransaction {stx, flags, peer},
+        [](QueuedTransaction& dropped)
+        {
+            // Let a later relay of the transaction through
+            getApp().getHashRouter ().setFlag (
+                dropped.stx->getTransactionID (), SF_RETRY);
+        });
+
+    if (queued && !mTxQueuePending)
+    {
+        mTxQueuePending = true;
+        m_job_queue.addJob (jtTRANSACTION, "applyQueuedTransactions",
+            std::bind (&NetworkOPsImp::applyQueuedTransactions, this,
+                std::placeholders::_1));
+    }
+
+    return queued;
+}
+
+void NetworkOPsImp::applyQueuedTransactions (Job&)
+{
+    std::vector <QueuedTransaction> queued;
+    std::size_t applied = 0;
+    bool failure = false;
+
+    try
+    {
+        {
+            std::lock_guard <std::mutex> sl (mTxQueueLock);
+            queued = mTxQueue.pop (txQueueBatch);
+        }
+
+        applied = applyQueuedBatch (queued, failure);
+    }
+    catch (...)
+    {
+        // Let later relays of the batch through, and keep draining
+        for (auto const& q : queued)
+            getApp().getHashRouter ().setFlag (
+                q.stx->getTransactionID (), SF_RETRY);
+
+        finishQueuedTransactions (0);
+        throw;
+    }
+
+    finishQueuedTransactions (applied);
+
+    if (failure)
+        throw Fault (IO_ERROR);
+}
+
+std::size_t NetworkOPsImp::applyQueuedBatch (
+    std::vector <QueuedTransaction> const& queued, bool& failure)
+{
+    auto& router = getApp().getHashRouter ();
+
+    // Signatures not checked by a trusted source are verified together
+    std::vector <STTx::pointer> unchecked;
+    for (auto const& q : queued)
+    {
+        if (!(q.flags & SF_SIGGOOD))
+            unchecked.push_back (q.stx);
+    }
+    checkSigns (unchecked);
+
+    std::uint32_t const validSeq = m_ledgerMaster.getValidLedgerIndex ();
+
+    std::vector <TransactionStatus> statuses;
+    statuses.reserve (queued.size ());
+
+    for (auto const& q : queued)
+    {
+        STTx::ref stx = q.stx;
+
+        auto const charge = [&q](Resource::Charge const& fee)
+        {
+            if (auto peer = q.peer.lock ())
+                peer->charge (fee);
+        };
+
+        try
+        {
+            // Expired?
+            if (stx->isFieldPresent (sfLastLedgerSequence) &&
+                (stx->getFieldU32 (sfLastLedgerSequence) < validSeq))
+            {
+                router.setFlag (stx->getTransactionID (), SF_BAD);
+                charge (Resource::feeUnwantedData);
+                continue;
+            }
+
+            auto tx = std::make_shared<Transaction> (stx, Validate::NO);
+
+            if ((tx->getStatus () == INVALID) || (!(q.flags & SF_SIGGOOD) &&
+                !(passesLocalChecks (*stx) && stx->isKnownGood ())))
+            {
+                router.setFlag (stx->getTransactionID (), SF_BAD);
+                charge (Resource::feeInvalidSignature);
+                continue;
+            }
+
+            router.setFlag (stx->getTransactionID (), SF_SIGGOOD);
+
+            bool const trusted (q.flags & SF_TRUSTED);
+            statuses.emplace_back (std::move (tx), trusted, false, false,
+                stCallback ());
+        }
+        catch (...)
+        {
+            router.setFlag (stx->getTransactionID (), SF_BAD);
+            charge (Resource::feeInvalidRequest);
+        }
+    }
+
+    if (!statuses.empty ())
+    {
+        auto ev = m_job_queue.getLoadEventAP (jtTXN_PROC, "ProcessTXN");
+
+        ApplyQueue <TransactionStatus>::Batch batch;
+        batch.reserve (statuses.size ());
+        for (auto& status : statuses)
+            batch.push_back (&status);
+
+        applyTransactions (batch);
+    }
+
+    for (auto const& status : statuses)
+    {
+        if (status.relay)
+            relayTransaction (status.transaction);
+    }
+
+    std::size_t applied = 0;
+    for (auto const& status : statuses)
+    {
+        if (status.result == tesSUCCESS)
+            ++applied;
+        else if (status.result == tefFAILURE)
+            failure = true;
+    }
+
+    return applied;
+}
+
+void NetworkOPsImp::finishQueuedTransactions (std::size_t applied)
+{
+    std::lock_guard <std::mutex> sl (mTxQueueLock);
+
+    mTxQueueApplied.add (applied, std::chrono::steady_clock::now ());
+
+    if (mTxQueue.empty ())
+        mTxQueuePending = false;
+    else
+        m_job_queue.addJob (jtTRANSACTION, "applyQueuedTransactions",
+            std::bind (&NetworkOPsImp::applyQueuedTransactions, this,
+                std::placeholders::_1));
+}
+
+Json::Value NetworkOPsImp::getTransactionQueueJson ()
+{
+    Json::Value ret (Json::objectValue);
+
+    std::lock_guard <std::mutex> sl (mTxQueueLock);
+
+    ret[jss::queued] = static_cast<Json::UInt> (mTxQueue.size ());
+    ret[jss::capacity] = static_cast<Json::UInt> (mTxQueue.capacity ());
+    ret[jss::dropped] = static_cast<Json::UInt> (mTxQueue.dropped ());
+    ret[jss::applied_per_second] = static_cast<Json::UInt> (
+        mTxQueueApplied.value (std::chrono::steady_clock::now ()));
+
+    return ret;
+}
+
 // Sterilize transaction through serialization.
 // This is fully synchronous and deprecated
 Transaction::pointer NetworkOPsImp::submitTransactionSync (
@@ -1004,100 +1273,142 @@ Transaction::pointer NetworkOPsImp::processTransactionCb (
         getApp().getHashRouter ().setFlag (trans->getID (), SF_SIGGOOD);
     }
 
+    TransactionStatus status (trans, bAdmin, bLocal, bFailHard, callback);
+
+    mApplyQueue.apply (status, getApp().getMasterLock (),
+        [this](ApplyQueue <TransactionStatus>::Batch& batch)
+        {
+            applyTransactions (batch);
+        });
+
+    if (status.result == tefFAILURE)
+        throw Fault (IO_ERROR);
+
+    if (status.relay)
+        relayTransaction (status.transaction);
+
+    return status.transaction;
+}
+
+// Applies a batch of transactions to the open ledger while holding the
+// master lock once, and marks the ones that should be relayed. Callers
+// relay them after the master lock is released.
+void NetworkOPsImp::applyTransactions (
+    ApplyQueue <TransactionStatus>::Batch& batch)
+{
+    std::vector <LedgerMaster::OpenTransaction> txns;
+    txns.reserve (batch.size ());
+
+    for (auto const e : batch)
+    {
+        txns.push_back ({e->transaction->getSTransaction (),
+            e->admin ? (tapOPEN_LEDGER | tapNO_CHECK_SIGN | tapADMIN)
+            : (tapOPEN_LEDGER | tapNO_CHECK_SIGN), tefEXCEPTION, false});
+    }
+
     {
         auto lock = getApp().masterLock();
 
-        bool didApply;
-        TER r = m_ledgerMaster.doTransaction (
-            trans->getSTransaction (),
-            bAdmin ? (tapOPEN_LEDGER | tapNO_CHECK_SIGN | tapADMIN)
-            : (tapOPEN_LEDGER | tapNO_CHECK_SIGN), didApply);
-        trans->setResult (r);
+        m_ledgerMaster.doTransactions (txns);
 
-        if (isTemMalformed (r)) // malformed, cache bad
-            getApp().getHashRouter ().setFlag (trans->getID (), SF_BAD);
+        for (std::size_t i = 0; i < batch.size (); ++i)
+        {
+            TransactionStatus& e (*batch[i]);
+            Transaction::pointer& trans (e.transaction);
+            TER const r = txns[i].result;
+
+            e.result = r;
+            trans->setResult (r);
+
+            if (isTemMalformed (r)) // malformed, cache bad
+                getApp().getHashRouter ().setFlag (trans->getID (), SF_BAD);
 
 #ifdef BEAST_DEBUG
-        if (r != tesSUCCESS)
-        {
-            std::string token, human;
-            if (transResultInfo (r, token, human))
-                m_journal.info << "TransactionResult: "
-                               << token << ": " << human;
-        }
+            if (r != tesSUCCESS)
+            {
+                std::string token, human;
+                if (transResultInfo (r, token, human))
+                    m_journal.info << "TransactionResult: "
+                                   << token << ": " << human;
+            }
 
 #endif
 
-        if (callback)
-            callback (trans, r);
+            if (e.callback)
+                e.callback (trans, r);
 
+            // The submitting thread reports the failure
+            if (r == tefFAILURE)
+                continue;
 
-        if (r == tefFAILURE)
-            throw Fault (IO_ERROR);
+            bool addLocal = e.local;
 
-        bool addLocal = bLocal;
-
-        if (r == tesSUCCESS)
-        {
-            m_journal.info << "Transaction is now included in open ledger";
-            trans->setStatus (INCLUDED);
+            if (r == tesSUCCESS)
+            {
+                m_journal.info << "Transaction is now included in open ledger";
+                trans->setStatus (INCLUDED);
 
-            // VFALCO NOTE The value of trans can be changed here!
-            getApp().getMasterTransaction ().canonicalize (&trans);
-        }
-        else if (r == tefPAST_SEQ)
-        {
-            // duplicate or conflict
-            m_journal.info << "Transaction is obsolete";
-            trans->setStatus (OBSOLETE);
-        }
-        else if (isTerRetry (r))
-        {
-            if (bFailHard)
-                addLocal = false;
+                // VFALCO NOTE The value of trans can be changed here!
+                getApp().getMasterTransaction ().canonicalize (&trans);
+            }
+            else if (r == tefPAST_SEQ)
+            {
+                // duplicate or conflict
+                m_journal.info << "Transaction is obsolete";
+                trans->setStatus (OBSOLETE);
+            }
+            else if (isTerRetry (r))
+            {
+                if (e.failHard)
+                    addLocal = false;
+                else
+                {
+                    // transaction should be held
+                    m_journal.debug << "Transaction should be held: " << r;
+                    trans->setStatus (HELD);
+                    getApp().getMasterTransaction ().canonicalize (&trans);
+                    m_ledgerMaster.addHeldTransaction (trans);
+                }
+            }
             else
             {
-                // transaction should be held
-                m_journal.debug << "Transaction should be held: " << r;
-                trans->setStatus (HELD);
-                getApp().getMasterTransaction ().canonicalize (&trans);
-                m_ledgerMaster.addHeldTransaction (trans);
+                m_journal.debug << "Status other than success " << r;
+                trans->setStatus (INVALID);
             }
-        }
-        else
-        {
-            m_journal.debug << "Status other than success " << r;
-            trans->setStatus (INVALID);
-        }
 
-        if (addLocal)
-        {
-            addLocalTx (m_ledgerMaster.getCurrentLedger (),
-                        trans->getSTransaction ());
-        }
-
-        if (didApply || ((mMode != omFULL) && !bFailHard && bLocal))
-        {
-            std::set<Peer::id_t> peers;
+            if (addLocal)
+            {
+                addLocalTx (m_ledgerMaster.getCurrentLedger (),
+                            trans->getSTransaction ());
+            }
 
-            if (getApp().getHashRouter ().swapSet (
-                    trans->getID (), peers, SF_RELAYED))
+            if (txns[i].didApply ||
+                ((mMode != omFULL) && !e.failHard && e.local))
             {
-                protocol::TMTransaction tx;
-                Serializer s;
-                trans->getSTransaction ()->add (s);
-                tx.set_rawtransaction (&s.getData ().front (), s.getLength ());
-                tx.set_status (protocol::tsCURRENT);
-                tx.set_receivetimestamp (getNetworkTimeNC ());
-                // FIXME: This should be when we received it
-                getApp ().overlay ().foreach (send_if_not (
-                    std::make_shared<Message> (tx, protocol::mtTRANSACTION),
-                    peer_in_set(peers)));
+                e.relay = true;
             }
         }
     }
+}
+
+void NetworkOPsImp::relayTransaction (Transaction::ref trans)
+{
+    std::set<Peer::id_t> peers;
 
-    return trans;
+    if (getApp().getHashRouter ().swapSet (
+            trans->getID (), peers, SF_RELAYED))
+    {
+        protocol::TMTransaction tx;
+        Serializer s;
+        trans->getSTransaction ()->add (s);
+        tx.set_rawtransaction (&s.getData ().front (), s.getLength ());
+        tx.set_status (protocol::tsCURRENT);
+        tx.set_receivetimestamp (getNetworkTimeNC ());
+        // FIXME: This should be when we received it
+        getApp ().overlay ().foreach (send_if_not (
+            std::make_shared<Message> (tx, protocol::mtTRANSACTION),
+            peer_in_set(peers)));
+    }
 }
 
 Transaction::pointer NetworkOPsImp::findTransactionByID (
@@ -1762,17 +2073,49 @@ void NetworkOPsImp::consensusViewChange ()
         setMode (omCONNECTED);
 }
 
+void NetworkOPsImp::collectSubscribers (SubMapType& subMap, Subscribers& subs)
+{
+    subs.reserve (subs.size () + subMap.size ());
+
+    for (auto it = subMap.begin (); it != subMap.end (); )
+    {
+        InfoSub::pointer p = it->second.lock ();
+
+        if (p)
+        {
+            subs.push_back (std::move (p));
+            ++it;
+        }
+        else
+        {
+            it = subMap.erase (it);
+        }
+    }
+}
+
+void NetworkOPsImp::sendToSubscribers (
+    Subscribers const& subs, Json::Value const& jvObj)
+{
+    if (subs.empty ())
+        return;
+
+    std::string const sObj = to_string (jvObj);
+
+    for (auto const& p : subs)
+        p->send (jvObj, sObj, true);
+}
+
 void NetworkOPsImp::pubServer ()
 {
-    // VFALCO TODO Don't hold the lock across calls to send...make a copy of the
-    //             list into a local array while holding the lock then release the
-    //             lock and call send on everyone.
-    //
-    ScopedLockType sl (mLock);
+    Json::Value jvObj (Json::objectValue);
+    Subscribers subs;
 
-    if (!mSubServer.empty ())
     {
-        Json::Value jvObj (Json::objectValue);
+        ScopedLockType sl (mLock);
+
+        if (mSubServer.empty ())
+            return;
+
 
         jvObj [jss::type]          = "serverStatus";
         jvObj [jss::server_status] = strOperatingMode ();
@@ -1781,27 +2124,10 @@ void NetworkOPsImp::pubServer ()
         jvObj [jss::load_factor]   =
                 (mLastLoadFactor = getApp().getFeeTrack ().getLoadFactor ());
 
-        std::string sObj = to_string (jvObj);
-
-
-        for (auto i = mSubServer.begin (); i != mSubServer.end (); )
-        {
-            InfoSub::pointer p = i->second.lock ();
-
-            // VFALCO TODO research the possibility of using thread queues and
-            //             linearizing the deletion of subscribers with the
-            //             sending of JSON data.
-            if (p)
-            {
-                p->send (jvObj, sObj, true);
-                ++i;
-            }
-            else
-            {
-                i = mSubServer.erase (i);
-            }
-        }
+        collectSubscribers (mSubServer, subs);
     }
+
+    sendToSubscribers (subs, jvObj);
 }
 
 void NetworkOPsImp::setMode (OperatingMode om)
@@ -1933,8 +2259,8 @@ NetworkOPs::AccountTxs NetworkOPsImp::getAccountTxs (
         minLedger, maxLedger, descending, offset, limit, false, false, bAdmin);
 
     {
-        auto db = getApp().getTxnDB ().getDB ();
-        auto sl (getApp().getTxnDB ().lock ());
+        auto reader (getApp().getTxnDB ().read ("account_tx_old"));
+        auto db = reader.getDB ();
 
         SQL_FOREACH (db, sql)
         {
@@ -1988,8 +2314,8 @@ std::vector<NetworkOPsImp::txnMetaLedgerType> NetworkOPsImp::getAccountTxsB (
         bAdmin);
 
     {
-        auto db = getApp().getTxnDB ().getDB ();
-        auto sl (getApp().getTxnDB ().lock ());
+        auto reader (getApp().getTxnDB ().read ("account_tx_old"));
+        auto db = reader.getDB ();
 
         SQL_FOREACH (db, sql)
         {
@@ -2034,114 +2360,38 @@ NetworkOPsImp::AccountTxs NetworkOPsImp::getTxsAccount (
     AccountTxs ret;
 
     std::uint32_t NONBINARY_PAGE_LENGTH = 200;
-    std::uint32_t EXTRA_LENGTH = 100;
-
-    bool foundResume = token.isNull() || !token.isObject();
 
-    std::uint32_t numberOfResults, queryLimit;
+    std::uint32_t numberOfResults;
     if (limit <= 0)
         numberOfResults = NONBINARY_PAGE_LENGTH;
     else if (!bAdmin && (limit > NONBINARY_PAGE_LENGTH))
         numberOfResults = NONBINARY_PAGE_LENGTH;
     else
         numberOfResults = limit;
-    queryLimit = numberOfResults + 1 + (foundResume ? 0 : EXTRA_LENGTH);
 
-    std::uint32_t findLedger = 0, findSeq = 0;
-    if (!foundResume)
-    {
-        try
-        {
-            if (!token.isMember(jss::ledger) || !token.isMember(jss::seq))
-                return ret;
-            findLedger = token[jss::ledger].asInt();
-            findSeq = token[jss::seq].asInt();
-        }
-        catch (...)
-        {
-            return ret;
-        }
-    }
-
-    // ST NOTE We're using the token reference both for passing inputs and
-    //         outputs, so we need to clear it in between.
-    token = Json::nullValue;
-
-    std::string sql = boost::str (boost::format
-        ("SELECT AccountTransactions.LedgerSeq,AccountTransactions.TxnSeq,"
-         "Status,RawTxn,TxnMeta "
-         "FROM AccountTransactions INNER JOIN Transactions "
-         "ON Transactions.TransID = AccountTransactions.TransID "
-         "WHERE AccountTransactions.Account = '%s' "
-         "AND AccountTransactions.LedgerSeq BETWEEN '%u' AND '%u' "
-         "ORDER BY AccountTransactions.LedgerSeq %s, "
-         "AccountTransactions.TxnSeq %s, AccountTransactions.TransID %s "
-         "LIMIT %u;")
-             % account.humanAccountID()
-             % ((forward && (findLedger != 0)) ? findLedger : minLedger)
-             % ((!forward && (findLedger != 0)) ? findLedger: maxLedger)
-             % (forward ? "ASC" : "DESC")
-             % (forward ? "ASC" : "DESC")
-             % (forward ? "ASC" : "DESC")
-             % queryLimit);
-    {
-        auto db = getApp().getTxnDB ().getDB ();
-        auto sl (getApp().getTxnDB ().lock ());
+    auto reader (getApp().getTxnDB ().read ("account_tx"));
 
-        SQL_FOREACH (db, sql)
+    accountTxPage (*reader.getDB (), account, minLedger, maxLedger, forward,
+        token, numberOfResults,
+        [&](std::uint32_t ledgerSeq, std::string const& status,
+            Blob const& rawTxn, Blob const& rawMeta)
         {
-            if (!foundResume)
-            {
-                foundResume = (findLedger == db->getInt("LedgerSeq") &&
-                               findSeq == db->getInt("TxnSeq"));
-            }
-            else if (numberOfResults == 0)
-            {
-                token = Json::objectValue;
-                token[jss::ledger] = db->getInt("LedgerSeq");
-                token[jss::seq] = db->getInt("TxnSeq");
-                break;
-            }
+            auto txn = Transaction::transactionFromSQL (
+                ledgerSeq, status, rawTxn, Validate::NO);
 
-            if (foundResume)
+            if (rawMeta.empty ())
             {
-                auto txn = Transaction::transactionFromSQL (db, Validate::NO);
-
-                Serializer rawMeta;
-                int metaSize = 2048;
-                rawMeta.resize (metaSize);
-                metaSize = db->getBinary (
-                    "TxnMeta", &*rawMeta.begin (), rawMeta.getLength ());
-
-                if (metaSize > rawMeta.getLength ())
-                {
-                    rawMeta.resize (metaSize);
-                    db->getBinary (
-                        "TxnMeta", &*rawMeta.begin (), rawMeta.getLength ());
-                }
-                else
-                    rawMeta.resize (metaSize);
-
-                if (rawMeta.getLength() == 0)
-                {
-                    // Work around a bug that could leave the metadata missing
-                    auto seq = static_cast<std::uint32_t>(
-                        db->getBigInt("LedgerSeq"));
-                    m_journal.warning << "Recovering ledger " << seq
-                                      << ", txn " << txn->getID();
-                    Ledger::pointer ledger = getLedgerBySeq(seq);
-                    if (ledger)
-                        ledger->pendSaveValidated(false, false);
-                }
-
-                --numberOfResults;
-
-                ret.emplace_back (std::move (txn),
-                    std::make_shared<TransactionMetaSet> (
-                        txn->getID (), txn->getLedger (), rawMeta.getData ()));
+                // Work around a bug that could leave the metadata missing
+                m_journal.warning << "Recovering ledger " << ledgerSeq
+                                  << ", txn " << txn->getID();
+                Ledger::pointer ledger = getLedgerBySeq(ledgerSeq);
+                if (ledger)
+                    ledger->pendSaveValidated(false, false);
             }
-        }
-    }
+
+            ret.emplace_back (txn, std::make_shared<TransactionMetaSet> (
+                txn->getID (), txn->getLedger (), rawMeta));
+        }, m_journal);
 
     return ret;
 }
@@ -2154,112 +2404,24 @@ NetworkOPsImp::MetaTxsList NetworkOPsImp::getTxsAccountB (
     MetaTxsList ret;
 
     std::uint32_t BINARY_PAGE_LENGTH = 500;
-    std::uint32_t EXTRA_LENGTH = 100;
 
-    bool foundResume = token.isNull() || !token.isObject();
-
-    std::uint32_t numberOfResults, queryLimit;
+    std::uint32_t numberOfResults;
     if (limit <= 0)
         numberOfResults = BINARY_PAGE_LENGTH;
     else if (!bAdmin && (limit > BINARY_PAGE_LENGTH))
         numberOfResults = BINARY_PAGE_LENGTH;
     else
         numberOfResults = limit;
-    queryLimit = numberOfResults + 1 + (foundResume ? 0 : EXTRA_LENGTH);
-
-    std::uint32_t findLedger = 0, findSeq = 0;
-    if (!foundResume)
-    {
-        try
-        {
-            if (!token.isMember(jss::ledger) || !token.isMember(jss::seq))
-                return ret;
-            findLedger = token[jss::ledger].asInt();
-            findSeq = token[jss::seq].asInt();
-        }
-        catch (...)
-        {
-            return ret;
-        }
-    }
 
-    token = Json::nullValue;
-
-    std::string sql = boost::str (boost::format
-        ("SELECT AccountTransactions.LedgerSeq,AccountTransactions.TxnSeq,"
-         "Status,RawTxn,TxnMeta "
-         "FROM AccountTransactions INNER JOIN Transactions "
-         "ON Transactions.TransID = AccountTransactions.TransID "
-         "WHERE AccountTransactions.Account = '%s' "
-         "AND AccountTransactions.LedgerSeq BETWEEN '%u' AND '%u' "
-         "ORDER BY AccountTransactions.LedgerSeq %s, "
-         "AccountTransactions.TxnSeq %s, AccountTransactions.TransID %s "
-         "LIMIT %u;")
-             % account.humanAccountID()
-             % ((forward && (findLedger != 0)) ? findLedger : minLedger)
-             % ((!forward && (findLedger != 0)) ? findLedger: maxLedger)
-             % (forward ? "ASC" : "DESC")
-             % (forward ? "ASC" : "DESC")
-             % (forward ? "ASC" : "DESC")
-             % queryLimit);
-    {
-        auto db = getApp().getTxnDB ().getDB ();
-        auto sl (getApp().getTxnDB ().lock ());
+    auto reader (getApp().getTxnDB ().read ("account_tx"));
 
-        SQL_FOREACH (db, sql)
+    accountTxPage (*reader.getDB (), account, minLedger, maxLedger, forward,
+        token, numberOfResults,
+        [&](std::uint32_t ledgerSeq, std::string const&,
+            Blob const& rawTxn, Blob const& rawMeta)
         {
-            if (!foundResume)
-            {
-                if (findLedger == db->getInt("LedgerSeq") &&
-                    findSeq == db->getInt("TxnSeq"))
-                {
-                    foundResume = true;
-                }
-            }
-            else if (numberOfResults == 0)
-            {
-                token = Json::objectValue;
-                token[jss::ledger] = db->getInt("LedgerSeq");
-                token[jss::seq] = db->getInt("TxnSeq");
-                break;
-            }
-
-            if (foundResume)
-            {
-                int txnSize = 2048;
-                Blob rawTxn (txnSize);
-                txnSize = db->getBinary ("RawTxn", &rawTxn[0], rawTxn.size ());
-
-                if (txnSize > rawTxn.size ())
-                {
-                    rawTxn.resize (txnSize);
-                    db->getBinary ("RawTxn", &*rawTxn.begin (), rawTxn.size ());
-                }
-                else
-                    rawTxn.resize (txnSize);
-
-                int metaSize = 2048;
-                Blob rawMeta (metaSize);
-                metaSize = db->getBinary (
-                    "TxnMeta", &rawMeta[0], rawMeta.size ());
-
-                if (metaSize > rawMeta.size ())
-                {
-                    rawMeta.resize (metaSize);
-                    db->getBinary (
-                        "TxnMeta", &*rawMeta.begin (), rawMeta.size ());
-                }
-                else
-                {
-                    rawMeta.resize (metaSize);
-                }
-
-                ret.emplace_back (strHex (rawTxn), strHex (rawMeta),
-                                  db->getInt ("LedgerSeq"));
-                --numberOfResults;
-            }
-        }
-    }
+            ret.emplace_back (strHex (rawTxn), strHex (rawMeta), ledgerSeq);
+        }, m_journal);
 
     return ret;
 }
@@ -2275,8 +2437,8 @@ NetworkOPsImp::getLedgerAffectedAccounts (std::uint32_t ledgerSeq)
                            % ledgerSeq);
     RippleAddress acct;
     {
-        auto db = getApp().getTxnDB ().getDB ();
-        auto sl (getApp().getTxnDB ().lock ());
+        auto reader (getApp().getTxnDB ().read ("affected_accounts"));
+        auto db = reader.getDB ();
         SQL_FOREACH (db, sql)
         {
             if (acct.setAccountID (db->getStrBinary ("Account")))
@@ -2355,6 +2517,8 @@ Json::Value NetworkOPsImp::getServerInfo (bool human, bool admin)
 
     info[jss::peers] = Json::UInt (getApp ().overlay ().size ());
 
+    info[jss::transaction_queue] = getTransactionQueueJson ();
+
     Json::Value lastClose = Json::objectValue;
     lastClose[jss::proposers] = getApp().getOPs ().getPreviousProposers ();
 
@@ -2511,25 +2675,13 @@ void NetworkOPsImp::pubProposedTransaction (
 {
     Json::Value jvObj   = transJson (*stTxn, terResult, false, lpCurrent);
 
+    Subscribers subs;
     {
         ScopedLockType sl (mLock);
-
-        auto it = mSubRTTransactions.begin ();
-        while (it != mSubRTTransactions.end ())
-        {
-            InfoSub::pointer p = it->second.lock ();
-
-            if (p)
-            {
-                p->send (jvObj, true);
-                ++it;
-            }
-            else
-            {
-                it = mSubRTTransactions.erase (it);
-            }
-        }
+        collectSubscribers (mSubRTTransactions, subs);
     }
+    sendToSubscribers (subs, jvObj);
+
     AcceptedLedgerTx alt (lpCurrent, stTxn, terResult);
     m_journal.trace << "pubProposed: " << alt.getJson ();
     pubAccountTransaction (lpCurrent, alt, false);
@@ -2543,12 +2695,13 @@ void NetworkOPsImp::pubLedger (Ledger::ref accepted)
     auto alpAccepted = AcceptedLedger::makeAcceptedLedger (accepted);
     Ledger::ref lpAccepted = alpAccepted->getLedger ();
 
+    Json::Value jvObj (Json::objectValue);
+    Subscribers subs;
     {
         ScopedLockType sl (mLock);
 
         if (!mSubLedger.empty ())
         {
-            Json::Value jvObj (Json::objectValue);
 
             jvObj[jss::type] = "ledgerClosed";
             jvObj[jss::ledger_index] = lpAccepted->getLedgerSeq ();
@@ -2570,20 +2723,13 @@ void NetworkOPsImp::pubLedger (Ledger::ref accepted)
                         = getApp().getLedgerMaster ().getCompleteLedgers ();
             }
 
-            auto it = mSubLedger.begin ();
-            while (it != mSubLedger.end ())
-            {
-                InfoSub::pointer p = it->second.lock ();
-                if (p)
-                {
-                    p->send (jvObj, true);
-                    ++it;
-                }
-                else
-                    it = mSubLedger.erase (it);
-            }
+            collectSubscribers (mSubLedger, subs);
         }
     }
+    sendToSubscribers (subs, jvObj);
+
+    // Keep the order books current before announcing the transactions
+    getApp().getOrderBookDB ().applyLedger (alpAccepted);
 
     // Don't lock since pubAcceptedTransaction is locking.
     for (auto const& vt : alpAccepted->getMap ())
@@ -2665,40 +2811,14 @@ void NetworkOPsImp::pubValidatedTransaction (
         *alTx.getTxn (), alTx.getResult (), true, alAccepted);
     jvObj[jss::meta] = alTx.getMeta ()->getJson (0);
 
-    std::string sObj = to_string (jvObj);
-
+    Subscribers subs;
     {
         ScopedLockType sl (mLock);
-
-        auto it = mSubTransactions.begin ();
-        while (it != mSubTransactions.end ())
-        {
-            InfoSub::pointer p = it->second.lock ();
-
-            if (p)
-            {
-                p->send (jvObj, sObj, true);
-                ++it;
-            }
-            else
-                it = mSubTransactions.erase (it);
-        }
-
-        it = mSubRTTransactions.begin ();
-
-        while (it != mSubRTTransactions.end ())
-        {
-            InfoSub::pointer p = it->second.lock ();
-
-            if (p)
-            {
-                p->send (jvObj, sObj, true);
-                ++it;
-            }
-            else
-                it = mSubRTTransactions.erase (it);
-        }
+        collectSubscribers (mSubTransactions, subs);
+        collectSubscribers (mSubRTTransactions, subs);
     }
+    sendToSubscribers (subs, jvObj);
+
     getApp().getOrderBookDB ().processTxn (alAccepted, alTx, jvObj);
     pubAccountTransaction (alAccepted, alTx, true);
 }
@@ -2777,12 +2897,7 @@ void NetworkOPsImp::pubAccountTransaction (
         if (alTx.isApplied ())
             jvObj[jss::meta] = alTx.getMeta ()->getJson (0);
 
-        std::string sObj = to_string (jvObj);
-
-        for (InfoSub::ref isrListener : notify)
-        {
-            isrListener->send (jvObj, sObj, true);
-        }
+        sendToSubscribers (Subscribers (notify.begin (), notify.end ()), jvObj);
     }
 }
 
@@ -3405,6 +3520,13 @@ static void fpAppender (
     newObj.set_data (&blob[0], blob.size ());
 }
 
+// A fetch pack is sent in messages of at most this many objects
+static int const fetchPackChunkObjects = 256;
+
+// Most jtPACK_WALK helper jobs walking the maps of one ledger with the
+// job building the pack. The jtPACK_WALK limit bounds the total.
+static int const fetchPackHelpers = 3;
+
 void NetworkOPsImp::makeFetchPack (
     Job&, std::weak_ptr<Peer> wPeer,
     std::shared_ptr<protocol::TMGetObjectByHash> request,
@@ -3469,13 +3591,43 @@ void NetworkOPsImp::makeFetchPack (
     try
     {
         protocol::TMGetObjectByHash reply;
-        reply.set_query (false);
+        int total = 0;
+
+        auto const startReply = [&reply, &request] ()
+        {
+            reply.Clear ();
+            reply.set_query (false);
 
-        if (request->has_seq ())
-            reply.set_seq (request->seq ());
+            if (request->has_seq ())
+                reply.set_seq (request->seq ());
 
-        reply.set_ledgerhash (request->ledgerhash ());
-        reply.set_type (protocol::TMGetObjectByHash::otFETCH_PACK);
+            reply.set_ledgerhash (request->ledgerhash ());
+            reply.set_type (protocol::TMGetObjectByHash::otFETCH_PACK);
+        };
+
+        // Send what we have so far, so the peer can start using it
+        // while we keep walking
+        auto const sendReply = [&reply, &peer, &startReply] ()
+        {
+            if (reply.objects ().size () == 0)
+                return;
+
+            peer->send (std::make_shared<Message> (
+                reply, protocol::mtGET_OBJECTS));
+            startReply ();
+        };
+
+        auto const append = [&reply, &total, &sendReply] (
+            std::uint32_t lSeq, uint256 const& hash, Blob const& blob)
+        {
+            fpAppender (&reply, lSeq, hash, blob);
+            ++total;
+
+            if (reply.objects ().size () >= fetchPackChunkObjects)
+                sendReply ();
+        };
+
+        startReply ();
 
         // Building a fetch pack:
         //  1. Add the header for the requested ledger.
@@ -3486,30 +3638,38 @@ void NetworkOPsImp::makeFetchPack (
         //     256 entries then stop.
         //  5. If not very much time has elapsed, then loop back and repeat
         //     the same process adding the previous ledger to the FetchPack.
+        //
+        // The maps are walked on this job and on jtPACK_WALK helpers, and the
+        // pack goes out in messages of fetchPackChunkObjects as it fills.
+        auto const schedule = [this] (std::function <void ()> task)
+        {
+            m_job_queue.addJob (jtPACK_WALK, "makeFetchPack::walk",
+                [task] (Job&) { task (); });
+        };
+
         do
         {
             std::uint32_t lSeq = wantLedger->getLedgerSeq ();
 
-            protocol::TMIndexedObject& newObj = *reply.add_objects ();
-            newObj.set_hash (wantLedger->getHash ().begin (), 256 / 8);
             Serializer s (256);
             s.add32 (HashPrefix::ledgerMaster);
             wantLedger->addRaw (s);
-            newObj.set_data (s.getDataPtr (), s.getLength ());
-            newObj.set_ledgerseq (lSeq);
+            append (lSeq, wantLedger->getHash (), s.peekData ());
 
             wantLedger->peekAccountStateMap ()->getFetchPack
                 (haveLedger->peekAccountStateMap ().get (), true, 1024,
-                    std::bind (fpAppender, &reply, lSeq, std::placeholders::_1,
-                               std::placeholders::_2));
+                    std::bind (append, lSeq, std::placeholders::_1,
+                               std::placeholders::_2),
+                    schedule, fetchPackHelpers);
 
             if (wantLedger->getTransHash ().isNonZero ())
                 wantLedger->peekTransactionMap ()->getFetchPack (
                     nullptr, true, 256,
-                    std::bind (fpAppender, &reply, lSeq, std::placeholders::_1,
-                               std::placeholders::_2));
+                    std::bind (append, lSeq, std::placeholders::_1,
+                               std::placeholders::_2),
+                    schedule, fetchPackHelpers);
 
-            if (reply.objects ().size () >= 256)
+            if (total >= 256)
                 break;
 
             // move may save a ref/unref
@@ -3519,10 +3679,10 @@ void NetworkOPsImp::makeFetchPack (
         while (wantLedger &&
                UptimeTimer::getInstance ().getElapsedSeconds () <= uUptime + 1);
 
+        sendReply ();
+
         m_journal.info
-            << "Built fetch pack with " << reply.objects ().size () << " nodes";
-        auto msg = std::make_shared<Message> (reply, protocol::mtGET_OBJECTS);
-        peer->send (msg);
+            << "Built fetch pack with " << total << " nodes";
     }
     catch (...)
     {
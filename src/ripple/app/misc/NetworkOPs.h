@@ -150,8 +150,27 @@ public:
     typedef std::function<void (Transaction::pointer, TER)> stCallback;
     virtual void submitTransaction (Job&, STTx::pointer,
         stCallback callback = stCallback ()) = 0;
+
+    /** Queue a transaction relayed by a peer for the open ledger.
+        Relayed transactions wait in a bounded queue ordered by fee and
+        arrival, with a limit per sending account, and are verified and
+        applied to the open ledger in batches on a job. A transaction that
+        is dropped is flagged SF_RETRY so a later relay is accepted.
+
+        @param flags The HashRouter flags of the transaction.
+        @param peer  The peer that relayed it, charged if it is bad.
+        @return `false` if the queue was full and the transaction dropped.
+    */
+    virtual bool queueTransaction (STTx::pointer const& stx, int flags,
+        std::weak_ptr <Peer> const& peer) = 0;
+
+    /** Returns the depth and throughput of the relayed transaction queue. */
+    virtual Json::Value getTransactionQueueJson () = 0;
     virtual Transaction::pointer submitTransactionSync (Transaction::ref tpTrans,
         bool bAdmin, bool bLocal, bool bFailHard, bool bSubmit) = 0;
+    /** Apply a transaction to the open ledger.
+        Concurrent calls are applied together in batches.
+    */
     virtual Transaction::pointer processTransactionCb (Transaction::pointer,
         bool bAdmin, bool bLocal, bool bFailHard, stCallback) = 0;
     virtual Transaction::pointer processTransaction (Transaction::pointer transaction,
@@ -20,6 +20,11 @@
 #ifndef RIPPLE_APP_MISC_ORDERBOOK_H_INCLUDED
 #define RIPPLE_APP_MISC_ORDERBOOK_H_INCLUDED
 
+#include <ripple/basics/base_uint.h>
+#include <ripple/protocol/Book.h>
+#include <memory>
+#include <vector>
+
 namespace ripple {
 
 /** Describes a serialized ledger entry for an order book. */
@@ -0,0 +1,259 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/misc/AccountTxPaging.h>
+#include <ripple/app/data/DatabaseCon.h>
+#include <ripple/app/data/DBInit.h>
+#include <ripple/basics/StringUtilities.h>
+#include <ripple/protocol/JsonFields.h>
+#include <beast/unit_test/suite.h>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+class AccountTxPaging_test : public beast::unit_test::suite
+{
+public:
+    struct Tx
+    {
+        std::uint32_t ledger;
+        std::uint32_t seq;
+    };
+
+    // Each transaction's raw bytes are its "ledger/seq" key, so a page can
+    // be compared against the rows expected in it.
+    typedef std::vector <std::string> Rows;
+
+    static
+    std::string
+    key (Tx const& tx)
+    {
+        return std::to_string (tx.ledger) + "/" + std::to_string (tx.seq);
+    }
+
+    static
+    Json::Value
+    marker (std::uint32_t ledger, std::uint32_t seq)
+    {
+        Json::Value token (Json::objectValue);
+        token[jss::ledger] = ledger;
+        token[jss::seq] = seq;
+        return token;
+    }
+
+    // Fills ledgers 10 to 14. The account's transactions take the even
+    // TxnSeqs, and ledger 12 holds 250 of them. Another account's
+    // transactions take odd TxnSeqs in every ledger. Returns the account's
+    // transactions in ledger order.
+    std::vector <Tx>
+    fill (Database& db, RippleAddress const& account,
+        RippleAddress const& other)
+    {
+        std::vector <Tx> txs;
+        int id = 0;
+
+        auto insert = [&](RippleAddress const& acct, Tx const& tx)
+        {
+            auto transID = std::to_string (++id);
+            transID = std::string (64 - transID.size (), '0') + transID;
+            auto const raw = strHex (key (tx));
+
+            expect (db.executeSQL (
+                "INSERT INTO Transactions "
+                "(TransID, LedgerSeq, Status, RawTxn, TxnMeta) VALUES ('" +
+                transID + "'," + std::to_string (tx.ledger) + ",'V',X'" +
+                raw + "',X'" + raw + "');"));
+            expect (db.executeSQL (
+                "INSERT INTO AccountTransactions "
+                "(TransID, Account, LedgerSeq, TxnSeq) VALUES ('" +
+                transID + "','" + acct.humanAccountID () + "'," +
+                std::to_string (tx.ledger) + "," +
+                std::to_string (tx.seq) + ");"));
+        };
+
+        std::uint32_t const counts[] = { 3, 4, 250, 2, 3 };
+
+        expect (db.executeSQL ("BEGIN TRANSACTION;"));
+        for (std::uint32_t i = 0; i < 5; ++i)
+        {
+            std::uint32_t const ledger = 10 + i;
+            for (std::uint32_t k = 0; k < counts[i]; ++k)
+            {
+                txs.push_back ({ledger, 2 * k});
+                insert (account, txs.back ());
+                if (k < 2)
+                    insert (other, {ledger, 2 * k + 1});
+            }
+        }
+        expect (db.executeSQL ("COMMIT TRANSACTION;"));
+
+        return txs;
+    }
+
+    // The keys of the transactions kept, in page order
+    static
+    Rows
+    select (std::vector <Tx> const& txs, bool forward,
+        std::function <bool (Tx const&)> keep)
+    {
+        Rows rows;
+        for (auto const& tx : txs)
+            if (keep (tx))
+                rows.push_back (key (tx));
+        if (! forward)
+            std::reverse (rows.begin (), rows.end ());
+        return rows;
+    }
+
+    // Reads pages until no marker is returned, checking that every page
+    // but the last is full.
+    Rows
+    walk (Database& db, RippleAddress const& account,
+        std::int32_t minLedger, std::int32_t maxLedger, bool forward,
+        std::uint32_t limit, Json::Value token = Json::nullValue)
+    {
+        Rows rows;
+        for (int pages = 0; pages < 1000; ++pages)
+        {
+            auto const before = rows.size ();
+
+            accountTxPage (db, account, minLedger, maxLedger, forward,
+                token, limit,
+                [&rows](std::uint32_t, std::string const&,
+                    Blob const& rawTxn, Blob const&)
+                {
+                    rows.emplace_back (rawTxn.begin (), rawTxn.end ());
+                },
+                beast::Journal ());
+
+            if (token.isNull ())
+                return rows;
+
+            expect (rows.size () - before == limit, "short page");
+        }
+
+        fail ("too many pages");
+        return rows;
+    }
+
+    void
+    testNoMarker (Database& db, RippleAddress const& account,
+        std::vector <Tx> const& txs)
+    {
+        testcase ("no marker");
+
+        for (std::uint32_t limit : { 1, 7, 100, 1000 })
+        {
+            for (bool forward : { true, false })
+            {
+                expect (walk (db, account, 10, 14, forward, limit) ==
+                    select (txs, forward, [](Tx const&) { return true; }));
+
+                expect (walk (db, account, 11, 13, forward, limit) ==
+                    select (txs, forward, [](Tx const& tx)
+                    {
+                        return tx.ledger >= 11 && tx.ledger <= 13;
+                    }));
+            }
+        }
+    }
+
+    void
+    testBusyLedger (Database& db, RippleAddress const& account,
+        std::vector <Tx> const& txs)
+    {
+        testcase ("marker in a busy ledger");
+
+        // More than 100 of the account's transactions in ledger 12 lie on
+        // either side of these markers. 151 belongs to the other account.
+        for (std::uint32_t seq : { 150, 151 })
+        {
+            for (std::uint32_t limit : { 1, 10 })
+            {
+                expect (walk (db, account, 10, 14, true, limit,
+                    marker (12, seq)) == select (txs, true,
+                    [seq](Tx const& tx)
+                    {
+                        return tx.ledger > 12 ||
+                            (tx.ledger == 12 && tx.seq >= seq);
+                    }));
+
+                expect (walk (db, account, 10, 14, false, limit,
+                    marker (12, seq)) == select (txs, false,
+                    [seq](Tx const& tx)
+                    {
+                        return tx.ledger < 12 ||
+                            (tx.ledger == 12 && tx.seq <= seq);
+                    }));
+            }
+        }
+    }
+
+    void
+    testMarkerOutsideRange (Database& db, RippleAddress const& account,
+        std::vector <Tx> const& txs)
+    {
+        testcase ("marker outside the range");
+
+        // Past the end of the range there is nothing left to read
+        expect (walk (db, account, 11, 13, true, 5, marker (14, 0)).empty ());
+        expect (walk (db, account, 11, 13, false, 5, marker (10, 4)).empty ());
+
+        // Before the start of the range, the marker replaces that bound
+        expect (walk (db, account, 11, 13, true, 5, marker (10, 2)) ==
+            select (txs, true, [](Tx const& tx)
+            {
+                return (tx.ledger == 10 && tx.seq >= 2) ||
+                    (tx.ledger >= 11 && tx.ledger <= 13);
+            }));
+
+        expect (walk (db, account, 11, 13, false, 5, marker (14, 2)) ==
+            select (txs, false, [](Tx const& tx)
+            {
+                return (tx.ledger == 14 && tx.seq <= 2) ||
+                    (tx.ledger >= 11 && tx.ledger <= 13);
+            }));
+    }
+
+    void
+    run () override
+    {
+        // A temporary database, private to its connection
+        DatabaseCon::Setup setup;
+        setup.standAlone = true;
+        DatabaseCon con (setup, "transaction.db", TxnDBInit, TxnDBCount);
+
+        auto const account = RippleAddress::createAccountID (Account (1));
+        auto const other = RippleAddress::createAccountID (Account (2));
+
+        auto const txs = fill (*con.getDB (), account, other);
+
+        testNoMarker (*con.getDB (), account, txs);
+        testBusyLedger (*con.getDB (), account, txs);
+        testMarkerOutsideRange (*con.getDB (), account, txs);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(AccountTxPaging,app,ripple);
+
+} // ripple
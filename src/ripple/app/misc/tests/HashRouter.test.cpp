@@ -0,0 +1,197 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/misc/IHashRouter.h>
+#include <ripple/basics/UptimeTimer.h>
+#include <ripple/basics/tests/benchmark.h>
+#include <beast/unit_test/suite.h>
+#include <beast/unit_test/thread.h>
+#include <algorithm>
+#include <iomanip>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace ripple {
+
+class HashRouter_test : public beast::unit_test::suite
+{
+public:
+    // Hashes sharing a first byte land in the same shard
+    static
+    uint256
+    make_hash (std::uint8_t shard, std::uint8_t n)
+    {
+        uint256 h;
+        *h.begin () = shard;
+        *(h.end () - 1) = n;
+        return h;
+    }
+
+    void
+    testSuppression ()
+    {
+        testcase ("suppression");
+
+        std::unique_ptr <IHashRouter> router (IHashRouter::New (
+            IHashRouter::getDefaultHoldTime ()));
+
+        auto const h1 = make_hash (1, 1);
+        auto const h2 = make_hash (2, 1);
+
+        expect (router->addSuppression (h1));
+        expect (! router->addSuppression (h1));
+        expect (router->addSuppressionPeer (h2, 7));
+        expect (! router->addSuppressionPeer (h2, 8));
+
+        int flags = -1;
+        expect (! router->addSuppressionPeer (h2, 9, flags));
+        expect (flags == 0);
+
+        expect (router->setFlag (h2, SF_RELAYED));
+        expect (! router->setFlag (h2, SF_RELAYED));
+        expect (router->getFlags (h2) == SF_RELAYED);
+        expect (router->getFlags (h1) == 0);
+
+        std::set <IHashRouter::PeerShortID> peers;
+        expect (router->swapSet (h2, peers, SF_SAVED));
+        expect (peers == std::set <IHashRouter::PeerShortID> ({ 7, 8, 9 }));
+        expect (! router->swapSet (h2, peers, SF_SAVED));
+        expect (router->getFlags (h2) == (SF_RELAYED | SF_SAVED));
+    }
+
+    void
+    testExpiration ()
+    {
+        testcase ("expiration");
+
+        int const holdTime = 4;
+        auto& timer = UptimeTimer::getInstance ();
+        timer.beginManualUpdates ();
+
+        std::unique_ptr <IHashRouter> router (IHashRouter::New (holdTime));
+
+        auto const h1 = make_hash (3, 1);
+        auto const h2 = make_hash (3, 2);
+        auto const h3 = make_hash (3, 3);
+        auto const other = make_hash (4, 1);
+
+        expect (router->addSuppressionFlags (h1, SF_BAD));
+        expect (router->addSuppression (other));
+
+        for (int i = 1; i < holdTime; ++i)
+            timer.incrementElapsedTime ();
+
+        // Not yet held for holdTime seconds
+        expect (router->addSuppression (h2));
+        expect (router->getFlags (h1) == SF_BAD);
+
+        timer.incrementElapsedTime ();
+
+        // Creating an entry reclaims the expired slot of its shard
+        expect (router->addSuppression (h3));
+        expect (router->addSuppression (h1));
+        expect (router->getFlags (h1) == 0);
+        expect (! router->addSuppression (h2));
+
+        // Jumping well past several turns of the wheel
+        for (int i = 0; i < 3 * holdTime; ++i)
+            timer.incrementElapsedTime ();
+
+        expect (router->addSuppression (make_hash (3, 4)));
+        expect (router->addSuppression (h2));
+        expect (router->addSuppression (h3));
+
+        timer.endManualUpdates ();
+    }
+
+    void
+    run () override
+    {
+        testSuppression ();
+        testExpiration ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(HashRouter,app,ripple);
+
+//------------------------------------------------------------------------------
+
+// Measures suppression lookups per second with several threads relaying
+// the same set of messages, each hash seen once per thread as it would
+// be when several peers relay it.
+class HashRouterContention_test : public beast::unit_test::suite
+{
+public:
+    static std::size_t const messages = 200000;
+
+    // Returns operations per second across all threads
+    double
+    do_contend (std::vector <uint256> const& hashes, std::size_t threads)
+    {
+        std::unique_ptr <IHashRouter> router (IHashRouter::New (
+            IHashRouter::getDefaultHoldTime ()));
+
+        auto const relay = [&](std::size_t peer)
+        {
+            std::vector <uint256> order (hashes);
+            std::shuffle (order.begin (), order.end (), std::mt19937 (peer));
+
+            for (auto const& h : order)
+            {
+                int flags;
+                router->addSuppressionPeer (h,
+                    static_cast <IHashRouter::PeerShortID> (peer), flags);
+                if (! (flags & SF_RELAYED))
+                    router->setFlag (h, SF_RELAYED);
+            }
+        };
+
+        auto const start = test::benchmark_clock::now();
+        std::vector<beast::unit_test::thread> t;
+        t.reserve (threads);
+        for (std::size_t i = 0; i < threads; ++i)
+            t.emplace_back (*this, relay, i + 1);
+        for (auto& _ : t)
+            _.join();
+        return test::per_second (2 * hashes.size() * threads,
+            test::seconds_since (start));
+    }
+
+    void
+    run () override
+    {
+        std::mt19937 gen;
+        std::vector <uint256> hashes (messages);
+        for (auto& h : hashes)
+            for (auto& b : h)
+                b = static_cast <std::uint8_t> (gen ());
+
+        testcase ("contention");
+        for (std::size_t threads : { 1, 2, 4, 8, 16 })
+            log << std::setw(3) << threads << " threads: " <<
+                test::format_rate (do_contend (hashes, threads)) << " ops/s";
+        pass ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(HashRouterContention,app,ripple);
+
+} // ripple
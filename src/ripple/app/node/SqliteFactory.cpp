@@ -100,7 +100,9 @@ public:
 
             pSt.bind (1, to_string (hash));
 
-            if (pSt.isRow (pSt.step()))
+            int const rc = pSt.step();
+
+            if (pSt.isRow (rc))
             {
                 // VFALCO NOTE This is unfortunately needed,
                 //             the DatabaseCon creates the blob?
@@ -110,6 +112,10 @@ public:
                     std::move(data),
                     hash);
             }
+            else if (pSt.isError (rc))
+            {
+                result = NodeStore::Status (NodeStore::customCode + rc);
+            }
             else
             {
                 result = NodeStore::notFound;
@@ -121,6 +127,26 @@ public:
         return result;
     }
 
+    NodeStore::Status fetchBatch (std::vector <void const*> const& keys,
+        std::vector <NodeObject::Ptr>& objects) override
+    {
+        NodeStore::Status result = NodeStore::ok;
+        objects.assign (keys.size (), nullptr);
+
+        // Hold the lock across the whole batch
+        auto sl (m_db->lock());
+
+        for (std::size_t i = 0; i < keys.size (); ++i)
+        {
+            NodeStore::Status const status = fetch (keys[i], &objects[i]);
+            if (status != NodeStore::ok && status != NodeStore::notFound &&
+                    result == NodeStore::ok)
+                result = status;
+        }
+
+        return result;
+    }
+
     void store (NodeObject::ref object)
     {
         NodeStore::Batch batch;
@@ -19,14 +19,29 @@
 
 #include <BeastConfig.h>
 #include <ripple/app/paths/PathRequests.h>
+#include <ripple/app/ledger/AcceptedLedger.h>
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/main/Application.h>
+#include <ripple/basics/parallel_for.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/protocol/JsonFields.h>
 #include <ripple/resource/Fees.h>
 
 namespace ripple {
 
+/** Return the accounts affected by any transaction in the ledger. */
+static hash_set <Account> getTouchedAccounts (Ledger::ref ledger)
+{
+    hash_set <Account> touched;
+    auto const accepted = AcceptedLedger::makeAcceptedLedger (ledger);
+    for (auto const& item : accepted->getMap ())
+    {
+        for (auto const& account : item.second->getAffected ())
+            touched.insert (account.getAccountID ());
+    }
+    return touched;
+}
+
 /** Get the current RippleLineCache, updating it if necessary.
     Get the correct ledger to use.
 */
@@ -42,8 +57,20 @@ RippleLineCache::pointer PathRequests::getLineCache (Ledger::pointer& ledger, bo
          (authoritative && ((lgrSeq + 8)  < lineSeq)) ||   // we jumped way back for some reason
          (lgrSeq > (lineSeq + 8)))                         // we jumped way forward for some reason
     {
+        Ledger::pointer const source = ledger;
         ledger = std::make_shared<Ledger>(*ledger, false); // Take a snapshot of the ledger
-        mLineCache = std::make_shared<RippleLineCache> (ledger);
+
+        if (mLineCache && (lgrSeq == (lineSeq + 1)) &&
+            (source->getParentHash () == mLineCache->getLedger ()->getHash ()))
+        {
+            // Keep the lines of every account this ledger didn't touch
+            mLineCache = std::make_shared<RippleLineCache> (ledger,
+                *mLineCache, getTouchedAccounts (source));
+        }
+        else
+        {
+            mLineCache = std::make_shared<RippleLineCache> (ledger);
+        }
     }
     else
     {
@@ -52,6 +79,56 @@ RippleLineCache::pointer PathRequests::getLineCache (Ledger::pointer& ledger, bo
     return mLineCache;
 }
 
+bool PathRequests::updateRequest (PathRequest::wptr const& wRequest,
+    RippleLineCache::ref cache, std::uint32_t ledgerSeq, bool newRequests)
+{
+    PathRequest::pointer pRequest = wRequest.lock ();
+
+    if (!pRequest)
+        return false;
+
+    if (!pRequest->needsUpdate (newRequests, ledgerSeq))
+        return true;
+
+    InfoSub::pointer ipSub = pRequest->getSubscriber ();
+    if (!ipSub)
+        return false;
+
+    ipSub->getConsumer ().charge (Resource::feePathFindUpdate);
+    if (ipSub->getConsumer ().warn ())
+        return false;
+
+    Json::Value update = pRequest->doUpdate (cache, false);
+    pRequest->updateComplete ();
+    update[jss::type] = "path_find";
+    ipSub->send (update, false);
+    return true;
+}
+
+int PathRequests::removeRequest (PathRequest::wptr const& wRequest)
+{
+    PathRequest::pointer pRequest = wRequest.lock ();
+    int removed = 0;
+
+    ScopedLockType sl (mLock);
+
+    // Remove any dangling weak pointers or weak pointers that refer to this path request.
+    std::vector<PathRequest::wptr>::iterator it = mRequests.begin();
+    while (it != mRequests.end())
+    {
+        PathRequest::pointer itRequest = it->lock ();
+        if (!itRequest || (itRequest == pRequest))
+        {
+            ++removed;
+            it = mRequests.erase (it);
+        }
+        else
+            ++it;
+    }
+
+    return removed;
+}
+
 void PathRequests::updateAll (Ledger::ref inLedger,
                               Job::CancelCallback shouldCancel)
 {
@@ -73,66 +150,56 @@ void PathRequests::updateAll (Ledger::ref inLedger,
 
     mJournal.trace << "updateAll seq=" << ledger->getLedgerSeq() << ", " <<
         requests.size() << " requests";
-    int processed = 0, removed = 0;
+    std::atomic<int> processed (0), removed (0);
 
     do
     {
-        for (auto& wRequest : requests)
-        {
-            if (shouldCancel())
-                break;
-
-            bool remove = true;
-            PathRequest::pointer pRequest = wRequest.lock ();
-
-            if (pRequest)
+        auto const start = clock_type::now ();
+
+        // Requests are claimed in order by the caller and a bounded set of
+        // path finding jobs that all share the same ledger snapshot and
+        // line cache. Claiming stops when the job is cancelled or a new
+        // request arrives during a full pass.
+        std::atomic<bool> sawNewRequest (false);
+        std::uint32_t const ledgerSeq = ledger->getLedgerSeq ();
+
+        auto const finished = parallel_for (requests.size (),
+            maxUpdateThreads - 1,
+            [] (std::function <void ()> task)
             {
-                if (!pRequest->needsUpdate (newRequests, ledger->getLedgerSeq ()))
-                    remove = false;
-                else
-                {
-                    InfoSub::pointer ipSub = pRequest->getSubscriber ();
-                    if (ipSub)
-                    {
-                        ipSub->getConsumer ().charge (Resource::feePathFindUpdate);
-                        if (!ipSub->getConsumer ().warn ())
-                        {
-                            Json::Value update = pRequest->doUpdate (cache, false);
-                            pRequest->updateComplete ();
-                            update[jss::type] = "path_find";
-                            ipSub->send (update, false);
-                            remove = false;
-                            ++processed;
-                        }
-                    }
-                }
-            }
-
-            if (remove)
+                getApp().getJobQueue ().addJob (jtUPDATE_PF,
+                    "PathRequest::update", [task] (Job&) { task (); });
+            },
+            [&] (std::size_t i)
             {
-                PathRequest::pointer pRequest = wRequest.lock ();
+                if (shouldCancel())
+                    return false;
 
-                ScopedLockType sl (mLock);
+                if (updateRequest (requests[i], cache, ledgerSeq, newRequests))
+                    ++processed;
+                else
+                    removed += removeRequest (requests[i]);
 
-                // Remove any dangling weak pointers or weak pointers that refer to this path request.
-                std::vector<PathRequest::wptr>::iterator it = mRequests.begin();
-                while (it != mRequests.end())
+                // We weren't handling new requests and then there was a new request
+                if (!newRequests && getApp().getLedgerMaster().isNewPathRequest())
                 {
-                    PathRequest::pointer itRequest = it->lock ();
-                    if (!itRequest || (itRequest == pRequest))
-                    {
-                        ++removed;
-                        it = mRequests.erase (it);
-                    }
-                    else
-                        ++it;
+                    sawNewRequest = true;
+                    return false;
                 }
-            }
+                return true;
+            });
 
-            mustBreak = !newRequests && getApp().getLedgerMaster().isNewPathRequest();
-            if (mustBreak) // We weren't handling new requests and then there was a new request
-                break;
+        mustBreak = sawNewRequest;
 
+        // Time for a pass that updated every request
+        if (finished)
+        {
+            auto const elapsed = std::chrono::duration_cast <
+                std::chrono::milliseconds> (clock_type::now () - start);
+            if (newRequests)
+                reportFastUpdate (elapsed.count ());
+            else
+                reportFullUpdate (elapsed.count ());
         }
 
         if (mustBreak)
@@ -24,6 +24,7 @@
 #include <ripple/app/paths/RippleLineCache.h>
 #include <ripple/core/Job.h>
 #include <atomic>
+#include <chrono>
 
 namespace ripple {
 
@@ -36,6 +37,8 @@ public:
     {
         mFast = collector->make_event ("pathfind_fast");
         mFull = collector->make_event ("pathfind_full");
+        mFastUpdate = collector->make_event ("pathfind_fast_update");
+        mFullUpdate = collector->make_event ("pathfind_full_update");
     }
 
     void updateAll (const std::shared_ptr<Ledger>& ledger,
@@ -59,11 +62,38 @@ public:
         mFull.notify (static_cast < beast::insight::Event::value_type> (milliseconds));
     }
 
+    /** Report how long a pass that updated every request took. */
+    /** @{ */
+    void reportFastUpdate (int milliseconds)
+    {
+        mFastUpdate.notify (static_cast < beast::insight::Event::value_type> (milliseconds));
+    }
+
+    void reportFullUpdate (int milliseconds)
+    {
+        mFullUpdate.notify (static_cast < beast::insight::Event::value_type> (milliseconds));
+    }
+    /** @} */
+
 private:
+    typedef std::chrono::steady_clock clock_type;
+
+    // Most jobs, including the caller, updating requests for one ledger
+    static std::size_t const maxUpdateThreads = 4;
+
+    // Returns false if the request should be removed
+    bool updateRequest (PathRequest::wptr const& wRequest,
+        RippleLineCache::ref cache, std::uint32_t ledgerSeq, bool newRequests);
+
+    // Returns the number of requests removed
+    int removeRequest (PathRequest::wptr const& wRequest);
+
     beast::Journal                   mJournal;
 
     beast::insight::Event            mFast;
     beast::insight::Event            mFull;
+    beast::insight::Event            mFastUpdate;
+    beast::insight::Event            mFullUpdate;
 
     // Track all requests
     std::vector<PathRequest::wptr>   mRequests;
@@ -19,6 +19,7 @@
 
 #include <BeastConfig.h>
 #include <ripple/app/paths/RippleLineCache.h>
+#include <limits>
 
 namespace ripple {
 
@@ -27,19 +28,66 @@ RippleLineCache::RippleLineCache (Ledger::ref l)
 {
 }
 
+RippleLineCache::RippleLineCache (Ledger::ref l, RippleLineCache& previous,
+        hash_set <Account> const& touched)
+    : hasher_ (previous.hasher_)
+    , mLedger (l)
+{
+    for (std::size_t i = 0; i < shardCount; ++i)
+    {
+        Shard& from = previous.mShards[i];
+        Shard& to = mShards[i];
+
+        ScopedLockType sl (from.mutex);
+        to.map.reserve (from.map.size ());
+        for (auto const& entry : from.map)
+        {
+            if (touched.count (entry.first.account_) == 0)
+                to.map.emplace (entry.first, entry.second);
+        }
+    }
+}
+
+RippleLineCache::Shard&
+RippleLineCache::getShard (std::size_t hash)
+{
+    // The shard maps bucket on the low bits, so pick shards by the high bits
+    return mShards[(hash >> (std::numeric_limits<std::size_t>::digits - 8))
+        % shardCount];
+}
+
 RippleLineCache::RippleStateVector const&
 RippleLineCache::getRippleLines (Account const& accountID)
 {
     AccountKey key (accountID, hasher_ (accountID));
+    Shard& shard = getShard (key.hash_value_);
 
-    ScopedLockType sl (mLock);
+    {
+        ScopedLockType sl (shard.mutex);
+        auto it = shard.map.find (key);
+        if (it != shard.map.end ())
+            return *it->second;
+    }
 
-    auto it = mRLMap.emplace (key, RippleStateVector ());
+    // Read the lines without holding the lock. If another thread loads
+    // the same account meanwhile, whichever result is stored first wins.
+    auto lines = std::make_shared <RippleStateVector const> (
+        ripple::getRippleStateItems (accountID, mLedger));
 
-    if (it.second)
-        it.first->second = ripple::getRippleStateItems (accountID, mLedger);
+    ScopedLockType sl (shard.mutex);
+    return *shard.map.emplace (key, std::move (lines)).first->second;
+}
 
-    return it.first->second;
+std::size_t
+RippleLineCache::size ()
+{
+    std::size_t n = 0;
+    for (auto& shard : mShards)
+    {
+        ScopedLockType sl (shard.mutex);
+        n += shard.map.size ();
+    }
+    return n;
 }
 
 } // ripple
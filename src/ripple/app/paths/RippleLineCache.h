@@ -22,6 +22,7 @@
 
 #include <ripple/app/paths/RippleState.h>
 #include <ripple/basics/hardened_hash.h>
+#include <array>
 #include <cstddef>
 #include <memory>
 #include <vector>
@@ -29,6 +30,11 @@
 namespace ripple {
 
 // Used by Pathfinder
+//
+// Lines are cached per account in independently locked shards, and are
+// loaded from the ledger without holding any lock. A cache for the next
+// ledger can be made from this one, keeping the lines of every account
+// that ledger's transactions didn't touch.
 class RippleLineCache
 {
 public:
@@ -38,6 +44,13 @@ public:
 
     explicit RippleLineCache (Ledger::ref l);
 
+    /** Create a cache for a ledger that follows the previous cache's.
+        @param touched Accounts whose lines may differ between the two
+                       ledgers. Their lines are reloaded on demand.
+    */
+    RippleLineCache (Ledger::ref l, RippleLineCache& previous,
+        hash_set <Account> const& touched);
+
     Ledger::ref getLedger () // VFALCO TODO const?
     {
         return mLedger;
@@ -46,10 +59,12 @@ public:
     std::vector<RippleState::pointer> const&
     getRippleLines (Account const& accountID);
 
+    /** Return the number of accounts with cached lines. */
+    std::size_t size ();
+
 private:
     typedef RippleMutex LockType;
     typedef std::lock_guard <LockType> ScopedLockType;
-    LockType mLock;
 
     ripple::hardened_hash<> hasher_;
     Ledger::pointer mLedger;
@@ -90,7 +105,19 @@ private:
         };
     };
 
-    hash_map <AccountKey, RippleStateVector, AccountKey::Hash> mRLMap;
+    typedef std::shared_ptr <RippleStateVector const> Lines;
+
+    struct Shard
+    {
+        LockType mutex;
+        hash_map <AccountKey, Lines, AccountKey::Hash> map;
+    };
+
+    static std::size_t const shardCount = 16;
+
+    Shard& getShard (std::size_t hash);
+
+    std::array <Shard, shardCount> mShards;
 };
 
 } // ripple
@@ -0,0 +1,324 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/misc/ApplyQueue.h>
+#include <ripple/app/tests/common_ledger.h>
+#include <ripple/app/tx/TransactionEngine.h>
+#include <ripple/basics/tests/benchmark.h>
+#include <beast/unit_test/suite.h>
+#include <beast/unit_test/thread.h>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+// Checks how submissions from many threads are batched.
+class ApplyQueueBatch_test : public beast::unit_test::suite
+{
+public:
+    struct Item
+    {
+        int thread;
+        int seq;
+        int batch;
+    };
+
+    // Submits count items from each of threads threads. Each thread
+    // calls f (item) and counts the items that threw.
+    template <class Function>
+    std::size_t
+    submit (int threads, int count, Function&& f)
+    {
+        std::atomic <std::size_t> thrown (0);
+        std::vector <beast::unit_test::thread> t;
+        t.reserve (threads);
+        for (int n = 0; n < threads; ++n)
+        {
+            t.emplace_back (*this, [&, n]()
+            {
+                for (int i = 0; i < count; ++i)
+                {
+                    Item item { n, i, -1 };
+                    try
+                    {
+                        f (item);
+                    }
+                    catch (std::runtime_error const&)
+                    {
+                        ++thrown;
+                    }
+                }
+            });
+        }
+        for (auto& _ : t)
+            _.join();
+        return thrown;
+    }
+
+    void
+    testOrder ()
+    {
+        testcase ("order");
+
+        ApplyQueue <Item> queue;
+        std::recursive_mutex master;
+        std::vector <Item> applied;
+
+        submit (8, 500, [&](Item& item)
+        {
+            // Half of the submissions already hold the lock
+            std::unique_lock <std::recursive_mutex> lock (master,
+                std::defer_lock);
+            if (item.seq % 2)
+                lock.lock ();
+
+            queue.apply (item, master,
+                [&](ApplyQueue <Item>::Batch& batch)
+                {
+                    for (auto const e : batch)
+                        applied.push_back (*e);
+                });
+        });
+
+        std::vector <int> next (8, 0);
+        bool ordered = true;
+        for (auto const& item : applied)
+            ordered = (item.seq == next[item.thread]++) && ordered;
+        expect (applied.size () == 8 * 500, "items lost");
+        expect (ordered, "items applied out of order");
+        expect (queue.size () == 0, "items left behind");
+    }
+
+    void
+    testException ()
+    {
+        testcase ("exception");
+
+        ApplyQueue <Item> queue;
+        std::mutex master;
+        int batches = 0;
+        std::vector <bool> failed;
+        std::atomic <std::size_t> expected (0);
+        std::atomic <std::size_t> unreported (0);
+
+        // Every batch holding an item with a seq divisible by 7 fails
+        auto const thrown = submit (8, 500, [&](Item& item)
+        {
+            try
+            {
+                queue.apply (item, master,
+                    [&](ApplyQueue <Item>::Batch& batch)
+                    {
+                        bool fail = false;
+                        for (auto const e : batch)
+                        {
+                            e->batch = batches;
+                            fail = fail || (e->seq % 7 == 0);
+                        }
+                        failed.push_back (fail);
+                        ++batches;
+                        if (fail)
+                            throw std::runtime_error ("batch failed");
+                    });
+            }
+            catch (...)
+            {
+                std::lock_guard <std::mutex> lock (master);
+                if (item.batch >= 0 && failed[item.batch])
+                    ++expected;
+                throw;
+            }
+            std::lock_guard <std::mutex> lock (master);
+            if (item.batch < 0 || failed[item.batch])
+                ++unreported;
+        });
+
+        expect (thrown > 0, "no batch failed");
+        expect (unreported == 0, "failure not reported");
+        expect (thrown == expected, "failure reported for a good batch");
+        expect (queue.size () == 0, "items left behind");
+    }
+
+    void
+    run () override
+    {
+        testOrder ();
+        testException ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(ApplyQueueBatch,app,ripple);
+
+//------------------------------------------------------------------------------
+
+// Submits payments to an open ledger from many threads and reports the
+// transactions per second, applying them one at a time under a lock and
+// in batches through an ApplyQueue.
+class ApplyQueue_test : public beast::unit_test::suite
+{
+public:
+#ifndef NDEBUG
+    std::size_t const default_txns = 10000;
+#else
+    std::size_t const default_txns = 50000; // release
+#endif
+
+    struct Submission
+    {
+        STTx const* tx;
+        TER result;
+    };
+
+    // Holds the open ledger the way LedgerMaster does: the held ledger is
+    // immutable, and transactions are applied to a mutable snapshot which
+    // then replaces it. The mutex stands in for the master lock.
+    class OpenLedger
+    {
+    public:
+        explicit OpenLedger (Ledger& ledger)
+            : m_ledger (std::make_shared <Ledger> (ledger, false))
+        {
+        }
+
+        // The caller must hold mutex
+        void apply (std::vector <Submission*> const& batch)
+        {
+            auto ledger = std::make_shared <Ledger> (*m_ledger, true);
+            TransactionEngine engine (ledger);
+            for (auto const s : batch)
+            {
+                bool didApply = false;
+                s->result = engine.applyTransaction (*s->tx,
+                    tapOPEN_LEDGER | tapNO_CHECK_SIGN, didApply);
+            }
+            m_ledger = std::make_shared <Ledger> (*ledger, false);
+        }
+
+        std::mutex mutex;
+
+    private:
+        Ledger::pointer m_ledger;
+    };
+
+    // Returns transactions applied per second
+    double
+    do_submit (Ledger& base,
+        std::vector <std::vector <STTx>> const& txns, bool batched)
+    {
+        OpenLedger open (base);
+        ApplyQueue <Submission> queue;
+        std::atomic <std::size_t> failed (0);
+
+        auto const submit = [&](std::vector <STTx> const& list)
+        {
+            for (auto const& tx : list)
+            {
+                Submission s { &tx, tefEXCEPTION };
+                if (batched)
+                {
+                    queue.apply (s, open.mutex,
+                        [&open](std::vector <Submission*>& batch)
+                        {
+                            open.apply (batch);
+                        });
+                }
+                else
+                {
+                    std::lock_guard <std::mutex> lock (open.mutex);
+                    open.apply ({ &s });
+                }
+                if (s.result != tesSUCCESS)
+                    ++failed;
+            }
+        };
+
+        std::size_t total = 0;
+        auto const start = benchmark_clock::now();
+        std::vector <beast::unit_test::thread> t;
+        t.reserve (txns.size ());
+        for (auto const& list : txns)
+        {
+            total += list.size ();
+            t.emplace_back (*this, std::bind (submit, std::cref (list)));
+        }
+        for (auto& _ : t)
+            _.join();
+        auto const elapsed = seconds_since (start);
+
+        expect (failed == 0, "transaction failed");
+        return per_second (total, elapsed);
+    }
+
+    void
+    run () override
+    {
+        std::size_t txnCount = default_txns;
+        if (! arg().empty())
+            txnCount = std::stoul (arg());
+
+        std::uint64_t const xrp = std::mega::num;
+        KeyType const keyType = KeyType::secp256k1;
+
+        auto master = createAccount ("masterpassphrase", keyType);
+        Ledger::pointer LCL = createGenesisLedger (100000000 * xrp, master);
+        Ledger::pointer ledger = std::make_shared <Ledger> (false, *LCL);
+
+        for (std::size_t threads : { 1, 4, 16, 32 })
+        {
+            // Each thread pays from its own accounts, so the sequence
+            // numbers are in order regardless of how threads interleave.
+            std::vector <std::vector <STTx>> txns (threads);
+            std::vector <TestAccount> accounts;
+            for (std::size_t i = 0; i < threads; ++i)
+            {
+                accounts.push_back (createAccount (
+                    "load" + std::to_string (threads) +
+                        "_" + std::to_string (i), keyType));
+                makeAndApplyPayment (master, accounts.back (),
+                    1000000 * xrp, ledger, false);
+            }
+            LCL = close_and_advance (ledger, LCL);
+            ledger = std::make_shared <Ledger> (false, *LCL);
+
+            for (std::size_t i = 0; i < txnCount; ++i)
+            {
+                auto const n = i % threads;
+                txns[n].push_back (getPaymentTx (
+                    accounts[n], master, 1000, false));
+            }
+
+            testcase (std::to_string (txnCount) + " payments, " +
+                std::to_string (threads) + " threads");
+            log << "  one at a time: " <<
+                format_rate (do_submit (*ledger, txns, false)) << " tps";
+            log << "        batched: " <<
+                format_rate (do_submit (*ledger, txns, true)) << " tps";
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(ApplyQueue,app,ripple);
+
+} // test
+} // ripple
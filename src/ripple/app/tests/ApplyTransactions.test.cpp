@@ -0,0 +1,168 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/tests/common_ledger.h>
+#include <beast/unit_test/suite.h>
+#include <chrono>
+#include <functional>
+#include <ratio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+// Closes the same open ledger serially and on several threads, and checks
+// that both produce the same ledger.
+class ApplyTransactions_test : public beast::unit_test::suite
+{
+public:
+    static std::uint64_t const xrp = std::mega::num;
+
+    // Build the closed ledger that follows LCL from the transactions of
+    // the open ledger, the way LedgerConsensus does. Each helper task runs
+    // on its own thread.
+    static
+    Ledger::pointer
+    close (Ledger::pointer const& open, Ledger::pointer const& LCL,
+        std::uint32_t closeTime, int threads)
+    {
+        std::vector<std::thread> helpers;
+        helpers.reserve (threads);
+
+        std::shared_ptr<SHAMap> set = open->peekTransactionMap();
+        CanonicalTXSet retriableTransactions(set->getHash());
+        Ledger::pointer newLCL = std::make_shared<Ledger>(false, *LCL);
+        applyTransactions(set, newLCL, newLCL, retriableTransactions,
+            false, threads,
+            [&helpers] (std::function <void ()> task)
+            {
+                helpers.emplace_back (std::move (task));
+            });
+        for (auto& t : helpers)
+            t.join ();
+        newLCL->updateSkipList();
+        newLCL->setClosed();
+        newLCL->setAccepted(closeTime,
+            std::chrono::seconds(LEDGER_TIME_ACCURACY).count(), true);
+        return newLCL;
+    }
+
+    void
+    expectSame (Ledger::pointer const& open, Ledger::pointer const& LCL,
+        std::uint32_t closeTime)
+    {
+        auto const serial = close (open, LCL, closeTime, 1);
+
+        for (int threads : { 2, 4, 8 })
+        {
+            auto const parallel = close (open, LCL, closeTime, threads);
+            expect (parallel->getAccountHash() == serial->getAccountHash(),
+                "account state differs with " + std::to_string (threads) +
+                    " threads");
+            expect (parallel->getTransHash() == serial->getTransHash(),
+                "transactions differ with " + std::to_string (threads) +
+                    " threads");
+            expect (parallel->getTotalCoins() == serial->getTotalCoins());
+            expect (parallel->getHash() == serial->getHash());
+        }
+    }
+
+    void
+    testDeterminism ()
+    {
+        testcase ("determinism");
+
+        using namespace std::chrono;
+        std::uint32_t const closeTime = duration_cast<seconds>(
+            system_clock::now().time_since_epoch() - days(10957)).count();
+
+        auto master = createAccount ("masterpassphrase", KeyType::secp256k1);
+        Ledger::pointer LCL = createGenesisLedger (100000 * xrp, master);
+        Ledger::pointer ledger = std::make_shared<Ledger> (false, *LCL);
+
+        auto gw = createAccount ("gw", KeyType::secp256k1);
+        std::vector<TestAccount> users;
+        for (int i = 0; i < 12; ++i)
+            users.push_back (createAccount (
+                "user" + std::to_string (i), KeyType::secp256k1));
+
+        // Every funding payment touches the master account
+        makeAndApplyPayment (master, gw, 10000 * xrp, ledger);
+        for (auto& user : users)
+            makeAndApplyPayment (master, user, 1000 * xrp, ledger);
+
+        expectSame (ledger, LCL, closeTime);
+        LCL = close_and_advance (ledger, LCL);
+        ledger = std::make_shared<Ledger> (false, *LCL);
+
+        // Disjoint pairs, several transactions per account, and a shared
+        // issuer whose trust lines and balances many transactions touch
+        for (std::size_t i = 0; i < users.size (); ++i)
+        {
+            auto& user = users[i];
+            makeTrustSet (user, gw, "FOO", 1000, ledger);
+            makeAndApplyPayment (user, users[(i + 1) % users.size ()],
+                (i + 1) * xrp, ledger);
+            makeAndApplyPayment (user, users[users.size () - 1 - i],
+                xrp / 2, ledger);
+        }
+
+        expectSame (ledger, LCL, closeTime);
+        LCL = close_and_advance (ledger, LCL);
+        ledger = std::make_shared<Ledger> (false, *LCL);
+
+        for (std::size_t i = 0; i < users.size (); ++i)
+            makeAndApplyPayment (gw, users[i], "FOO",
+                std::to_string (10 * (i + 1)), ledger);
+
+        // Offers in one book read the same directory ranges
+        for (std::size_t i = 0; i < users.size (); i += 2)
+            createOffer (users[i], Amount (i + 1, "BAR", gw),
+                Amount (1, "FOO", gw), ledger);
+        cancelOffer (users[0], ledger);
+        freezeAccount (users[1], ledger);
+
+        expectSame (ledger, LCL, closeTime);
+        LCL = close_and_advance (ledger, LCL);
+        ledger = std::make_shared<Ledger> (false, *LCL);
+
+        for (std::size_t i = 0; i + 1 < users.size (); i += 2)
+        {
+            makeAndApplyPayment (users[i], users[i + 1], xrp, ledger);
+            makeAndApplyPayment (users[i + 1], users[i], 2 * xrp, ledger);
+        }
+        unfreezeAccount (users[1], ledger);
+
+        expectSame (ledger, LCL, closeTime);
+    }
+
+    void
+    run ()
+    {
+        testDeterminism ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(ApplyTransactions,ripple_app,ripple);
+
+} // test
+} // ripple
@@ -0,0 +1,117 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/misc/IntakeQueue.h>
+#include <beast/unit_test/suite.h>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class IntakeQueue_test : public beast::unit_test::suite
+{
+public:
+    typedef IntakeQueue <int, std::string> Queue;
+
+    void testOrder ()
+    {
+        testcase ("order");
+
+        Queue q (10, 10);
+        expect (q.push (1, 10, "a"));
+        expect (q.push (2, 20, "b"));
+        expect (q.push (3, 10, "c"));
+        expect (q.push (4, 30, "d"));
+        expect (q.push (5, 20, "e"));
+        expect (q.size () == 5);
+
+        // Highest level first, then in arrival order
+        auto items = q.pop (3);
+        expect (items == std::vector <std::string> ({ "d", "b", "e" }));
+        expect (q.size () == 2);
+
+        items = q.pop (10);
+        expect (items == std::vector <std::string> ({ "a", "c" }));
+        expect (q.empty ());
+        expect (q.pop (10).empty ());
+        expect (q.dropped () == 0);
+    }
+
+    void testPerKey ()
+    {
+        testcase ("per key limit");
+
+        Queue q (10, 2);
+        std::vector <std::string> dropped;
+        auto const onDropped = [&](std::string& s) { dropped.push_back (s); };
+
+        expect (q.push (1, 10, "a", onDropped));
+        expect (q.push (1, 50, "b", onDropped));
+        expect (! q.push (1, 99, "c", onDropped));
+        expect (q.push (2, 10, "d", onDropped));
+        expect (dropped == std::vector <std::string> ({ "c" }));
+        expect (q.dropped () == 1);
+
+        // Popping frees the key's slots
+        expect (q.pop (1) == std::vector <std::string> ({ "b" }));
+        expect (q.push (1, 5, "e", onDropped));
+        expect (! q.push (1, 5, "f", onDropped));
+        expect (q.size () == 3);
+    }
+
+    void testCapacity ()
+    {
+        testcase ("capacity");
+
+        Queue q (3, 10);
+        std::vector <std::string> dropped;
+        auto const onDropped = [&](std::string& s) { dropped.push_back (s); };
+
+        expect (q.push (1, 20, "a", onDropped));
+        expect (q.push (2, 10, "b", onDropped));
+        expect (q.push (3, 10, "c", onDropped));
+
+        // An equal level does not displace an earlier arrival
+        expect (! q.push (4, 10, "d", onDropped));
+        expect (dropped == std::vector <std::string> ({ "d" }));
+
+        // A higher level displaces the last, lowest ranked, arrival
+        expect (q.push (5, 15, "e", onDropped));
+        expect (dropped == std::vector <std::string> ({ "d", "c" }));
+        expect (q.size () == 3);
+        expect (q.dropped () == 2);
+
+        // The displaced item's key no longer counts against its limit
+        expect (q.pop (3) == std::vector <std::string> ({ "a", "e", "b" }));
+    }
+
+    void run ()
+    {
+        testOrder ();
+        testPerKey ();
+        testCapacity ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(IntakeQueue,app,ripple);
+
+} // test
+} // ripple
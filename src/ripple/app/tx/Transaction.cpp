@@ -24,6 +24,7 @@
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/protocol/JsonFields.h>
+#include <ripple/json/Object.h>
 
 namespace ripple {
 
@@ -93,25 +94,17 @@ void Transaction::setStatus (TransStatus ts, std::uint32_t lseq)
 Transaction::pointer Transaction::transactionFromSQL (
     Database* db, Validate validate)
 {
-    Serializer rawTxn;
     std::string status;
-    std::uint32_t inLedger;
-
-    int txSize = 2048;
-    rawTxn.resize (txSize);
-
     db->getStr ("Status", status);
-    inLedger = db->getInt ("LedgerSeq");
-    txSize = db->getBinary ("RawTxn", &*rawTxn.begin (), rawTxn.getLength ());
-
-    if (txSize > rawTxn.getLength ())
-    {
-        rawTxn.resize (txSize);
-        db->getBinary ("RawTxn", &*rawTxn.begin (), rawTxn.getLength ());
-    }
 
-    rawTxn.resize (txSize);
+    return transactionFromSQL (db->getInt ("LedgerSeq"), status,
+        db->getBinary ("RawTxn"), validate);
+}
 
+Transaction::pointer Transaction::transactionFromSQL (
+    LedgerIndex inLedger, std::string const& status, Blob const& rawTxn,
+    Validate validate)
+{
     SerialIter it (rawTxn);
     auto txn = std::make_shared<STTx> (it);
     auto tr = std::make_shared<Transaction> (txn, validate);
@@ -163,8 +156,8 @@ Transaction::pointer Transaction::transactionFromSQL (std::string const& sql)
     rawTxn.resize (txSize);
 
     {
-        auto sl (getApp().getTxnDB ().lock ());
-        auto db = getApp().getTxnDB ().getDB ();
+        auto reader (getApp().getTxnDB ().read ("tx"));
+        auto db = reader.getDB ();
 
         if (!db->executeSQL (sql, true) || !db->startIterRows ())
             return Transaction::pointer ();
@@ -256,6 +249,28 @@ Json::Value Transaction::getJson (int options, bool binary) const
     return ret;
 }
 
+void Transaction::writeJson (Json::Object& json, int options, bool binary) const
+{
+    if (binary)
+        copyFrom (json, mTransaction->getJson (0, true));
+    else
+        mTransaction->writeJson (json, 0);
+
+    if (mInLedger)
+    {
+        json[jss::inLedger] = mInLedger;        // Deprecated.
+        json[jss::ledger_index] = mInLedger;
+
+        if (options == 1)
+        {
+            auto ledger = getApp().getLedgerMaster ().
+                    getLedgerBySeq (mInLedger);
+            if (ledger)
+                json[jss::date] = ledger->getCloseTimeNC ();
+        }
+    }
+}
+
 bool Transaction::isHexTxID (std::string const& txid)
 {
     if (txid.size () != 64)
@@ -270,4 +285,18 @@ bool Transaction::isHexTxID (std::string const& txid)
     return (ret == txid.end ());
 }
 
+//------------------------------------------------------------------------------
+
+void writeJson (Json::Value& json, Transaction const& transaction,
+    int options, bool binary)
+{
+    Json::copyFrom (json, transaction.getJson (options, binary));
+}
+
+void writeJson (Json::Object& json, Transaction const& transaction,
+    int options, bool binary)
+{
+    transaction.writeJson (json, options, binary);
+}
+
 } // ripple
@@ -33,6 +33,14 @@ namespace ripple {
 
 class Database;
 
+} // ripple
+
+namespace Json {
+class Object;
+}
+
+namespace ripple {
+
 enum TransStatus
 {
     NEW         = 0, // just received / generated
@@ -65,6 +73,8 @@ public:
 
     static Transaction::pointer sharedTransaction (Blob const&, Validate);
     static Transaction::pointer transactionFromSQL (Database*, Validate);
+    static Transaction::pointer transactionFromSQL (LedgerIndex inLedger,
+        std::string const& status, Blob const& rawTxn, Validate);
 
     bool checkSign () const;
 
@@ -112,6 +122,9 @@ public:
 
     Json::Value getJson (int options, bool binary = false) const;
 
+    /** Write the same fields as getJson directly into a streaming object. */
+    void writeJson (Json::Object&, int options, bool binary = false) const;
+
     static Transaction::pointer load (uint256 const& id);
 
     static bool isHexTxID (std::string const&);
@@ -132,6 +145,11 @@ private:
     STTx::pointer mTransaction;
 };
 
+void writeJson (Json::Value&, Transaction const&, int options,
+    bool binary = false);
+void writeJson (Json::Object&, Transaction const&, int options,
+    bool binary = false);
+
 } // ripple
 
 #endif
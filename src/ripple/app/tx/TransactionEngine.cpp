@@ -38,6 +38,9 @@ void TransactionEngine::txnWrite ()
     {
         SLE::ref sleEntry = it.second.mEntry;
 
+        if (mWritten && (it.second.mAction != taaCACHED))
+            mWritten->insert (it.first);
+
         switch (it.second.mAction)
         {
         case taaNONE:
@@ -84,6 +87,16 @@ TER TransactionEngine::applyTransaction (
     STTx const& txn,
     TransactionEngineParams params,
     bool& didApply)
+{
+    TER const terResult = prepareTransaction (txn, params, didApply);
+
+    return commitTransaction (txn, terResult, params, didApply);
+}
+
+TER TransactionEngine::prepareTransaction (
+    STTx const& txn,
+    TransactionEngineParams params,
+    bool& didApply)
 {
     WriteLog (lsTRACE, TransactionEngine) << "applyTransaction>";
     didApply = false;
@@ -191,6 +204,17 @@ TER TransactionEngine::applyTransaction (
     else
         WriteLog (lsDEBUG, TransactionEngine) << "Not applying transaction " << txID;
 
+    return terResult;
+}
+
+TER TransactionEngine::commitTransaction (
+    STTx const& txn,
+    TER terResult,
+    TransactionEngineParams params,
+    bool& didApply)
+{
+    uint256 const& txID = txn.getTransactionID ();
+
     if (didApply)
     {
         if (!checkInvariants (terResult, txn, params))
@@ -22,6 +22,7 @@
 
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/app/ledger/LedgerEntrySet.h>
+#include <set>
 
 namespace ripple {
 
@@ -49,16 +50,20 @@ protected:
     Account             mTxnAccountID;
     SLE::pointer        mTxnAccount;
 
+    // If set, receives the index of every entry written to the ledger
+    std::set<uint256>*  mWritten;
+
     void                txnWrite ();
 
 public:
     typedef std::shared_ptr<TransactionEngine> pointer;
 
-    TransactionEngine () : mTxnSeq (0)
+    TransactionEngine () : mTxnSeq (0), mWritten (nullptr)
     {
         ;
     }
-    TransactionEngine (Ledger::ref ledger) : mLedger (ledger), mTxnSeq (0)
+    TransactionEngine (Ledger::ref ledger)
+        : mLedger (ledger), mTxnSeq (0), mWritten (nullptr)
     {
         assert (mLedger);
     }
@@ -99,6 +104,42 @@ public:
     }
 
     TER applyTransaction (const STTx&, TransactionEngineParams, bool & didApply);
+
+    /** Run a transaction without changing the ledger.
+
+        The changes the transaction would make are left in view () for
+        commitTransaction. applyTransaction is prepareTransaction followed
+        by commitTransaction.
+    */
+    TER prepareTransaction (const STTx&, TransactionEngineParams, bool & didApply);
+
+    /** Write the changes left in view () by prepareTransaction.
+
+        The result and didApply are those returned by prepareTransaction.
+    */
+    TER commitTransaction (const STTx&, TER result, TransactionEngineParams,
+        bool & didApply);
+
+    /** Take over changes prepared by another engine.
+
+        The other engine must have run against an unchanged snapshot of
+        this engine's ledger. Its view is left empty.
+    */
+    void adoptView (LedgerEntrySet& prepared)
+    {
+        mNodes.swapWith (prepared);
+        mNodes.setLedger (mLedger);
+        mNodes.setReadSet (nullptr);
+    }
+
+    /** Collect the index of every entry this engine writes to its ledger.
+
+        Pass null to stop collecting.
+    */
+    void trackWrites (std::set<uint256>* written)
+    {
+        mWritten = written;
+    }
     bool checkInvariants (TER result, const STTx & txn, TransactionEngineParams params);
 };
 
@@ -121,7 +121,7 @@ void TransactionMaster::sweep (void)
     mCache.sweep ();
 }
 
-TaggedCache <uint256, Transaction>& TransactionMaster::getCache()
+ShardedTaggedCache <uint256, Transaction>& TransactionMaster::getCache()
 {
     return mCache;
 }
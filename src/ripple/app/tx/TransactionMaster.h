@@ -21,6 +21,7 @@
 #define RIPPLE_APP_TX_TRANSACTIONMASTER_H_INCLUDED
 
 #include <ripple/app/tx/Transaction.h>
+#include <ripple/basics/ShardedTaggedCache.h>
 #include <ripple/shamap/SHAMapItem.h>
 #include <ripple/shamap/SHAMapTreeNode.h>
 
@@ -41,10 +42,10 @@ public:
     bool inLedger (uint256 const& hash, std::uint32_t ledger);
     bool canonicalize (Transaction::pointer* pTransaction);
     void sweep (void);
-    TaggedCache <uint256, Transaction>& getCache();
+    ShardedTaggedCache <uint256, Transaction>& getCache();
 
 private:
-    TaggedCache <uint256, Transaction> mCache;
+    ShardedTaggedCache <uint256, Transaction> mCache;
 };
 
 } // ripple
@@ -0,0 +1,283 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_BASICS_SHARDEDTAGGEDCACHE_H_INCLUDED
+#define RIPPLE_BASICS_SHARDEDTAGGEDCACHE_H_INCLUDED
+
+#include <ripple/basics/TaggedCache.h>
+#include <beast/Insight.h>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+/** A TaggedCache split into independently locked shards.
+
+    Keys are distributed over `Shards` separate TaggedCache instances,
+    each with its own mutex, so readers touching different keys rarely
+    contend. Sweeping visits one shard at a time; a reader is only ever
+    blocked by the sweep of the shard holding its key, and only for the
+    time it takes to walk that fraction of the cache.
+
+    The interface matches TaggedCache except that there is no peekMutex:
+    callers that need to lock the whole cache around compound operations
+    must use TaggedCache instead.
+*/
+template <
+    class Key,
+    class T,
+    class Hash = hardened_hash <>,
+    class KeyEqual = std::equal_to <Key>,
+    std::size_t Shards = 16
+>
+class ShardedTaggedCache
+{
+public:
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef std::shared_ptr <mapped_type> mapped_ptr;
+    typedef TaggedCache <Key, T, Hash, KeyEqual> shard_type;
+    typedef beast::abstract_clock <std::chrono::steady_clock> clock_type;
+
+    static_assert (Shards > 0, "ShardedTaggedCache needs at least one shard");
+
+    ShardedTaggedCache (std::string const& name, int size,
+        clock_type::rep expiration_seconds, clock_type& clock, beast::Journal journal,
+            beast::insight::Collector::ptr const& collector = beast::insight::NullCollector::New ())
+        : m_clock (clock)
+        , m_shards (makeShards (name, size, expiration_seconds, clock, journal))
+        , m_stats (name,
+            std::bind (&ShardedTaggedCache::collect_metrics, this),
+                collector)
+        , m_target_size (size)
+        , m_hits (0)
+        , m_misses (0)
+    {
+    }
+
+    /** Return the clock associated with the cache. */
+    clock_type& clock ()
+    {
+        return m_clock;
+    }
+
+    int getTargetSize () const
+    {
+        return m_target_size;
+    }
+
+    void setTargetSize (int s)
+    {
+        m_target_size = s;
+        for (auto& shard : m_shards)
+            shard->setTargetSize (shardSize (s));
+    }
+
+    clock_type::rep getTargetAge () const
+    {
+        return m_shards[0]->getTargetAge ();
+    }
+
+    void setTargetAge (clock_type::rep s)
+    {
+        for (auto& shard : m_shards)
+            shard->setTargetAge (s);
+    }
+
+    int getCacheSize ()
+    {
+        int size = 0;
+        for (auto& shard : m_shards)
+            size += shard->getCacheSize ();
+        return size;
+    }
+
+    int getTrackSize ()
+    {
+        int size = 0;
+        for (auto& shard : m_shards)
+            size += shard->getTrackSize ();
+        return size;
+    }
+
+    float getHitRate ()
+    {
+        auto const hits = static_cast<float> (m_hits.load ());
+        auto const total = hits + m_misses.load ();
+        return hits * (100.0f / std::max (1.0f, total));
+    }
+
+    void clearStats ()
+    {
+        m_hits = 0;
+        m_misses = 0;
+    }
+
+    void clear ()
+    {
+        for (auto& shard : m_shards)
+            shard->clear ();
+    }
+
+    /** Expire old entries, one shard at a time.
+        Only the shard being swept is locked; the others stay available.
+    */
+    void sweep ()
+    {
+        for (auto& shard : m_shards)
+            shard->sweep ();
+    }
+
+    bool del (key_type const& key, bool valid)
+    {
+        return shardFor (key).del (key, valid);
+    }
+
+    /** Replace aliased objects with originals.
+        @see TaggedCache::canonicalize
+    */
+    bool canonicalize (key_type const& key, std::shared_ptr<T>& data,
+        bool replace = false)
+    {
+        return shardFor (key).canonicalize (key, data, replace);
+    }
+
+    std::shared_ptr<T> fetch (key_type const& key)
+    {
+        auto result = shardFor (key).fetch (key);
+        if (result)
+            ++m_hits;
+        else
+            ++m_misses;
+        return result;
+    }
+
+    bool insert (key_type const& key, T const& value)
+    {
+        return shardFor (key).insert (key, value);
+    }
+
+    bool retrieve (key_type const& key, T& data)
+    {
+        mapped_ptr entry = fetch (key);
+
+        if (!entry)
+            return false;
+
+        data = *entry;
+        return true;
+    }
+
+    bool refreshIfPresent (key_type const& key)
+    {
+        return shardFor (key).refreshIfPresent (key);
+    }
+
+    std::vector <key_type> getKeys ()
+    {
+        std::vector <key_type> v;
+        for (auto& shard : m_shards)
+        {
+            auto keys = shard->getKeys ();
+            v.insert (v.end (), keys.begin (), keys.end ());
+        }
+        return v;
+    }
+
+private:
+    typedef std::array <std::unique_ptr <shard_type>, Shards> shards_type;
+
+    static shards_type makeShards (std::string const& name, int size,
+        clock_type::rep expiration_seconds, clock_type& clock,
+            beast::Journal journal)
+    {
+        shards_type shards;
+        for (auto& shard : shards)
+            shard.reset (new shard_type (name, shardSize (size),
+                expiration_seconds, clock, journal));
+        return shards;
+    }
+
+    static int shardSize (int size)
+    {
+        // Zero means "no target", keep it that way for every shard
+        if (size <= 0)
+            return size;
+        return std::max (1, static_cast<int> (
+            (size + Shards - 1) / Shards));
+    }
+
+    shard_type& shardFor (key_type const& key)
+    {
+        // The shard's own unordered_map buckets on the same hash, so pick
+        // the shard from the high bits to keep each shard's buckets evenly
+        // populated.
+        std::size_t const h = m_hash (key);
+        std::size_t const shift = std::numeric_limits<std::size_t>::digits - 16;
+        return *m_shards[(h >> shift) % Shards];
+    }
+
+    void collect_metrics ()
+    {
+        m_stats.size.set (getCacheSize ());
+
+        beast::insight::Gauge::value_type hit_rate (0);
+        auto const hits = m_hits.load ();
+        auto const total = hits + m_misses.load ();
+        if (total != 0)
+            hit_rate = (hits * 100) / total;
+        m_stats.hit_rate.set (hit_rate);
+    }
+
+    struct Stats
+    {
+        template <class Handler>
+        Stats (std::string const& prefix, Handler const& handler,
+            beast::insight::Collector::ptr const& collector)
+            : hook (collector->make_hook (handler))
+            , size (collector->make_gauge (prefix, "size"))
+            , hit_rate (collector->make_gauge (prefix, "hit_rate"))
+            { }
+
+        beast::insight::Hook hook;
+        beast::insight::Gauge size;
+        beast::insight::Gauge hit_rate;
+    };
+
+    clock_type& m_clock;
+    Hash m_hash;
+    shards_type m_shards;
+    Stats m_stats;
+
+    // Desired number of cache entries across all shards (0 = ignore)
+    std::atomic <int> m_target_size;
+
+    std::atomic <std::uint64_t> m_hits;
+    std::atomic <std::uint64_t> m_misses;
+};
+
+}
+
+#endif
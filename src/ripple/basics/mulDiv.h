@@ -0,0 +1,117 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_BASICS_MULDIV_H_INCLUDED
+#define RIPPLE_BASICS_MULDIV_H_INCLUDED
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+namespace ripple {
+
+namespace detail {
+
+// (a * b + c) / d by 64-bit shift-subtract long division, for compilers
+// without a 128-bit integer. d must not be zero.
+inline
+std::uint64_t
+mulDivPortable (std::uint64_t a, std::uint64_t b,
+    std::uint64_t c, std::uint64_t d)
+{
+    // Multiply using 32-bit halves
+    std::uint64_t const a0 = a & 0xffffffff, a1 = a >> 32;
+    std::uint64_t const b0 = b & 0xffffffff, b1 = b >> 32;
+    std::uint64_t const p00 = a0 * b0;
+    std::uint64_t const p01 = a0 * b1;
+    std::uint64_t const p10 = a1 * b0;
+    std::uint64_t const p11 = a1 * b1;
+    std::uint64_t const mid = (p00 >> 32) + (p01 & 0xffffffff) + (p10 & 0xffffffff);
+    std::uint64_t hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+    std::uint64_t lo = (mid << 32) | (p00 & 0xffffffff);
+
+    // Add c
+    lo += c;
+    if (lo < c)
+        ++hi;
+
+    // The quotient fits in 64 bits only if the high word is below d
+    if (hi >= d)
+        return std::numeric_limits<std::uint64_t>::max ();
+
+    // Shift-subtract long division, the quotient accumulates in lo
+    for (int i = 0; i < 64; ++i)
+    {
+        bool const carry = (hi >> 63) != 0;
+        hi = (hi << 1) | (lo >> 63);
+        lo <<= 1;
+        if (carry || hi >= d)
+        {
+            hi -= d;
+            lo |= 1;
+        }
+    }
+    return lo;
+}
+
+#if defined(__SIZEOF_INT128__)
+// (a * b + c) / d using the compiler's 128-bit integer. d must not be zero.
+inline
+std::uint64_t
+mulDiv128 (std::uint64_t a, std::uint64_t b,
+    std::uint64_t c, std::uint64_t d)
+{
+    unsigned __int128 const v =
+        static_cast<unsigned __int128> (a) * b + c;
+    unsigned __int128 const q = v / d;
+    if (q > std::numeric_limits<std::uint64_t>::max ())
+        return std::numeric_limits<std::uint64_t>::max ();
+    return static_cast<std::uint64_t> (q);
+}
+#endif
+
+}
+
+/** Return (a * b + c) / d using a 128-bit intermediate.
+
+    The product and sum never overflow. If the quotient does not fit in
+    64 bits the largest 64-bit value is returned, which is what the
+    OpenSSL BN_get_word based code this replaces produced.
+
+    @throws std::runtime_error if d is zero.
+*/
+inline
+std::uint64_t
+mulDiv (std::uint64_t a, std::uint64_t b,
+    std::uint64_t c, std::uint64_t d)
+{
+    if (d == 0)
+        throw std::runtime_error ("division by zero");
+
+#if defined(__SIZEOF_INT128__)
+    return detail::mulDiv128 (a, b, c, d);
+#else
+    return detail::mulDivPortable (a, b, c, d);
+#endif
+}
+
+} // ripple
+
+#endif
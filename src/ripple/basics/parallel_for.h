@@ -0,0 +1,149 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_BASICS_PARALLEL_FOR_H_INCLUDED
+#define RIPPLE_BASICS_PARALLEL_FOR_H_INCLUDED
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace ripple {
+
+namespace detail {
+
+struct parallel_for_state
+{
+    explicit parallel_for_state (std::size_t count_)
+        : count (count_)
+    {
+    }
+
+    std::size_t const count;
+    std::mutex mutex;
+    std::condition_variable idle;
+    std::size_t next = 0;
+    std::size_t active = 0;
+    bool stop = false;
+    std::exception_ptr error;
+};
+
+// Claims and runs items until they are exhausted or the set is stopped.
+template <class Function>
+void
+parallel_for_drain (parallel_for_state& state, Function& f)
+{
+    for (;;)
+    {
+        std::size_t i;
+        {
+            std::lock_guard <std::mutex> lock (state.mutex);
+            if (state.stop || state.next >= state.count)
+                return;
+            i = state.next++;
+            ++state.active;
+        }
+
+        bool more = false;
+        std::exception_ptr error;
+        try
+        {
+            more = f (i);
+        }
+        catch (...)
+        {
+            error = std::current_exception ();
+        }
+
+        std::lock_guard <std::mutex> lock (state.mutex);
+        if (error && ! state.error)
+            state.error = error;
+        if (error || ! more)
+            state.stop = true;
+        if (--state.active == 0)
+            state.idle.notify_all ();
+    }
+}
+
+}
+
+/** Run items [0, count) on the caller and up to `helpers` scheduled tasks.
+
+    `f (i)` processes item `i` and returns `false` to stop further items
+    from being claimed. `schedule` is handed a task for each helper; a task
+    may run on any thread, at any later time, or never, because the caller
+    claims items as well and only waits for items already claimed.
+
+    If `f` throws, no further items are claimed and the first exception is
+    rethrown on the caller once every claimed item has finished.
+
+    @return `true` if every item ran without being stopped.
+*/
+template <class Schedule, class Function>
+bool
+parallel_for (std::size_t count, std::size_t helpers,
+    Schedule&& schedule, Function&& f)
+{
+    auto state = std::make_shared <detail::parallel_for_state> (count);
+    auto const wait_idle = [&state] ()
+    {
+        std::unique_lock <std::mutex> lock (state->mutex);
+        state->idle.wait (lock, [&state] { return state->active == 0; });
+    };
+
+    // Helpers that start after the caller returns find nothing to claim,
+    // so they never touch `f` once it is out of scope.
+    helpers = std::min (helpers, count > 0 ? count - 1 : 0);
+    try
+    {
+        for (std::size_t i = 0; i < helpers; ++i)
+        {
+            schedule (std::function <void ()> ([state, &f] ()
+            {
+                detail::parallel_for_drain (*state, f);
+            }));
+        }
+    }
+    catch (...)
+    {
+        {
+            std::lock_guard <std::mutex> lock (state->mutex);
+            state->stop = true;
+        }
+        wait_idle ();
+        throw;
+    }
+
+    detail::parallel_for_drain (*state, f);
+    wait_idle ();
+
+    if (state->error)
+        std::rethrow_exception (state->error);
+
+    return ! state->stop;
+}
+
+} // ripple
+
+#endif
@@ -19,8 +19,16 @@
 
 #include <BeastConfig.h>
 #include <ripple/basics/TaggedCache.h>
+#include <ripple/basics/ShardedTaggedCache.h>
+#include <ripple/basics/tests/benchmark.h>
 #include <beast/unit_test/suite.h>
+#include <beast/unit_test/thread.h>
 #include <beast/chrono/manual_clock.h>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <vector>
 
 namespace ripple {
 
@@ -37,16 +45,15 @@ original object.
 class TaggedCache_test : public beast::unit_test::suite
 {
 public:
-    void run ()
+    template <class Cache>
+    void testCache ()
     {
         beast::Journal const j;
 
         beast::manual_clock <std::chrono::steady_clock> clock;
         clock.set (0);
 
-        typedef int Key;
-        typedef std::string Value;
-        typedef TaggedCache <Key, Value> Cache;
+        typedef typename Cache::mapped_type Value;
 
         Cache c ("test", 1, 1, clock, j);
 
@@ -78,7 +85,7 @@ public:
             expect (c.getTrackSize() == 1);
 
             {
-                Cache::mapped_ptr p (c.fetch (2));
+                typename Cache::mapped_ptr p (c.fetch (2));
                 expect (p != nullptr);
                 ++clock;
                 c.sweep ();
@@ -98,8 +105,8 @@ public:
             expect (! c.insert (3, "three"));
 
             {
-                Cache::mapped_ptr const p1 (c.fetch (3));
-                Cache::mapped_ptr p2 (std::make_shared <Value> ("three"));
+                typename Cache::mapped_ptr const p1 (c.fetch (3));
+                typename Cache::mapped_ptr p2 (std::make_shared <Value> ("three"));
                 c.canonicalize (3, p2);
                 expect (p1.get() == p2.get());
             }
@@ -120,7 +127,7 @@ public:
 
             {
                 // Keep a strong pointer to it
-                Cache::mapped_ptr p1 (c.fetch (4));
+                typename Cache::mapped_ptr p1 (c.fetch (4));
                 expect (p1 != nullptr);
                 expect (c.getCacheSize() == 1);
                 expect (c.getTrackSize() == 1);
@@ -130,7 +137,7 @@ public:
                 expect (c.getCacheSize() == 0);
                 expect (c.getTrackSize() == 1);
                 // Canonicalize a new object with the same key
-                Cache::mapped_ptr p2 (std::make_shared <std::string> ("four"));
+                typename Cache::mapped_ptr p2 (std::make_shared <std::string> ("four"));
                 expect (c.canonicalize (4, p2, false));
                 expect (c.getCacheSize() == 1);
                 expect (c.getTrackSize() == 1);
@@ -144,8 +151,100 @@ public:
             expect (c.getTrackSize() == 0);
         }
     }
+
+    void run ()
+    {
+        testcase ("TaggedCache");
+        testCache <TaggedCache <int, std::string>> ();
+
+        testcase ("ShardedTaggedCache");
+        testCache <ShardedTaggedCache <int, std::string>> ();
+    }
 };
 
 BEAST_DEFINE_TESTSUITE(TaggedCache,common,ripple);
 
+//------------------------------------------------------------------------------
+
+// Measures lookups per second with several reader threads while
+// another thread sweeps the cache in a loop.
+class TaggedCacheContention_test : public beast::unit_test::suite
+{
+public:
+    static std::size_t const items = 100000;
+    static std::size_t const lookups = 200000;
+
+    // Returns lookups per second across all reader threads
+    template <class Cache>
+    double
+    do_contend (std::size_t threads)
+    {
+        beast::Journal const j;
+        beast::manual_clock <std::chrono::steady_clock> clock;
+        clock.set (0);
+
+        // Nothing ever expires, so each sweep walks every entry
+        Cache c ("test", items, 3600, clock, j);
+        for (std::size_t i = 0; i < items; ++i)
+            c.insert (i, i);
+
+        std::atomic<bool> done (false);
+        beast::unit_test::thread sweeper (*this,
+            [&]()
+            {
+                while (! done)
+                    c.sweep ();
+            });
+
+        auto const read = [&](std::size_t seed)
+        {
+            std::mt19937 gen (seed);
+            std::uniform_int_distribution<std::size_t> dist (0, 2 * items - 1);
+            for (std::size_t n = 0; n < lookups; ++n)
+            {
+                auto const key = dist (gen);
+                if (! c.fetch (key))
+                {
+                    auto p = std::make_shared<std::size_t> (key);
+                    c.canonicalize (key, p);
+                }
+            }
+        };
+
+        auto const start = test::benchmark_clock::now();
+        std::vector<beast::unit_test::thread> t;
+        t.reserve (threads);
+        for (std::size_t i = 0; i < threads; ++i)
+            t.emplace_back (*this, read, i + 1);
+        for (auto& _ : t)
+            _.join();
+        auto const elapsed = test::seconds_since (start);
+
+        done = true;
+        sweeper.join();
+
+        return test::per_second (lookups * threads, elapsed);
+    }
+
+    void
+    run () override
+    {
+        typedef TaggedCache <std::size_t, std::size_t> Plain;
+        typedef ShardedTaggedCache <std::size_t, std::size_t> Sharded;
+
+        testcase ("contention");
+        for (std::size_t threads : { 1, 2, 4, 8, 16 })
+        {
+            auto const plain = do_contend <Plain> (threads);
+            auto const sharded = do_contend <Sharded> (threads);
+            log << std::setw(3) << threads << " threads: " <<
+                test::format_rate (plain) << " lookups/s plain, " <<
+                test::format_rate (sharded) << " lookups/s sharded";
+        }
+        pass ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(TaggedCacheContention,common,ripple);
+
 }
@@ -0,0 +1,74 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_BASICS_TESTS_BENCHMARK_H_INCLUDED
+#define RIPPLE_BASICS_TESTS_BENCHMARK_H_INCLUDED
+
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace ripple {
+namespace test {
+
+// Helpers shared by the manual timing suites.
+
+using benchmark_clock = std::chrono::steady_clock;
+
+/** Returns the length of a duration in seconds. */
+inline
+double
+to_seconds (benchmark_clock::duration d)
+{
+    return std::chrono::duration_cast<
+        std::chrono::duration<double>>(d).count();
+}
+
+/** Returns the seconds elapsed since start. */
+inline
+double
+seconds_since (benchmark_clock::time_point start)
+{
+    return to_seconds (benchmark_clock::now() - start);
+}
+
+/** Returns count per second, or zero if no time was measured. */
+inline
+double
+per_second (double count, double seconds)
+{
+    return seconds > 0 ? count / seconds : 0;
+}
+
+/** Formats a rate for the log, as a whole number by default. */
+inline
+std::string
+format_rate (double rate, int precision = 0)
+{
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(precision) << rate;
+    return ss.str();
+}
+
+} // test
+} // ripple
+
+#endif
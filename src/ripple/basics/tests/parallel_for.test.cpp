@@ -0,0 +1,249 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/basics/parallel_for.h>
+#include <beast/unit_test/suite.h>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+
+class parallel_for_test : public beast::unit_test::suite
+{
+public:
+    // Runs each helper on its own thread, joined by the destructor.
+    struct thread_scheduler
+    {
+        std::vector <std::thread> threads;
+
+        ~thread_scheduler ()
+        {
+            for (auto& t : threads)
+                t.join ();
+        }
+
+        void operator() (std::function <void ()> task)
+        {
+            threads.emplace_back (std::move (task));
+        }
+    };
+
+    // Holds helpers until the caller decides to run them.
+    struct deferred_scheduler
+    {
+        std::vector <std::function <void ()>> tasks;
+
+        void operator() (std::function <void ()> task)
+        {
+            tasks.push_back (std::move (task));
+        }
+
+        void run ()
+        {
+            for (auto& task : tasks)
+                task ();
+        }
+    };
+
+    void testAllItems ()
+    {
+        testcase ("all items");
+
+        std::size_t const count = 1000;
+        std::vector <std::atomic <int>> seen (count);
+        for (auto& s : seen)
+            s = 0;
+
+        {
+            thread_scheduler scheduler;
+            expect (parallel_for (count, 3, std::ref (scheduler),
+                [&] (std::size_t i)
+                {
+                    ++seen[i];
+                    return true;
+                }));
+        }
+
+        bool once = true;
+        for (auto& s : seen)
+            once = once && (s == 1);
+        expect (once, "every item runs exactly once");
+
+        // Helpers that never run leave the caller to do everything
+        int ran = 0;
+        deferred_scheduler scheduler;
+        expect (parallel_for (10, 3, std::ref (scheduler),
+            [&] (std::size_t)
+            {
+                ++ran;
+                return true;
+            }));
+        expect (ran == 10);
+        expect (scheduler.tasks.size () == 3);
+
+        // Late helpers find nothing left to claim
+        scheduler.run ();
+        expect (ran == 10);
+
+        // No helpers are scheduled for an empty set
+        deferred_scheduler empty;
+        expect (parallel_for (0, 3, std::ref (empty),
+            [] (std::size_t) { return true; }));
+        expect (empty.tasks.empty ());
+    }
+
+    void testStop ()
+    {
+        testcase ("stop");
+
+        int ran = 0;
+        deferred_scheduler scheduler;
+        expect (! parallel_for (10, 3, std::ref (scheduler),
+            [&] (std::size_t i)
+            {
+                ++ran;
+                return i < 4;
+            }));
+        expect (ran == 5);
+        scheduler.run ();
+        expect (ran == 5);
+    }
+
+    void testException ()
+    {
+        testcase ("exception");
+
+        // Thrown on the caller
+        {
+            int ran = 0;
+            deferred_scheduler scheduler;
+            try
+            {
+                parallel_for (10, 3, std::ref (scheduler),
+                    [&] (std::size_t i)
+                    {
+                        ++ran;
+                        if (i == 2)
+                            throw std::runtime_error ("item");
+                        return true;
+                    });
+                fail ("exception not propagated");
+            }
+            catch (std::runtime_error const& e)
+            {
+                expect (std::string (e.what ()) == "item");
+            }
+            expect (ran == 3);
+            scheduler.run ();
+            expect (ran == 3);
+        }
+
+        // Thrown by a helper that runs inline while being scheduled
+        {
+            int ran = 0;
+            try
+            {
+                parallel_for (10, 3,
+                    [] (std::function <void ()> task) { task (); },
+                    [&] (std::size_t i)
+                    {
+                        ++ran;
+                        if (i == 5)
+                            throw std::runtime_error ("inline");
+                        return true;
+                    });
+                fail ("exception not propagated");
+            }
+            catch (std::runtime_error const& e)
+            {
+                expect (std::string (e.what ()) == "inline");
+            }
+            expect (ran == 6);
+        }
+
+        // Thrown on a helper thread while the caller is still working
+        {
+            auto const caller = std::this_thread::get_id ();
+            std::atomic <bool> thrown (false);
+            try
+            {
+                thread_scheduler scheduler;
+                parallel_for (1000, 3, std::ref (scheduler),
+                    [&] (std::size_t)
+                    {
+                        if (std::this_thread::get_id () != caller)
+                        {
+                            thrown = true;
+                            throw std::runtime_error ("helper");
+                        }
+                        while (! thrown)
+                            std::this_thread::yield ();
+                        return true;
+                    });
+                fail ("exception not propagated");
+            }
+            catch (std::runtime_error const& e)
+            {
+                expect (std::string (e.what ()) == "helper");
+            }
+        }
+
+        // Thrown while scheduling helpers
+        {
+            int ran = 0;
+            int scheduled = 0;
+            try
+            {
+                parallel_for (10, 3,
+                    [&] (std::function <void ()>)
+                    {
+                        if (++scheduled == 2)
+                            throw std::runtime_error ("schedule");
+                    },
+                    [&] (std::size_t)
+                    {
+                        ++ran;
+                        return true;
+                    });
+                fail ("exception not propagated");
+            }
+            catch (std::runtime_error const& e)
+            {
+                expect (std::string (e.what ()) == "schedule");
+            }
+            expect (ran == 0);
+        }
+    }
+
+    void run ()
+    {
+        testAllItems ();
+        testStop ();
+        testException ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(parallel_for,basics,ripple);
+
+} // ripple
@@ -248,6 +248,7 @@ public:
     // Peer networking parameters
     bool                        PEER_PRIVATE;           // True to ask peers not to relay current IP.
     unsigned int                PEERS_MAX;
+    int                         LEDGER_REQUEST_WINDOW;  // Ledger node requests outstanding per peer
 
     int                         WEBSOCKET_PING_FREQ;
 
@@ -282,6 +283,9 @@ public:
     // Node storage configuration
     std::uint32_t                      LEDGER_HISTORY;
     std::uint32_t                      FETCH_DEPTH;
+    bool                               ASYNC_LEDGER_SAVE;      // Save published ledgers to SQL in a job
+    int                                LEDGER_APPLY_THREADS;   // Threads applying the consensus set
+    int                                DATABASE_READERS;       // Read-only SQL connections per database
     int                         NODE_SIZE;
 
     // Client behavior
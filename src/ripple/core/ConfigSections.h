@@ -33,7 +33,9 @@ struct ConfigSection
 // VFALCO TODO Rename and replace these macros with variables.
 #define SECTION_ACCOUNT_PROBE_MAX       "account_probe_max"
 #define SECTION_AMENDMENTS              "amendments"
+#define SECTION_ASYNC_LEDGER_SAVE       "async_ledger_save"
 #define SECTION_CLUSTER_NODES           "cluster_nodes"
+#define SECTION_DATABASE_READERS        "database_readers"
 #define SECTION_DEBUG_LOGFILE           "debug_logfile"
 #define SECTION_ELB_SUPPORT             "elb_support"
 #define SECTION_FEE_DEFAULT             "fee_default"
@@ -42,7 +44,9 @@ struct ConfigSection
 #define SECTION_FEE_ACCOUNT_RESERVE     "fee_account_reserve"
 #define SECTION_FEE_OWNER_RESERVE       "fee_owner_reserve"
 #define SECTION_FETCH_DEPTH             "fetch_depth"
+#define SECTION_LEDGER_APPLY_THREADS    "ledger_apply_threads"
 #define SECTION_LEDGER_HISTORY          "ledger_history"
+#define SECTION_LEDGER_REQUEST_WINDOW   "ledger_request_window"
 #define SECTION_INSIGHT                 "insight"
 #define SECTION_IPS                     "ips"
 #define SECTION_IPS_FIXED               "ips_fixed"
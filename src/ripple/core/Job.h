@@ -38,6 +38,7 @@ enum JobType
     // insert a job at a specific priority, simply add it at the right location.
 
     jtPACK,          // Make a fetch pack for a peer
+    jtPACK_WALK,     // Help walk the maps of a fetch pack
     jtPUBOLDLEDGER,  // An old ledger has been accepted
     jtVALIDATION_ut, // A validation from an untrusted source
     jtPROOFWORK,     // A proof of work demand from another server
@@ -108,7 +109,7 @@ public:
          std::string const& name,
          std::uint64_t index,
          LoadMonitor& lm,
-         std::function <void (Job&)> const& job,
+         std::function <void (Job&)> job,
          CancelCallback cancelCallback);
 
     //Job& operator= (Job const& other);
@@ -24,7 +24,7 @@
 #include <ripple/json/json_value.h>
 #include <beast/insight/Collector.h>
 #include <beast/threads/Stoppable.h>
-#include <boost/function.hpp>
+#include <functional>
 
 namespace ripple {
 
@@ -36,13 +36,8 @@ protected:
 public:
     virtual ~JobQueue () { }
 
-    // VFALCO NOTE Using boost::function here because Visual Studio 2012
-    //             std::function doesn't swallow return types.
-    //
-    //        TODO Replace with std::function
-    //
     virtual void addJob (JobType type,
-        std::string const& name, boost::function <void (Job&)> const& job) = 0;
+        std::string const& name, std::function <void (Job&)> job) = 0;
 
     // Jobs waiting at this priority
     virtual int getJobCount (JobType t) = 0;
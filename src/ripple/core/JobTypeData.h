@@ -21,6 +21,7 @@
 #define RIPPLE_CORE_JOBTYPEDATA_H_INCLUDED
 
 #include <ripple/core/JobTypeInfo.h>
+#include <atomic>
 
 namespace ripple
 {
@@ -37,11 +38,13 @@ public:
     /* The job category which we represent */
     JobTypeInfo const& info;
 
-    /* The number of jobs waiting */
-    int waiting;
+    /* The number of jobs waiting. Only changed while holding the
+       JobQueue lock, but may be read without it.
+    */
+    std::atomic <int> waiting;
 
-    /* The number presently running */
-    int running;
+    /* The number presently running. Same rules as waiting. */
+    std::atomic <int> running;
 
     /* And the number we deferred executing because of job limits */
     int deferred;
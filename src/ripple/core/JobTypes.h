@@ -43,6 +43,10 @@ public:
         add (jtPACK,          "makeFetchPack",
             1,        true,   false, 0,     0);
 
+        // Help walk the maps of the fetch pack being made
+        add (jtPACK_WALK,     "makeFetchPackWalk",
+            3,        true,   false, 0,     0);
+
         // An old ledger has been accepted
         add (jtPUBOLDLEDGER,  "publishAcqLedger",
             2,        true,   false, 10000, 15000);
@@ -249,6 +249,10 @@ Config::Config ()
 
     LEDGER_HISTORY          = 256;
     FETCH_DEPTH             = 1000000000;
+    ASYNC_LEDGER_SAVE       = false;
+    LEDGER_APPLY_THREADS    = 1;
+    DATABASE_READERS        = 4;
+    LEDGER_REQUEST_WINDOW   = 4;
 
     // An explanation of these magical values would be nice.
     PATH_SEARCH_OLD         = 7;
@@ -585,6 +589,39 @@ void Config::loadFromString (std::string const& fileContents)
             FETCH_DEPTH = 10;
     }
 
+    if (getSingleSection (secConfig, SECTION_ASYNC_LEDGER_SAVE, strTemp))
+        ASYNC_LEDGER_SAVE   = beast::lexicalCastThrow <bool> (strTemp);
+
+    if (getSingleSection (secConfig, SECTION_DATABASE_READERS, strTemp))
+    {
+        DATABASE_READERS = beast::lexicalCastThrow <int> (strTemp);
+
+        if (DATABASE_READERS < 0)
+            DATABASE_READERS = 0;
+        else if (DATABASE_READERS > 32)
+            DATABASE_READERS = 32;
+    }
+
+    if (getSingleSection (secConfig, SECTION_LEDGER_APPLY_THREADS, strTemp))
+    {
+        LEDGER_APPLY_THREADS = beast::lexicalCastThrow <int> (strTemp);
+
+        if (LEDGER_APPLY_THREADS < 1)
+            LEDGER_APPLY_THREADS = 1;
+        else if (LEDGER_APPLY_THREADS > 16)
+            LEDGER_APPLY_THREADS = 16;
+    }
+
+    if (getSingleSection (secConfig, SECTION_LEDGER_REQUEST_WINDOW, strTemp))
+    {
+        LEDGER_REQUEST_WINDOW = beast::lexicalCastThrow <int> (strTemp);
+
+        if (LEDGER_REQUEST_WINDOW < 1)
+            LEDGER_REQUEST_WINDOW = 1;
+        else if (LEDGER_REQUEST_WINDOW > 16)
+            LEDGER_REQUEST_WINDOW = 16;
+    }
+
     if (getSingleSection (secConfig, SECTION_PATH_SEARCH_OLD, strTemp))
         PATH_SEARCH_OLD     = beast::lexicalCastThrow <int> (strTemp);
     if (getSingleSection (secConfig, SECTION_PATH_SEARCH, strTemp))
@@ -38,12 +38,12 @@ Job::Job (JobType type,
           std::string const& name,
           std::uint64_t index,
           LoadMonitor& lm,
-          std::function <void (Job&)> const& job,
+          std::function <void (Job&)> job,
           CancelCallback cancelCallback)
     : m_cancelCallback (cancelCallback)
     , mType (type)
     , mJobIndex (index)
-    , mJob (job)
+    , mJob (std::move (job))
     , mName (name)
     , m_queue_time (clock_type::now ())
 {
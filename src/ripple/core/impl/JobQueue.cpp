@@ -25,10 +25,13 @@
 #include <beast/cxx14/memory.h>
 #include <beast/chrono/chrono_util.h>
 #include <beast/module/core/thread/Workers.h>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <deque>
 #include <mutex>
-#include <set>
 #include <thread>
+#include <vector>
 
 namespace ripple {
 
@@ -37,15 +40,24 @@ class JobQueueImp
     , private beast::Workers::Callback
 {
 public:
-    typedef std::set <Job> JobSet;
-    typedef std::map <JobType, JobTypeData> JobDataMap;
+    typedef std::deque <Job> JobDeque;
     typedef std::lock_guard <std::mutex> ScopedLock;
 
     beast::Journal m_journal;
     std::mutex m_mutex;
-    std::uint64_t m_lastJob;
-    JobSet m_jobSet;
-    JobDataMap m_jobData;
+    std::atomic <std::uint64_t> m_lastJob;
+
+    // Waiting jobs, one FIFO per job type, indexed by JobType.
+    // Since JobType order is priority order, the next job to run
+    // is found by scanning from the back.
+    std::vector <JobDeque> m_jobQueues;
+
+    // Total number of waiting jobs
+    std::size_t m_jobCount;
+
+    // Dynamic information for each job type, indexed by JobType.
+    // The vector is not modified after construction.
+    std::vector <std::unique_ptr <JobTypeData>> m_jobData;
     JobTypeData m_invalidJobData;
 
     // The number of jobs currently in processTask()
@@ -73,6 +85,7 @@ public:
         : JobQueue ("JobQueue", parent)
         , m_journal (journal)
         , m_lastJob (0)
+        , m_jobCount (0)
         , m_invalidJobData (getJobTypes ().getInvalid (), collector)
         , m_processCount (0)
         , m_workers (*this, "JobQueue", 0)
@@ -83,21 +96,21 @@ public:
             &JobQueueImp::collect, this));
         job_count = m_collector->make_gauge ("job_count");
 
+        for (auto const& x : getJobTypes ())
         {
-            ScopedLock lock (m_mutex);
+            JobTypeInfo const& jt = x.second;
+            assert (jt.type () >= 0);
 
-            for (auto const& x : getJobTypes ())
-            {
-                JobTypeInfo const& jt = x.second;
-
-                // And create dynamic information for all jobs
-                auto const result (m_jobData.emplace (std::piecewise_construct,
-                    std::forward_as_tuple (jt.type ()),
-                    std::forward_as_tuple (jt, m_collector)));
-                assert (result.second == true);
-                (void) result.second;
-            }
+            if (m_jobData.size () <= static_cast <std::size_t> (jt.type ()))
+                m_jobData.resize (jt.type () + 1);
+
+            // And create dynamic information for all jobs
+            assert (m_jobData[jt.type ()] == nullptr);
+            m_jobData[jt.type ()] = std::make_unique <JobTypeData> (
+                jt, m_collector);
         }
+
+        m_jobQueues.resize (m_jobData.size ());
     }
 
     ~JobQueueImp ()
@@ -109,22 +122,20 @@ public:
     void collect ()
     {
         ScopedLock lock (m_mutex);
-        job_count = m_jobSet.size ();
+        job_count = m_jobCount;
     }
 
     void addJob (JobType type, std::string const& name,
-        boost::function <void (Job&)> const& jobFunc)
+        std::function <void (Job&)> jobFunc)
     {
         assert (type != jtINVALID);
 
-        JobDataMap::iterator iter (m_jobData.find (type));
-        assert (iter != m_jobData.end ());
+        JobTypeData* const data (findJobTypeData (type));
+        assert (data != nullptr);
 
-        if (iter == m_jobData.end ())
+        if (data == nullptr)
             return;
 
-        JobTypeData& data (iter->second);
-
         // FIXME: Workaround incorrect client shutdown ordering
         // do not add jobs to a queue with no threads
         assert (type == jtCLIENT || m_workers.getNumberOfThreads () > 0);
@@ -144,50 +155,49 @@ public:
             ScopedLock lock (m_mutex);
             assert (! isStopped() && (
                 m_processCount>0 ||
-                ! m_jobSet.empty () ||
+                m_jobCount != 0 ||
                 ! areChildrenStopped()));
         }
 
         // Don't even add it to the queue if we're stopping
         // and the job type is marked for skipOnStop.
         //
-        if (isStopping() && skipOnStop (type))
+        if (isStopping() && data->info.skip ())
         {
             m_journal.debug <<
                 "Skipping addJob ('" << name << "')";
             return;
         }
 
+        // Build the job outside the lock, it allocates
+        Job job (type, name, ++m_lastJob,
+            data->load (), std::move (jobFunc), m_cancelCallback);
+
         {
             ScopedLock lock (m_mutex);
 
-            std::pair <std::set <Job>::iterator, bool> result (
-                m_jobSet.insert (Job (type, name, ++m_lastJob,
-                    data.load (), jobFunc, m_cancelCallback)));
-            queueJob (*result.first, lock);
+            m_jobQueues[type].push_back (std::move (job));
+            ++m_jobCount;
+            queueJob (*data, lock);
         }
     }
 
     int getJobCount (JobType t)
     {
-        ScopedLock lock (m_mutex);
-
-        JobDataMap::const_iterator c = m_jobData.find (t);
+        JobTypeData const* const data (findJobTypeData (t));
 
-        return (c == m_jobData.end ())
+        return (data == nullptr)
             ? 0
-            : c->second.waiting;
+            : data->waiting.load ();
     }
 
     int getJobCountTotal (JobType t)
     {
-        ScopedLock lock (m_mutex);
-
-        JobDataMap::const_iterator c = m_jobData.find (t);
+        JobTypeData const* const data (findJobTypeData (t));
 
-        return (c == m_jobData.end ())
+        return (data == nullptr)
             ? 0
-            : (c->second.waiting + c->second.running);
+            : (data->waiting + data->running);
     }
 
     int getJobCountGE (JobType t)
@@ -195,12 +205,11 @@ public:
         // return the number of jobs at this priority level or greater
         int ret = 0;
 
-        ScopedLock lock (m_mutex);
-
-        for (auto const& x : m_jobData)
+        for (std::size_t i = std::max (static_cast <int> (t), 0);
+            i < m_jobData.size (); ++i)
         {
-            if (x.first >= t)
-                ret += x.second.waiting;
+            if (m_jobData[i])
+                ret += m_jobData[i]->waiting;
         }
 
         return ret;
@@ -237,34 +246,34 @@ public:
 
     LoadEvent::pointer getLoadEvent (JobType t, std::string const& name)
     {
-        JobDataMap::iterator iter (m_jobData.find (t));
-        assert (iter != m_jobData.end ());
+        JobTypeData* const data (findJobTypeData (t));
+        assert (data != nullptr);
 
-        if (iter == m_jobData.end ())
+        if (data == nullptr)
             return std::shared_ptr<LoadEvent> ();
 
         return std::make_shared<LoadEvent> (
-            std::ref (iter-> second.load ()), name, true);
+            std::ref (data->load ()), name, true);
     }
 
     LoadEvent::autoptr getLoadEventAP (JobType t, std::string const& name)
     {
-        JobDataMap::iterator iter (m_jobData.find (t));
-        assert (iter != m_jobData.end ());
+        JobTypeData* const data (findJobTypeData (t));
+        assert (data != nullptr);
 
-        if (iter == m_jobData.end ())
+        if (data == nullptr)
             return LoadEvent::autoptr ();
 
         return LoadEvent::autoptr (
-            new LoadEvent (iter-> second.load (), name, true));
+            new LoadEvent (data->load (), name, true));
     }
 
     void addLoadEvents (JobType t,
         int count, std::chrono::milliseconds elapsed)
     {
-        JobDataMap::iterator iter (m_jobData.find (t));
-        assert (iter != m_jobData.end ());
-        iter->second.load().addSamples (count, elapsed);
+        JobTypeData* const data (findJobTypeData (t));
+        assert (data != nullptr);
+        data->load().addSamples (count, elapsed);
     }
 
     bool isOverloaded ()
@@ -273,7 +282,7 @@ public:
 
         for (auto& x : m_jobData)
         {
-            if (x.second.load ().isOver ())
+            if (x && x->load ().isOver ())
                 ++count;
         }
 
@@ -288,16 +297,12 @@ public:
 
         Json::Value priorities = Json::arrayValue;
 
-        ScopedLock lock (m_mutex);
-
         for (auto& x : m_jobData)
         {
-            assert (x.first != jtINVALID);
-
-            if (x.first == jtGENERIC)
+            if (x == nullptr || x->type () == jtGENERIC)
                 continue;
 
-            JobTypeData& data (x.second);
+            JobTypeData& data (*x);
 
             LoadMonitor::Stats stats (data.stats ());
 
@@ -338,17 +343,26 @@ public:
 
 private:
     //--------------------------------------------------------------------------
+    // Returns nullptr if the type is not a known job type
+    JobTypeData* findJobTypeData (JobType type) const
+    {
+        if (type < 0 || static_cast <std::size_t> (type) >= m_jobData.size ())
+            return nullptr;
+
+        return m_jobData[type].get ();
+    }
+
     JobTypeData& getJobTypeData (JobType type)
     {
-        JobDataMap::iterator c (m_jobData.find (type));
-        assert (c != m_jobData.end ());
+        JobTypeData* const data (findJobTypeData (type));
+        assert (data != nullptr);
 
         // NIKB: This is ugly and I hate it. We must remove jtINVALID completely
         //       and use something sane.
-        if (c == m_jobData.end ())
+        if (data == nullptr)
             return m_invalidJobData;
 
-        return c->second;
+        return *data;
     }
 
     //--------------------------------------------------------------------------
@@ -362,12 +376,12 @@ private:
         //  1. A stop notification was received
         //  2. All Stoppable children have stopped
         //  3. There are no executing calls to processTask
-        //  4. There are no remaining Jobs in the job set
+        //  4. There are no remaining waiting Jobs
         //
         if (isStopping() &&
             areChildrenStopped() &&
             (m_processCount == 0) &&
-            m_jobSet.empty())
+            (m_jobCount == 0))
         {
             stopped();
         }
@@ -379,7 +393,7 @@ private:
     //
     // Pre-conditions:
     //  The JobType must be valid.
-    //  The Job must exist in mJobSet.
+    //  The Job must have been appended to the queue for its type.
     //  The Job must not have previously been queued.
     //
     // Post-conditions:
@@ -389,15 +403,11 @@ private:
     // Invariants:
     //  The calling thread owns the JobLock
     //
-    void queueJob (Job const& job, ScopedLock const& lock)
+    void queueJob (JobTypeData& data, ScopedLock const& lock)
     {
-        JobType const type (job.getType ());
-        assert (type != jtINVALID);
-        assert (m_jobSet.find (job) != m_jobSet.end ());
+        assert (data.type () != jtINVALID);
 
-        JobTypeData& data (getJobTypeData (type));
-
-        if (data.waiting + data.running < getJobLimit (type))
+        if (data.waiting + data.running < data.info.limit ())
         {
             m_workers.addTask ();
         }
@@ -415,15 +425,15 @@ private:
     // Returns the next Job we should run now.
     //
     // RunnableJob:
-    //  A Job in the JobSet whose slots count for its type is greater than zero.
+    //  A waiting Job whose slots count for its type is greater than zero.
     //
     // Pre-conditions:
-    //  mJobSet must not be empty.
-    //  mJobSet holds at least one RunnableJob
+    //  There is at least one waiting Job.
+    //  At least one waiting Job is a RunnableJob.
     //
     // Post-conditions:
-    //  job is a valid Job object.
-    //  job is removed from mJobQueue.
+    //  job is the oldest RunnableJob of the highest priority type.
+    //  job is removed from the queue for its type.
     //  Waiting job count of its type is decremented
     //  Running job count of its type is incremented
     //
@@ -432,35 +442,36 @@ private:
     //
     void getNextJob (Job& job, ScopedLock const& lock)
     {
-        assert (! m_jobSet.empty ());
+        assert (m_jobCount != 0);
 
-        JobSet::const_iterator iter;
-        for (iter = m_jobSet.begin (); iter != m_jobSet.end (); ++iter)
+        // Later job types have higher priority
+        for (std::size_t i = m_jobQueues.size (); i-- > 0;)
         {
-            JobTypeData& data (getJobTypeData (iter->getType ()));
+            JobDeque& queue (m_jobQueues[i]);
+
+            if (queue.empty ())
+                continue;
+
+            JobTypeData& data (*m_jobData[i]);
 
-            assert (data.running <= getJobLimit (data.type ()));
+            assert (data.running <= data.info.limit ());
 
             // Run this job if we're running below the limit.
-            if (data.running < getJobLimit (data.type ()))
+            if (data.running < data.info.limit ())
             {
                 assert (data.waiting > 0);
-                break;
-            }
-        }
-
-        assert (iter != m_jobSet.end ());
-
-        JobType const type = iter->getType ();
-        JobTypeData& data (getJobTypeData (type));
 
-        assert (type != jtINVALID);
+                job = std::move (queue.front ());
+                queue.pop_front ();
+                --m_jobCount;
 
-        job = *iter;
-        m_jobSet.erase (iter);
+                --data.waiting;
+                ++data.running;
+                return;
+            }
+        }
 
-        --data.waiting;
-        ++data.running;
+        assert (false);
     }
 
     //------------------------------------------------------------------------------
@@ -468,7 +479,7 @@ private:
     // Indicates that a running Job has completed its task.
     //
     // Pre-conditions:
-    //  Job must not exist in mJobSet.
+    //  Job must not be waiting.
     //  The JobType must not be invalid.
     //
     // Post-conditions:
@@ -482,7 +493,6 @@ private:
     {
         JobType const type = job.getType ();
 
-        assert (m_jobSet.find (job) == m_jobSet.end ());
         assert (type != jtINVALID);
 
         JobTypeData& data (getJobTypeData (type));
@@ -490,7 +500,7 @@ private:
         // Queue a deferred task if possible
         if (data.deferred > 0)
         {
-            assert (data.running + data.waiting >= getJobLimit (type));
+            assert (data.running + data.waiting >= data.info.limit ());
 
             --data.deferred;
             m_workers.addTask ();
@@ -525,7 +535,7 @@ private:
     // Runs the next appropriate waiting Job.
     //
     // Pre-conditions:
-    //  A RunnableJob must exist in the JobSet
+    //  A RunnableJob must be waiting
     //
     // Post-conditions:
     //  The chosen RunnableJob will have Job::doJob() called.
@@ -578,32 +588,6 @@ private:
 
     //------------------------------------------------------------------------------
 
-    // Returns `true` if all jobs of this type should be skipped when
-    // the JobQueue receives a stop notification. If the job type isn't
-    // skipped, the Job will be called and the job must call Job::shouldCancel
-    // to determine if a long running or non-mandatory operation should be canceled.
-    bool skipOnStop (JobType type)
-    {
-        JobTypeInfo const& j (getJobTypes ().get (type));
-        assert (j.type () != jtINVALID);
-
-        return j.skip ();
-    }
-
-    // Returns the limit of running jobs for the given job type.
-    // For jobs with no limit, we return the largest int. Hopefully that
-    // will be enough.
-    //
-    int getJobLimit (JobType type)
-    {
-        JobTypeInfo const& j (getJobTypes ().get (type));
-        assert (j.type () != jtINVALID);
-
-        return j.limit ();
-    }
-
-    //--------------------------------------------------------------------------
-
     void onStop ()
     {
         // VFALCO NOTE I wanted to remove all the jobs that are skippable
@@ -0,0 +1,104 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/basics/tests/benchmark.h>
+#include <beast/insight/NullCollector.h>
+#include <beast/threads/Stoppable.h>
+#include <beast/unit_test/suite.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <mutex>
+
+namespace ripple {
+
+// Measures the time from addJob to the start of the job, and the
+// number of jobs run per second, for a range of thread counts.
+class JobQueue_test : public beast::unit_test::suite
+{
+public:
+#ifndef NDEBUG
+    std::size_t const default_jobs = 100000;
+#else
+    std::size_t const default_jobs = 1000000; // release
+#endif
+
+    void
+    do_run (std::size_t jobs, int threads)
+    {
+        beast::RootStoppable root ("root");
+        std::unique_ptr <JobQueue> jq (make_JobQueue (
+            beast::insight::NullCollector::New (), root, beast::Journal ()));
+        jq->setThreadCount (threads, false);
+        root.start ();
+
+        std::mutex m;
+        std::condition_variable cv;
+        std::size_t remaining (jobs);
+        std::atomic <std::uint64_t> latency (0);
+
+        auto const start = test::benchmark_clock::now();
+        for (std::size_t i = 0; i < jobs; ++i)
+        {
+            auto const queued = test::benchmark_clock::now();
+            jq->addJob (jtCLIENT, "bench",
+                [&, queued](Job&)
+                {
+                    latency += std::chrono::duration_cast <
+                        std::chrono::nanoseconds> (
+                            test::benchmark_clock::now() - queued).count();
+                    std::lock_guard <std::mutex> lock (m);
+                    if (--remaining == 0)
+                        cv.notify_all ();
+                });
+        }
+
+        {
+            std::unique_lock <std::mutex> lock (m);
+            cv.wait (lock, [&]{ return remaining == 0; });
+        }
+        auto const seconds = test::seconds_since (start);
+
+        root.stop ();
+
+        log << std::setw(3) << threads << " threads: " <<
+            test::format_rate (test::per_second (jobs, seconds)) << " jobs/s, " <<
+            test::format_rate (latency / 1000.0 / jobs, 1) << " us mean latency";
+    }
+
+    void
+    run () override
+    {
+        std::size_t jobs = default_jobs;
+        if (! arg().empty())
+            jobs = std::stoul (arg());
+
+        testcase ("addJob " + std::to_string (jobs) + " jobs");
+        for (int threads : { 1, 2, 4, 8, 16, 32, 64 })
+            do_run (jobs, threads);
+        pass ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(JobQueue,core,ripple);
+
+}
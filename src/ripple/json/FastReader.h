@@ -0,0 +1,75 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_JSON_FASTREADER_H_INCLUDED
+#define RIPPLE_JSON_FASTREADER_H_INCLUDED
+
+#include <ripple/json/json_reader.h>
+#include <ripple/json/json_value.h>
+#include <string>
+
+namespace Json {
+
+/** Parses a JSON document into a Json::Value in a single pass.
+
+    The result is always the same as Reader would produce.  Well formed
+    documents are parsed directly from the caller's buffer: there is no copy
+    of the document, no token stream and no node stack, strings are scanned
+    a word at a time and copied in runs, and each object member costs one
+    map lookup.  Anything outside that fast path - comments, malformed or
+    out of range input, duplicate keys - is handed to a Reader, so which
+    documents are rejected and the error messages are unchanged.
+*/
+class FastReader
+{
+public:
+    /** Parse a document, returning `true` on success. */
+    bool parse (std::string const& document, Value& root);
+
+    /** Parse a document, returning `true` on success.
+        The buffer must outlive any call to getFormatedErrorMessages.
+    */
+    bool parse (char const* begin, char const* end, Value& root);
+
+    /** Returns the errors from the last parse, or an empty string. */
+    std::string getFormatedErrorMessages () const;
+
+private:
+    bool readDocument (Value& root);
+    bool readValue (Value&);
+    bool readObject (Value&);
+    bool readArray (Value&);
+    bool readNumber (Value&);
+    bool readString (std::string&);
+    bool readEscape (std::string&);
+    bool readHex (unsigned int&);
+    bool match (char const* literal, int length);
+    void skipSpaces ();
+
+    char const* current_ = nullptr;
+    char const* end_ = nullptr;
+    std::string scratch_;
+    Reader reader_;
+    bool fallback_ = false;
+};
+
+} // Json
+
+#endif
@@ -0,0 +1,516 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/json/FastReader.h>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+namespace Json {
+
+namespace {
+
+// Strings and indentation are scanned eight bytes at a time using the
+// usual "has zero byte" bit trick, which needs no special instructions.
+using Word = std::uint64_t;
+
+Word const ones = 0x0101010101010101ULL;
+Word const highs = 0x8080808080808080ULL;
+Word const spaces = ones * ' ';
+
+inline
+Word load (char const* p)
+{
+    Word w;
+    std::memcpy (&w, p, sizeof (w));
+    return w;
+}
+
+// Nonzero if any byte of w equals c.
+inline
+Word hasByte (Word w, unsigned char c)
+{
+    w ^= ones * c;
+    return (w - ones) & ~w & highs;
+}
+
+// Returns the first quote or backslash in [p, end), or end.
+inline
+char const* findSpecial (char const* p, char const* end)
+{
+    while (end - p >= static_cast <std::ptrdiff_t> (sizeof (Word)))
+    {
+        auto const w = load (p);
+        if (hasByte (w, '"') | hasByte (w, '\\'))
+            break;
+        p += sizeof (Word);
+    }
+
+    while (p != end && *p != '"' && *p != '\\')
+        ++p;
+
+    return p;
+}
+
+inline
+bool isSpace (char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+inline
+bool isDigit (char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// The characters Reader accepts as part of a number after the digits.
+inline
+bool isNumberExtra (char c)
+{
+    return c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-';
+}
+
+inline
+int hexValue (char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+// Same encoding as Reader, including for unpaired surrogates.
+void appendUTF8 (std::string& s, unsigned int cp)
+{
+    if (cp <= 0x7f)
+    {
+        s += static_cast<char> (cp);
+    }
+    else if (cp <= 0x7FF)
+    {
+        s += static_cast<char> (0xC0 | (0x1f & (cp >> 6)));
+        s += static_cast<char> (0x80 | (0x3f & cp));
+    }
+    else if (cp <= 0xFFFF)
+    {
+        s += static_cast<char> (0xE0 | (0xf & (cp >> 12)));
+        s += static_cast<char> (0x80 | (0x3f & (cp >> 6)));
+        s += static_cast<char> (0x80 | (0x3f & cp));
+    }
+    else if (cp <= 0x10FFFF)
+    {
+        s += static_cast<char> (0xF0 | (0x7 & (cp >> 18)));
+        s += static_cast<char> (0x80 | (0x3f & (cp >> 12)));
+        s += static_cast<char> (0x80 | (0x3f & (cp >> 6)));
+        s += static_cast<char> (0x80 | (0x3f & cp));
+    }
+}
+
+} // namespace
+
+bool FastReader::parse (std::string const& document, Value& root)
+{
+    current_ = document.data ();
+    end_ = current_ + document.size ();
+
+    Value value;
+    fallback_ = !readDocument (value);
+    if (fallback_)
+        return reader_.parse (document, root);
+
+    root.swap (value);
+    return true;
+}
+
+bool FastReader::parse (char const* begin, char const* end, Value& root)
+{
+    current_ = begin;
+    end_ = end;
+
+    Value value;
+    fallback_ = !readDocument (value);
+    if (fallback_)
+        return reader_.parse (begin, end, root);
+
+    root.swap (value);
+    return true;
+}
+
+std::string FastReader::getFormatedErrorMessages () const
+{
+    return fallback_ ? reader_.getFormatedErrorMessages () : std::string ();
+}
+
+bool FastReader::readDocument (Value& root)
+{
+    skipSpaces ();
+    if (current_ == end_ || (*current_ != '{' && *current_ != '['))
+        return false;
+
+    // Like Reader, ignore anything after the top level value.
+    return readValue (root);
+}
+
+bool FastReader::readValue (Value& value)
+{
+    skipSpaces ();
+    if (current_ == end_)
+        return false;
+
+    switch (*current_)
+    {
+    case '{':
+        return readObject (value);
+
+    case '[':
+        return readArray (value);
+
+    case '"':
+        if (!readString (scratch_))
+            return false;
+        value = scratch_;
+        return true;
+
+    case 't':
+        if (!match ("true", 4))
+            return false;
+        value = true;
+        return true;
+
+    case 'f':
+        if (!match ("false", 5))
+            return false;
+        value = false;
+        return true;
+
+    case 'n':
+        if (!match ("null", 4))
+            return false;
+        value = Value ();
+        return true;
+
+    case '-':
+    case '0':
+    case '1':
+    case '2':
+    case '3':
+    case '4':
+    case '5':
+    case '6':
+    case '7':
+    case '8':
+    case '9':
+        return readNumber (value);
+
+    default:
+        return false;
+    }
+}
+
+bool FastReader::readObject (Value& value)
+{
+    value = Value (objectValue);
+    ++current_;
+    skipSpaces ();
+
+    if (current_ != end_ && *current_ == '}')
+    {
+        ++current_;
+        return true;
+    }
+
+    while (true)
+    {
+        if (current_ == end_ || *current_ != '"' || !readString (scratch_))
+            return false;
+
+        skipSpaces ();
+        if (current_ == end_ || *current_ != ':')
+            return false;
+        ++current_;
+
+        // Reader rejects duplicate names, so leave that error to it.
+        auto const size = value.size ();
+        Value& member = value[scratch_];
+        if (value.size () == size)
+            return false;
+
+        if (!readValue (member))
+            return false;
+
+        skipSpaces ();
+        if (current_ == end_)
+            return false;
+
+        char const c = *current_++;
+        if (c == '}')
+            return true;
+        if (c != ',')
+            return false;
+
+        skipSpaces ();
+    }
+}
+
+bool FastReader::readArray (Value& value)
+{
+    value = Value (arrayValue);
+    ++current_;
+    skipSpaces ();
+
+    if (current_ != end_ && *current_ == ']')
+    {
+        ++current_;
+        return true;
+    }
+
+    for (Value::UInt index = 0; ; ++index)
+    {
+        if (!readValue (value[index]))
+            return false;
+
+        skipSpaces ();
+        if (current_ == end_)
+            return false;
+
+        char const c = *current_++;
+        if (c == ']')
+            return true;
+        if (c != ',')
+            return false;
+    }
+}
+
+bool FastReader::readNumber (Value& value)
+{
+    char const* const start = current_;
+    bool const negative = *current_ == '-';
+    if (negative)
+        ++current_;
+
+    char const* const digits = current_;
+    while (current_ != end_ && isDigit (*current_))
+        ++current_;
+
+    if (current_ != end_ && isNumberExtra (*current_))
+    {
+        while (current_ != end_ &&
+               (isDigit (*current_) || isNumberExtra (*current_)))
+            ++current_;
+
+        // Only take the doubles strtod consumes completely; Reader decides
+        // what to do with anything stranger.
+        char buffer[64];
+        std::size_t const length = current_ - start;
+        if (length >= sizeof (buffer))
+            return false;
+
+        std::memcpy (buffer, start, length);
+        buffer[length] = 0;
+
+        char* last;
+        double const d = std::strtod (buffer, &last);
+        if (last != buffer + length)
+            return false;
+
+        value = d;
+        return true;
+    }
+
+    if (current_ == digits)
+        return false;
+
+    // The same conversion and range checks as Reader::decodeNumber.
+    std::int64_t n = 0;
+    char const* p = digits;
+    while (p != current_ && n <= Value::maxUInt)
+        n = (n * 10) + (*p++ - '0');
+
+    if (p != current_)
+        return false;
+
+    if (negative)
+    {
+        n = -n;
+        if (n < Value::minInt)
+            return false;
+        value = static_cast<Value::Int> (n);
+    }
+    else
+    {
+        if (n > Value::maxUInt)
+            return false;
+
+        if (n <= Value::maxInt)
+            value = static_cast<Value::Int> (n);
+        else
+            value = static_cast<Value::UInt> (n);
+    }
+
+    return true;
+}
+
+bool FastReader::readString (std::string& out)
+{
+    ++current_;
+    out.clear ();
+
+    while (true)
+    {
+        char const* const special = findSpecial (current_, end_);
+        out.append (current_, special);
+        current_ = special;
+
+        if (current_ == end_)
+            return false;
+
+        if (*current_++ == '"')
+            return true;
+
+        if (!readEscape (out))
+            return false;
+    }
+}
+
+bool FastReader::readEscape (std::string& out)
+{
+    if (current_ == end_)
+        return false;
+
+    switch (*current_++)
+    {
+    case '"':
+        out += '"';
+        break;
+
+    case '/':
+        out += '/';
+        break;
+
+    case '\\':
+        out += '\\';
+        break;
+
+    case 'b':
+        out += '\b';
+        break;
+
+    case 'f':
+        out += '\f';
+        break;
+
+    case 'n':
+        out += '\n';
+        break;
+
+    case 'r':
+        out += '\r';
+        break;
+
+    case 't':
+        out += '\t';
+        break;
+
+    case 'u':
+    {
+        unsigned int unicode;
+        if (!readHex (unicode))
+            return false;
+
+        if (unicode >= 0xD800 && unicode <= 0xDBFF)
+        {
+            // Like Reader, take the next escape as the low half without
+            // checking its range.
+            if (end_ - current_ < 2 || current_[0] != '\\' || current_[1] != 'u')
+                return false;
+            current_ += 2;
+
+            unsigned int low;
+            if (!readHex (low))
+                return false;
+
+            unicode = 0x10000 + ((unicode & 0x3FF) << 10) + (low & 0x3FF);
+        }
+
+        appendUTF8 (out, unicode);
+        break;
+    }
+
+    default:
+        return false;
+    }
+
+    return true;
+}
+
+bool FastReader::readHex (unsigned int& unicode)
+{
+    if (end_ - current_ < 4)
+        return false;
+
+    unicode = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        int const digit = hexValue (*current_++);
+        if (digit < 0)
+            return false;
+        unicode = (unicode * 16) + digit;
+    }
+
+    return true;
+}
+
+bool FastReader::match (char const* literal, int length)
+{
+    if (end_ - current_ < length ||
+        std::memcmp (current_, literal, length) != 0)
+        return false;
+
+    current_ += length;
+    return true;
+}
+
+void FastReader::skipSpaces ()
+{
+    while (current_ != end_)
+    {
+        // Pretty printed requests are mostly runs of indentation.
+        if (end_ - current_ >= static_cast <std::ptrdiff_t> (sizeof (Word)) &&
+            load (current_) == spaces)
+        {
+            current_ += sizeof (Word);
+        }
+        else if (isSpace (*current_))
+        {
+            ++current_;
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+} // Json
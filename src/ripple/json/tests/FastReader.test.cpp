@@ -0,0 +1,239 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/basics/tests/benchmark.h>
+#include <ripple/json/FastReader.h>
+#include <ripple/json/json_reader.h>
+#include <ripple/json/to_string.h>
+#include <beast/unit_test/suite.h>
+#include <random>
+
+namespace Json {
+
+// Requests in the shape our clients send them.
+static char const* const fastReaderRequests[] =
+{
+    "{\"command\":\"account_info\",\"account\":"
+        "\"rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh\",\"ledger_index\":\"validated\","
+        "\"id\":7}",
+    "{\"method\":\"submit\",\"params\":[{\"tx_blob\":\"1200002280000000240000"
+        "0001614000000000000064684000000000000000C7321036C4C3D4D2C1B0A09080706"
+        "050403020100FFEEDDCCBBAA99887766554433221100\"}]}",
+    "{\n    \"command\" : \"subscribe\",\n    \"streams\" : [ \"ledger\", "
+        "\"transactions\" ],\n    \"accounts\" : [\n        "
+        "\"rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh\"\n    ]\n}\n",
+    "{\"method\":\"ledger\",\"params\":[{\"ledger_index\":1e300,"
+        "\"full\":false,\"expand\":true,\"transactions\":null}]}",
+};
+
+class FastReader_test : public beast::unit_test::suite
+{
+public:
+    // Parses with both readers and checks they agree on everything.
+    bool same (std::string const& document)
+    {
+        Value expected;
+        Reader reader;
+        bool const expectedOk = reader.parse (document, expected);
+
+        Value actual;
+        FastReader fast;
+        bool const actualOk = fast.parse (document, actual);
+
+        return expectedOk == actualOk &&
+            expected == actual &&
+            reader.getFormatedErrorMessages () ==
+                fast.getFormatedErrorMessages ();
+    }
+
+    void check (std::string const& document)
+    {
+        expect (same (document), document);
+    }
+
+    void testValid ()
+    {
+        testcase ("valid");
+
+        for (auto request : fastReaderRequests)
+            check (request);
+
+        check ("{}");
+        check ("[]");
+        check (" \t\r\n{ } ");
+        check ("[[[[]]],{},[{}]]");
+        check ("{\"a\":{\"b\":{\"c\":[1,2,{\"d\":null}]}}}");
+        check ("[true,false,null,\"\",0,-0]");
+        check ("{\"\":1}");
+        check ("[\"a very long string that spans several words at once\"]");
+        check ("[\"\\\"\\\\\\/\\b\\f\\n\\r\\t\"]");
+        check ("[\"\\u0041\\u00e9\\u20AC\\ud83d\\ude00\"]");
+        check ("[\"\\udc00 lone low surrogate\"]");
+        check (std::string ("[\"embedded\0nul\"]", 16));
+        check ("[\"raw\tcontrol\ncharacters\"]");
+        check ("[4294967295,4294967296,2147483647,2147483648]");
+        check ("[-2147483648,-2147483649,0000000000001]");
+        check ("[1.5,-2.25e3,1E-2,3e+2,0.0]");
+        check ("{\"a\":1} trailing text is ignored");
+        check ("[1]\n// even a comment");
+    }
+
+    void testInvalid ()
+    {
+        testcase ("invalid");
+
+        check ("");
+        check ("   ");
+        check ("1");
+        check ("\"string\"");
+        check ("null");
+        check ("{");
+        check ("[");
+        check ("{\"a\"}");
+        check ("{\"a\":}");
+        check ("{\"a\":1,}");
+        check ("{\"\":1,}");
+        check ("[1,]");
+        check ("[1 2]");
+        check ("{\"a\":1,\"a\":2}");
+        check ("{'a':1}");
+        check ("[tru]");
+        check ("[nulll]");
+        check ("[-]");
+        check ("[1-2]");
+        check ("[1e]");
+        check ("[.5]");
+        check ("[\"unterminated]");
+        check ("[\"\\x\"]");
+        check ("[\"\\u12\"]");
+        check ("[\"\\ud800\"]");
+        check ("[\"\\ud800\\n0000\"]");
+        check ("{/* comment */\"a\":1}");
+        check ("[1, // comment\n2]");
+    }
+
+    // Mutates the valid documents at random and checks the readers agree.
+    void testFuzz ()
+    {
+        testcase ("fuzz");
+
+        static char const alphabet[] = "{}[]\",:\\/ 0123456789-+.eEtrufalsn";
+
+        std::vector <std::string> seeds (
+            std::begin (fastReaderRequests), std::end (fastReaderRequests));
+        seeds.push_back ("{\"a\":[1,-2,3.5,\"\\u00e9\",true,false,null]}");
+
+        std::mt19937 gen (1987);
+        std::size_t mismatches = 0;
+
+        for (int i = 0; i < 20000; ++i)
+        {
+            std::string doc = seeds[gen () % seeds.size ()];
+
+            for (int edits = 1 + gen () % 3; edits > 0; --edits)
+            {
+                std::size_t const pos = gen () % (doc.size () + 1);
+                char const c = alphabet[gen () % (sizeof (alphabet) - 1)];
+
+                switch (gen () % 4)
+                {
+                case 0:
+                    doc.insert (pos, 1, c);
+                    break;
+                case 1:
+                    if (pos < doc.size ())
+                        doc[pos] = c;
+                    break;
+                case 2:
+                    if (pos < doc.size ())
+                        doc.erase (pos, 1);
+                    break;
+                default:
+                    doc.resize (pos);
+                    break;
+                }
+            }
+
+            if (!same (doc))
+            {
+                if (++mismatches <= 10)
+                    log << "mismatch: " << doc;
+            }
+        }
+
+        expect (mismatches == 0);
+    }
+
+    void run ()
+    {
+        testValid ();
+        testInvalid ();
+        testFuzz ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(FastReader,json,ripple);
+
+//------------------------------------------------------------------------------
+
+// Measures parsing throughput of both readers over the request corpus.
+class FastReaderTiming_test : public beast::unit_test::suite
+{
+public:
+    template <class Reader>
+    void
+    measure (std::string const& name, std::vector <std::string> const& corpus)
+    {
+        std::size_t const n = 20000;
+        std::size_t bytes = 0;
+        Reader reader;
+
+        auto const start = ripple::test::benchmark_clock::now();
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            for (auto const& document : corpus)
+            {
+                Value value;
+                reader.parse (document, value);
+                bytes += document.size ();
+            }
+        }
+        log << name << ": " << ripple::test::format_rate (
+            ripple::test::per_second (bytes,
+                ripple::test::seconds_since (start))) << " bytes/s";
+    }
+
+    void
+    run () override
+    {
+        std::vector <std::string> corpus (
+            std::begin (fastReaderRequests), std::end (fastReaderRequests));
+
+        testcase ("requests");
+        measure <Reader> ("Reader", corpus);
+        measure <FastReader> ("FastReader", corpus);
+        pass ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(FastReaderTiming,json,ripple);
+
+} // Json
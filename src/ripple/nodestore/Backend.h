@@ -65,6 +65,19 @@ public:
     */
     virtual Status fetch (void const* key, NodeObject::Ptr* pObject) = 0;
 
+    /** Fetch a group of objects.
+        Backends that can look up many keys in one pass, or in an order
+        that suits the underlying storage, should do so here.
+        @note This will be called concurrently.
+        @param keys Pointers to the key data.
+        @param objects [out] One entry per key, in the same order as `keys`.
+                             Entries for keys which were not found or could
+                             not be loaded are set to `nullptr`.
+        @return `ok`, or the first error encountered.
+    */
+    virtual Status fetchBatch (std::vector <void const*> const& keys,
+        std::vector <NodeObject::Ptr>& objects) = 0;
+
     /** Store a single object.
         Depending on the implementation this may happen immediately
         or deferred using a scheduled task.
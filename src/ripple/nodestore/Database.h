@@ -71,6 +71,18 @@ public:
     */
     virtual NodeObject::pointer fetch (uint256 const& hash) = 0;
 
+    /** Fetch a group of objects.
+        The positive and negative caches are consulted for every key
+        first, then all of the remaining keys are read from the backend
+        in a single batch.
+        @note This can be called concurrently.
+        @param hashes The keys of the objects to retrieve.
+        @return One entry per key, in the same order as `hashes`, which
+                is `nullptr` if the object couldn't be retrieved.
+    */
+    virtual std::vector <NodeObject::Ptr> fetchBatch (
+        std::vector <uint256> const& hashes) = 0;
+
     /** Fetch an object without waiting.
         If I/O is required to determine whether or not the object is present,
         `false` is returned. Otherwise, `true` is returned and `object` is set
@@ -109,6 +121,16 @@ public:
                         Blob&& data,
                         uint256 const& hash) = 0;
 
+    /** Store a group of objects.
+
+        The objects are added to the cache and handed to the backend the
+        same way store does, so a backend with a batch writer writes them
+        asynchronously instead of on the calling thread.
+
+        @param batch The objects to store.
+    */
+    virtual void storeBatch (Batch const& batch) = 0;
+
     /** Visit every object in the database
         This is usually called during import.
 
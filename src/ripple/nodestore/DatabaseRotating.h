@@ -21,6 +21,7 @@
 #define RIPPLE_NODESTORE_DATABASEROTATING_H_INCLUDED
 
 #include <ripple/nodestore/Database.h>
+#include <ripple/basics/ShardedTaggedCache.h>
 
 namespace ripple {
 namespace NodeStore {
@@ -35,7 +36,7 @@ class DatabaseRotating
 public:
     virtual ~DatabaseRotating() = default;
 
-    virtual TaggedCache <uint256, NodeObject>& getPositiveCache() = 0;
+    virtual ShardedTaggedCache <uint256, NodeObject>& getPositiveCache() = 0;
 
     virtual std::mutex& peekMutex() const = 0;
 
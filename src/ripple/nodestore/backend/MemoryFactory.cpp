@@ -128,6 +128,26 @@ public:
         return ok;
     }
 
+    Status
+    fetchBatch (std::vector <void const*> const& keys,
+        std::vector <NodeObject::Ptr>& objects) override
+    {
+        objects.clear ();
+        objects.reserve (keys.size ());
+
+        std::lock_guard<std::mutex> _(db_->mutex);
+
+        for (auto const key : keys)
+        {
+            Map::iterator iter = db_->table.find (uint256::fromVoid (key));
+            if (iter == db_->table.end())
+                objects.emplace_back ();
+            else
+                objects.push_back (iter->second);
+        }
+        return ok;
+    }
+
     void
     store (NodeObject::ref object)
     {
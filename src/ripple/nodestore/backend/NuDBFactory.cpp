@@ -29,6 +29,7 @@
 #include <beast/nudb/visit.h>
 #include <beast/hash/xxhasher.h>
 #include <boost/filesystem.hpp>
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <cstdio>
@@ -148,6 +149,29 @@ public:
         return status;
     }
 
+    Status
+    fetchBatch (std::vector <void const*> const& keys,
+        std::vector <NodeObject::Ptr>& objects) override
+    {
+        // Visit the keys in key file bucket order so that
+        // reads which miss the cache move forward through the file.
+        std::vector <std::pair <std::size_t, std::size_t>> order;
+        order.reserve (keys.size ());
+        for (std::size_t i = 0; i < keys.size (); ++i)
+            order.emplace_back (db_.bucket_of (keys[i]), i);
+        std::sort (order.begin (), order.end ());
+
+        Status result = ok;
+        objects.assign (keys.size (), nullptr);
+        for (auto const& e : order)
+        {
+            Status const status = fetch (keys[e.second], &objects[e.second]);
+            if (status != ok && status != notFound && result == ok)
+                result = status;
+        }
+        return result;
+    }
+
     void
     do_insert (std::shared_ptr <NodeObject> const& no)
     {
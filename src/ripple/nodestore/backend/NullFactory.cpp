@@ -53,6 +53,14 @@ public:
         return notFound;
     }
 
+    Status
+    fetchBatch (std::vector <void const*> const& keys,
+        std::vector <NodeObject::Ptr>& objects) override
+    {
+        objects.assign (keys.size (), nullptr);
+        return ok;
+    }
+
     void
     store (NodeObject::ref object)
     {
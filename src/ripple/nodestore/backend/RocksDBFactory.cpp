@@ -29,6 +29,7 @@
 #include <ripple/nodestore/impl/BatchWriter.h>
 #include <ripple/nodestore/impl/DecodedBlob.h>
 #include <ripple/nodestore/impl/EncodedBlob.h>
+#include <ripple/nodestore/impl/RocksDBMultiGet.h>
 #include <beast/threads/Thread.h>
 #include <atomic>
 #include <beast/cxx14/memory.h> // <memory>
@@ -280,6 +281,13 @@ public:
         return status;
     }
 
+    Status
+    fetchBatch (std::vector <void const*> const& keys,
+        std::vector <NodeObject::Ptr>& objects) override
+    {
+        return rocksDBMultiGet (*m_db, m_keyBytes, keys, objects, m_journal);
+    }
+
     void
     store (NodeObject::ref object)
     {
@@ -23,12 +23,13 @@
 #include <ripple/nodestore/Database.h>
 #include <ripple/nodestore/Scheduler.h>
 #include <ripple/nodestore/impl/Tuning.h>
-#include <ripple/basics/TaggedCache.h>
+#include <ripple/basics/ShardedTaggedCache.h>
 #include <ripple/basics/KeyCache.h>
 #include <ripple/basics/Log.h>
 #include <ripple/basics/seconds_clock.h>
 #include <beast/threads/Thread.h>
 #include <ripple/nodestore/ScopedMetrics.h>
+#include <algorithm>
 #include <chrono>
 #include <condition_variable>
 #include <set>
@@ -49,7 +50,7 @@ public:
     std::unique_ptr <Backend> m_fastBackend;
 
     // Positive cache
-    TaggedCache <uint256, NodeObject> m_cache;
+    ShardedTaggedCache <uint256, NodeObject> m_cache;
 
     // Negative cache
     KeyCache <uint256> m_negCache;
@@ -273,6 +274,14 @@ public:
         return fetchInternal (*m_backend, hash);
     }
 
+    // Fetch hashes[i] for each i in indexes from the main database
+    virtual void fetchBatchFrom (std::vector <uint256> const& hashes,
+        std::vector <std::size_t> const& indexes,
+            std::vector <NodeObject::Ptr>& results)
+    {
+        fetchBatchInternal (*m_backend, hashes, indexes, results);
+    }
+
     NodeObject::Ptr fetchInternal (Backend& backend,
         uint256 const& hash)
     {
@@ -305,6 +314,163 @@ public:
         return object;
     }
 
+    void fetchBatchInternal (Backend& backend,
+        std::vector <uint256> const& hashes,
+            std::vector <std::size_t> const& indexes,
+                std::vector <NodeObject::Ptr>& results)
+    {
+        std::vector <void const*> keys;
+        keys.reserve (indexes.size ());
+        for (auto const i : indexes)
+            keys.push_back (hashes[i].begin ());
+
+        std::vector <NodeObject::Ptr> objects;
+        Status const status = backend.fetchBatch (keys, objects);
+
+        for (std::size_t j = 0; j < indexes.size (); ++j)
+        {
+            if (objects[j])
+            {
+                ++m_fetchHitCount;
+                m_fetchSize += objects[j]->getData().size();
+                results[indexes[j]] = std::move (objects[j]);
+            }
+        }
+
+        if (status == dataCorrupt)
+        {
+            // VFALCO TODO Deal with encountering corrupt data!
+            //
+            if (m_journal.fatal) m_journal.fatal <<
+                "Corrupt NodeObject in batch of " << indexes.size ();
+        }
+        else if (status != ok && status != notFound)
+        {
+            if (m_journal.warning) m_journal.warning <<
+                "Unknown status=" << status;
+        }
+    }
+
+    std::vector <NodeObject::Ptr> fetchBatch (
+        std::vector <uint256> const& hashes) override
+    {
+        for (std::size_t i = 0; i < hashes.size (); ++i)
+            ScopedMetrics::incrementThreadFetches ();
+
+        return doTimedFetchBatch (hashes, false);
+    }
+
+    /** Perform a batch fetch and report the time it took */
+    std::vector <NodeObject::Ptr> doTimedFetchBatch (
+        std::vector <uint256> const& hashes, bool isAsync)
+    {
+        FetchReport report;
+        report.isAsync = isAsync;
+        report.wentToDisk = false;
+
+        auto const before = std::chrono::steady_clock::now();
+        std::vector <NodeObject::Ptr> ret = doFetchBatch (hashes, report);
+        report.elapsed = std::chrono::duration_cast <std::chrono::milliseconds>
+            (std::chrono::steady_clock::now() - before);
+
+        report.wasFound = std::all_of (ret.begin (), ret.end (),
+            [](NodeObject::Ptr const& obj) { return obj != nullptr; });
+        m_scheduler.onFetch (report);
+
+        return ret;
+    }
+
+    std::vector <NodeObject::Ptr> doFetchBatch (
+        std::vector <uint256> const& hashes, FetchReport& report)
+    {
+        std::vector <NodeObject::Ptr> results (hashes.size ());
+
+        // Indexes of the hashes which are in neither cache
+        std::vector <std::size_t> missing;
+        for (std::size_t i = 0; i < hashes.size (); ++i)
+        {
+            results[i] = m_cache.fetch (hashes[i]);
+
+            if (results[i] == nullptr &&
+                    ! m_negCache.touch_if_exists (hashes[i]))
+                missing.push_back (i);
+        }
+
+        if (missing.empty ())
+            return results;
+
+        // Check the database(s).
+
+        report.wentToDisk = true;
+
+        // Check the fast backend database if we have one
+        //
+        std::vector <std::size_t> slow;
+        if (m_fastBackend != nullptr)
+        {
+            fetchBatchInternal (*m_fastBackend, hashes, missing, results);
+
+            for (auto const i : missing)
+                if (results[i] == nullptr)
+                    slow.push_back (i);
+        }
+        else
+        {
+            slow = missing;
+        }
+
+        // Anything still missing comes from the main database.
+        //
+        if (! slow.empty ())
+        {
+            fetchBatchFrom (hashes, slow, results);
+            m_fetchTotalCount += slow.size ();
+        }
+
+        std::size_t s = 0;
+        for (auto const i : missing)
+        {
+            // Was this object read from the main database?
+            bool const fromSlow = (s < slow.size ()) && (slow[s] == i);
+            if (fromSlow)
+                ++s;
+
+            NodeObject::Ptr& obj = results[i];
+
+            if (obj == nullptr)
+            {
+                // Just in case a write occurred
+                obj = m_cache.fetch (hashes[i]);
+
+                if (obj == nullptr)
+                {
+                    // We give up
+                    m_negCache.insert (hashes[i]);
+                }
+                continue;
+            }
+
+            // Ensure all threads get the same object
+            //
+            m_cache.canonicalize (hashes[i], obj);
+
+            if (fromSlow && m_fastBackend != nullptr)
+            {
+                // If we have a fast back end, store it there for later.
+                //
+                m_fastBackend->store (obj);
+                ++m_storeCount;
+                m_storeSize += obj->getData().size();
+            }
+        }
+
+        if (m_journal.trace) m_journal.trace <<
+            "HOS: batch of " << hashes.size () << " fetch: " <<
+                slow.size () << " in db";
+
+        return results;
+    }
+
     //------------------------------------------------------------------------------
 
     void store (NodeObjectType type,
@@ -344,6 +510,45 @@ public:
         }
     }
 
+    void storeBatch (Batch const& batch) override
+    {
+        storeBatchInternal (batch, *m_backend.get());
+    }
+
+    void storeBatchInternal (Batch const& batch, Backend& backend)
+    {
+        if (batch.empty ())
+            return;
+
+        std::uint64_t size = 0;
+
+        for (auto object : batch)
+        {
+            #if RIPPLE_VERIFY_NODEOBJECT_KEYS
+            assert (object->getHash () == getSHA512Half (object->getData ()));
+            #endif
+
+            size += object->getData ().size ();
+            m_cache.canonicalize (object->getHash (), object, true);
+            m_negCache.erase (object->getHash ());
+
+            // Backends with a batch writer queue the object for their
+            // write job, as store does, rather than writing it here.
+            backend.store (object);
+            if (m_fastBackend)
+                m_fastBackend->store (object);
+        }
+
+        m_storeCount += batch.size ();
+        m_storeSize += size;
+
+        if (m_fastBackend)
+        {
+            m_storeCount += batch.size ();
+            m_storeSize += size;
+        }
+    }
+
     //------------------------------------------------------------------------------
 
     float getCacheHitRate ()
@@ -378,7 +583,7 @@ public:
         beast::Thread::setCurrentThreadName ("prefetch");
         while (1)
         {
-            uint256 hash;
+            std::vector <uint256> hashes;
 
             {
                 std::unique_lock <std::mutex> lock (m_readLock);
@@ -394,23 +599,33 @@ public:
                     break;
 
                 // Read in key order to make the back end more efficient
-                std::set <uint256>::iterator it = m_readSet.lower_bound (m_readLast);
-                if (it == m_readSet.end ())
+                while (! m_readSet.empty () && hashes.size () < asyncBatchSize)
                 {
-                    it = m_readSet.begin ();
-
-                    // A generation has completed
-                    ++m_readGen;
-                    m_readGenCondVar.notify_all ();
+                    std::set <uint256>::iterator it = m_readSet.lower_bound (m_readLast);
+                    if (it == m_readSet.end ())
+                    {
+                        // Don't wrap around in the middle of a batch
+                        if (! hashes.empty ())
+                            break;
+
+                        it = m_readSet.begin ();
+
+                        // A generation has completed
+                        ++m_readGen;
+                        m_readGenCondVar.notify_all ();
+                    }
+
+                    hashes.push_back (*it);
+                    m_readSet.erase (it);
+                    m_readLast = hashes.back ();
                 }
-
-                hash = *it;
-                m_readSet.erase (it);
-                m_readLast = hash;
             }
 
-            // Perform the read
-            doTimedFetch (hash, true);
+            // Perform the reads
+            if (hashes.size () == 1)
+                doTimedFetch (hashes.front (), true);
+            else
+                doTimedFetchBatch (hashes, true);
          }
      }
 
@@ -50,6 +50,32 @@ NodeObject::Ptr DatabaseRotatingImp::fetchFrom (uint256 const& hash)
 
     return object;
 }
+
+void DatabaseRotatingImp::fetchBatchFrom (std::vector <uint256> const& hashes,
+    std::vector <std::size_t> const& indexes,
+        std::vector <NodeObject::Ptr>& results)
+{
+    Backends b = getBackends();
+    fetchBatchInternal (*b.writableBackend, hashes, indexes, results);
+
+    std::vector <std::size_t> archived;
+    for (auto const i : indexes)
+        if (!results[i])
+            archived.push_back (i);
+
+    if (archived.empty ())
+        return;
+
+    fetchBatchInternal (*b.archiveBackend, hashes, archived, results);
+    for (auto const i : archived)
+    {
+        if (results[i])
+        {
+            getWritableBackend()->store (results[i]);
+            m_negCache.erase (hashes[i]);
+        }
+    }
+}
 }
 
 }
@@ -117,13 +117,21 @@ public:
                 *getWritableBackend());
     }
 
+    void storeBatch (Batch const& batch) override
+    {
+        storeBatchInternal (batch, *getWritableBackend());
+    }
+
     NodeObject::Ptr fetchNode (uint256 const& hash) override
     {
         return fetchFrom (hash);
     }
 
     NodeObject::Ptr fetchFrom (uint256 const& hash) override;
-    TaggedCache <uint256, NodeObject>& getPositiveCache() override
+    void fetchBatchFrom (std::vector <uint256> const& hashes,
+        std::vector <std::size_t> const& indexes,
+            std::vector <NodeObject::Ptr>& results) override;
+    ShardedTaggedCache <uint256, NodeObject>& getPositiveCache() override
     {
         return m_cache;
     }
@@ -0,0 +1,105 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_ROCKSDBMULTIGET_H_INCLUDED
+#define RIPPLE_NODESTORE_ROCKSDBMULTIGET_H_INCLUDED
+
+#include <ripple/unity/rocksdb.h>
+
+#if RIPPLE_ROCKSDB_AVAILABLE
+
+#include <ripple/nodestore/Types.h>
+#include <ripple/nodestore/impl/DecodedBlob.h>
+#include <beast/utility/Journal.h>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace NodeStore {
+
+/** Fetch a group of objects from a RocksDB database with one MultiGet.
+
+    This implements Backend::fetchBatch for the RocksDB backends.
+
+    @param db The database to read.
+    @param keyBytes The size of each key.
+    @param keys The keys of the objects to fetch.
+    @param objects Receives the objects, or `nullptr` for each object that
+                   could not be loaded.
+    @param journal Where errors other than corruption are reported.
+    @return `ok`, or the first error encountered.
+*/
+inline
+Status
+rocksDBMultiGet (rocksdb::DB& db, std::size_t keyBytes,
+    std::vector <void const*> const& keys,
+        std::vector <NodeObject::Ptr>& objects, beast::Journal journal)
+{
+    rocksdb::ReadOptions const options;
+
+    std::vector <rocksdb::Slice> slices;
+    slices.reserve (keys.size ());
+    for (auto const key : keys)
+        slices.emplace_back (static_cast <char const*> (key), keyBytes);
+
+    std::vector <std::string> values;
+    std::vector <rocksdb::Status> const getStatus =
+        db.MultiGet (options, slices, &values);
+
+    Status result (ok);
+    objects.assign (keys.size (), nullptr);
+
+    for (std::size_t i = 0; i < keys.size (); ++i)
+    {
+        Status status (ok);
+
+        if (getStatus[i].ok ())
+        {
+            DecodedBlob decoded (keys[i],
+                values[i].data (), values[i].size ());
+
+            if (decoded.wasOk ())
+                objects[i] = decoded.createObject ();
+            else
+                status = dataCorrupt;
+        }
+        else if (getStatus[i].IsCorruption ())
+        {
+            status = dataCorrupt;
+        }
+        else if (! getStatus[i].IsNotFound ())
+        {
+            status = Status (customCode + getStatus[i].code());
+
+            journal.error << getStatus[i].ToString ();
+        }
+
+        if (status != ok && result == ok)
+            result = status;
+    }
+
+    return result;
+}
+
+}
+}
+
+#endif
+
+#endif
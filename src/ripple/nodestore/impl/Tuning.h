@@ -33,6 +33,9 @@ enum
 
     // Fraction of the cache one query source can take
     ,asyncDivider = 8
+
+    // Maximum number of async reads a prefetch thread issues at once
+    ,asyncBatchSize = 64
 };
 
 }
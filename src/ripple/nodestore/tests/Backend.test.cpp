@@ -22,6 +22,7 @@
 #include <ripple/nodestore/DummyScheduler.h>
 #include <ripple/nodestore/Manager.h>
 #include <beast/module/core/diagnostic/UnitTestUtilities.h>
+#include <algorithm>
 
 namespace ripple {
 namespace NodeStore {
@@ -71,6 +72,24 @@ public:
                 fetchCopyOfBatch (*backend, &copy, batch);
                 expect (areBatchesEqual (batch, copy), "Should be equal");
             }
+
+            {
+                // Read it back in with one batch fetch
+                Batch copy;
+                fetchBatchCopyOfBatch (*backend, &copy, batch);
+                expect (areBatchesEqual (batch, copy), "Should be equal");
+            }
+
+            {
+                // Batch fetch objects that were never stored
+                Batch missing;
+                createPredictableBatch (missing, 10, seedValue + 1);
+                Batch copy;
+                fetchBatchCopyOfBatch (*backend, &copy, missing);
+                expect (std::all_of (copy.begin (), copy.end (),
+                    [](NodeObject::Ptr const& object) { return ! object; }),
+                        "Should be null");
+            }
         }
 
         {
@@ -151,6 +151,20 @@ public:
         }
     }
 
+    // Get a copy of a batch in a backend with a single batch fetch
+    void fetchBatchCopyOfBatch (Backend& backend, Batch* pCopy, Batch const& batch)
+    {
+        std::vector <void const*> keys;
+        keys.reserve (batch.size ());
+        for (auto const& object : batch)
+            keys.push_back (object->getHash ().cbegin ());
+
+        Status const status = backend.fetchBatch (keys, *pCopy);
+
+        expect (status == ok, "Should be ok");
+        expect (pCopy->size () == batch.size (), "Should be the same size");
+    }
+
     void fetchMissing(Backend& backend, Batch const& batch)
     {
         for (int i = 0; i < batch.size (); ++i)
@@ -195,6 +209,19 @@ public:
                 pCopy->push_back (object);
         }
     }
+
+    // Fetch all the hashes in one batch with a single batch fetch.
+    static void fetchBatchCopyOfBatch (Database& db,
+                                       Batch* pCopy,
+                                       Batch const& batch)
+    {
+        std::vector <uint256> hashes;
+        hashes.reserve (batch.size ());
+        for (auto const& object : batch)
+            hashes.push_back (object->getHash ());
+
+        *pCopy = db.fetchBatch (hashes);
+    }
 };
 
 }
@@ -150,6 +150,13 @@ public:
                 std::unique_ptr <Database> db = Manager::instance().make_Database (
                     "test", scheduler, j, 2, nodeParams);
 
+                {
+                    // Read it back in with one batch fetch, cold cache
+                    Batch copy;
+                    fetchBatchCopyOfBatch (*db, &copy, batch);
+                    expect (areBatchesEqual (batch, copy), "Should be equal");
+                }
+
                 // Read it back in
                 Batch copy;
                 fetchCopyOfBatch (*db, &copy, batch);
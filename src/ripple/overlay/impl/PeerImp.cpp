@@ -165,15 +165,10 @@ PeerImp::send (Message::pointer const& m)
         return;
     if(detaching_)
         return;
-    send_queue_.push(m);
+    send_queue_.push_back(m);
     if(send_queue_.size() > 1)
         return;
-    setTimer();
-    boost::asio::async_write (stream_, boost::asio::buffer(
-        send_queue_.front()->getBuffer()), strand_.wrap(std::bind(
-            &PeerImp::onWriteMessage, shared_from_this(),
-                beast::asio::placeholders::error,
-                    beast::asio::placeholders::bytes_transferred)));
+    writeQueued();
 }
 
 void
@@ -211,6 +206,17 @@ PeerImp::json()
     ret[jss::public_key]   = publicKey_.ToString ();
     ret[jss::address]      = remote_address_.to_string();
 
+    {
+        auto const reads = reads_.load();
+        auto const messages = messages_read_.load();
+        ret[jss::bytes_read] = std::to_string (bytes_read_.load());
+        ret[jss::reads] = std::to_string (reads);
+        ret[jss::messages_read] = std::to_string (messages);
+        if (reads != 0)
+            ret[jss::messages_per_read] =
+                static_cast<double> (messages) / reads;
+    }
+
     if (m_inbound)
         ret[jss::inbound] = true;
 
@@ -580,6 +586,25 @@ PeerImp::doProtocolStart()
 }
 
 // Called repeatedly with protocol message data
+std::size_t
+PeerImp::readSize () const
+{
+    // Ask for several messages of the size seen recently, and at least
+    // enough to finish a message whose header has already arrived, so
+    // large replies during catch-up don't trickle in 4KB at a time.
+    std::size_t n = std::max<std::size_t> (
+        Tuning::readBufferBytes, 4 * read_message_bytes_);
+    auto const buffered = read_buffer_.size();
+    if (buffered >= Message::kHeaderBytes)
+    {
+        auto const needed = Message::kHeaderBytes +
+            Message::size (read_buffer_.data());
+        if (needed > buffered)
+            n = std::max (n, needed - buffered);
+    }
+    return std::min<std::size_t> (n, Tuning::readBufferMaxBytes);
+}
+
 void
 PeerImp::onReadMessage (error_code ec, std::size_t bytes_transferred)
 {
@@ -604,6 +629,11 @@ PeerImp::onReadMessage (error_code ec, std::size_t bytes_transferred)
     }
 
     read_buffer_.commit (bytes_transferred);
+    if (bytes_transferred > 0)
+    {
+        bytes_read_ += bytes_transferred;
+        ++reads_;
+    }
 
     while (read_buffer_.size() > 0)
     {
@@ -619,14 +649,57 @@ PeerImp::onReadMessage (error_code ec, std::size_t bytes_transferred)
         if (bytes_consumed == 0)
             break;
         read_buffer_.consume (bytes_consumed);
+        read_message_bytes_ = (7 * read_message_bytes_ + bytes_consumed) / 8;
+        ++messages_read_;
     }
     // Timeout on writes only
-    stream_.async_read_some (read_buffer_.prepare (Tuning::readBufferBytes),
+    stream_.async_read_some (read_buffer_.prepare (readSize()),
         strand_.wrap (std::bind (&PeerImp::onReadMessage,
             shared_from_this(), beast::asio::placeholders::error,
                 beast::asio::placeholders::bytes_transferred)));
 }
 
+void
+PeerImp::writeQueued ()
+{
+    assert(strand_.running_in_this_thread());
+    assert(! send_queue_.empty());
+    assert(send_count_ == 0);
+
+    // Timeout on writes only
+    setTimer();
+
+    // The SSL stream encrypts one buffer per write, so small messages
+    // are copied into one buffer and go out as a single record. A large
+    // message, or one with nothing queued behind it, is written in place.
+    auto const& front = send_queue_.front()->getBuffer();
+    if (send_queue_.size() == 1 || front.size() >= Tuning::sendBatchBytes)
+    {
+        send_count_ = 1;
+        return boost::asio::async_write (stream_, boost::asio::buffer(
+            front), strand_.wrap(std::bind(
+                &PeerImp::onWriteMessage, shared_from_this(),
+                    beast::asio::placeholders::error,
+                        beast::asio::placeholders::bytes_transferred)));
+    }
+
+    send_batch_.clear();
+    for (auto const& m : send_queue_)
+    {
+        auto const& buffer = m->getBuffer();
+        if (send_count_ > 0 &&
+                send_batch_.size() + buffer.size() > Tuning::sendBatchBytes)
+            break;
+        send_batch_.insert(send_batch_.end(), buffer.begin(), buffer.end());
+        ++send_count_;
+    }
+
+    boost::asio::async_write (stream_, boost::asio::buffer(send_batch_),
+        strand_.wrap(std::bind(&PeerImp::onWriteMessage, shared_from_this(),
+            beast::asio::placeholders::error,
+                beast::asio::placeholders::bytes_transferred)));
+}
+
 void
 PeerImp::onWriteMessage (error_code ec, std::size_t bytes_transferred)
 {
@@ -645,18 +718,12 @@ PeerImp::onWriteMessage (error_code ec, std::size_t bytes_transferred)
             "onWriteMessage";
     }
 
-    assert(! send_queue_.empty());
-    send_queue_.pop();
+    assert(send_queue_.size() >= send_count_);
+    send_queue_.erase(send_queue_.begin(),
+        send_queue_.begin() + send_count_);
+    send_count_ = 0;
     if (! send_queue_.empty())
-    {
-        // Timeout on writes only
-        setTimer();
-        return boost::asio::async_write (stream_, boost::asio::buffer(
-            send_queue_.front()->getBuffer()), strand_.wrap(std::bind(
-                &PeerImp::onWriteMessage, shared_from_this(),
-                    beast::asio::placeholders::error,
-                        beast::asio::placeholders::bytes_transferred)));
-    }
+        return writeQueued();
 
     if (gracefulClose_)
     {
@@ -881,15 +948,11 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMTransaction> const& m)
             }
         }
 
-        if (getApp().getJobQueue().getJobCount(jtTRANSACTION) > 100)
-            p_journal_.info << "Transaction queue is full";
-        else if (getApp().getLedgerMaster().getValidatedLedgerAge() > 240)
+        if (getApp().getLedgerMaster().getValidatedLedgerAge() > 240)
             p_journal_.trace << "No new transactions until synchronized";
-        else
-            getApp().getJobQueue ().addJob (jtTRANSACTION,
-                "recvTransaction->checkTransaction",
-                std::bind(beast::weak_fn(&PeerImp::checkTransaction,
-                shared_from_this()), std::placeholders::_1, flags, stx));
+        else if (! getApp().getOPs ().queueTransaction (
+                stx, flags, shared_from_this ()))
+            p_journal_.info << "Transaction queue is full";
     }
     catch (...)
     {
@@ -1416,45 +1479,6 @@ PeerImp::doFetchPack (const std::shared_ptr<protocol::TMGetObjectByHash>& packet
                 packet, hash, UptimeTimer::getInstance ().getElapsedSeconds ()));
 }
 
-void
-PeerImp::checkTransaction (Job&, int flags,
-    STTx::pointer stx)
-{
-    // VFALCO TODO Rewrite to not use exceptions
-    try
-    {
-        // Expired?
-        if (stx->isFieldPresent(sfLastLedgerSequence) &&
-            (stx->getFieldU32 (sfLastLedgerSequence) <
-            getApp().getLedgerMaster().getValidLedgerIndex()))
-        {
-            getApp().getHashRouter().setFlag(stx->getTransactionID(), SF_BAD);
-            return charge (Resource::feeUnwantedData);
-        }
-
-        auto validate = (flags & SF_SIGGOOD) ? Validate::NO : Validate::YES;
-        auto tx = std::make_shared<Transaction> (stx, validate);
-
-        if (tx->getStatus () == INVALID)
-        {
-            getApp().getHashRouter ().setFlag (stx->getTransactionID (), SF_BAD);
-            return charge (Resource::feeInvalidSignature);
-        }
-        else
-        {
-            getApp().getHashRouter ().setFlag (stx->getTransactionID (), SF_SIGGOOD);
-        }
-
-        bool const trusted (flags & SF_TRUSTED);
-        getApp().getOPs ().processTransaction (tx, trusted, false, false);
-    }
-    catch (...)
-    {
-        getApp().getHashRouter ().setFlag (stx->getTransactionID (), SF_BAD);
-        charge (Resource::feeInvalidRequest);
-    }
-}
-
 // Called from our JobQueue
 void
 PeerImp::checkPropose (Job& job,
@@ -41,7 +41,9 @@
 #include <beast/http/message.h>
 #include <beast/http/parser.h>
 #include <beast/utility/WrappedSink.h>
+#include <atomic>
 #include <cstdint>
+#include <deque>
 #include <queue>
 
 namespace ripple {
@@ -134,10 +136,19 @@ private:
     Resource::Consumer usage_;
     PeerFinder::Slot::ptr slot_;
     beast::asio::streambuf read_buffer_;
+    // Moving average of received message sizes, used to size reads
+    std::size_t read_message_bytes_ = 0;
+    std::atomic <std::uint64_t> bytes_read_ {0};
+    std::atomic <std::uint64_t> reads_ {0};
+    std::atomic <std::uint64_t> messages_read_ {0};
     beast::http::message http_message_;
     beast::http::body http_body_;
     beast::asio::streambuf write_buffer_;
-    std::queue<Message::pointer> send_queue_;
+    std::deque<Message::pointer> send_queue_;
+    // Number of messages at the front of send_queue_ being written
+    std::size_t send_count_ = 0;
+    // Holds small messages coalesced into a single write
+    std::vector<std::uint8_t> send_batch_;
     bool gracefulClose_ = false;
     std::unique_ptr <LoadEvent> load_event_;
     std::unique_ptr<Validators::Connection> validatorsConnection_;
@@ -315,10 +326,18 @@ private:
     void
     doProtocolStart ();
 
+    // Returns the number of bytes to ask for in the next read
+    std::size_t
+    readSize () const;
+
     // Called when protocol message bytes are received
     void
     onReadMessage (error_code ec, std::size_t bytes_transferred);
 
+    // Starts writing the messages at the front of the send queue
+    void
+    writeQueued ();
+
     // Called when protocol messages bytes are sent
     void
     onWriteMessage (error_code ec, std::size_t bytes_transferred);
@@ -400,9 +419,6 @@ private:
     void
     doFetchPack (const std::shared_ptr<protocol::TMGetObjectByHash>& packet);
 
-    void
-    checkTransaction (Job&, int flags, STTx::pointer stx);
-
     void
     checkPropose (Job& job,
         std::shared_ptr<protocol::TMProposeSet> const& packet,
@@ -27,8 +27,14 @@ namespace Tuning
 
 enum
 {
-    /** Size of buffer used to read from the socket. */
-    readBufferBytes     = 4096
+    /** Smallest buffer used to read from the socket. */
+    readBufferBytes     = 4096,
+
+    /** Largest buffer used to read from the socket. */
+    readBufferMaxBytes  = 262144,
+
+    /** Most bytes of queued messages coalesced into one write. */
+    sendBatchBytes      = 65536
 };
 
 } // Tuning
@@ -72,6 +72,7 @@ JSS ( affected );                   // out: AcceptedLedgerTx
 JSS ( age );                        // out: UniqueNodeList, NetworkOPs
 JSS ( alternatives );               // out: PathRequest, RipplePathFind
 JSS ( amendment_blocked );          // out: NetworkOPs
+JSS ( applied_per_second );         // out: NetworkOPs
 JSS ( asks );                       // out: Subscribe
 JSS ( authorized );                 // out: AccountLines
 JSS ( balance );                    // out: AccountLines
@@ -86,7 +87,9 @@ JSS ( both );                       // in: Subscribe, Unsubscribe
 JSS ( both_sides );                 // in: Subscribe, Unsubscribe
 JSS ( build_path );                 // in: TransactionSign
 JSS ( build_version );              // out: NetworkOPs
+JSS ( bytes_read );                 // out: PeerImp
 JSS ( can_delete );                 // out: CanDelete
+JSS ( capacity );                   // out: NetworkOPs
 JSS ( check_nodes );                // in: LedgerCleaner
 JSS ( clear );                      // in/out: FetchInfo
 JSS ( close_time );                 // in: Application, out: NetworkOPs,
@@ -117,7 +120,7 @@ JSS ( dbKBLedger );                 // out: getCounts
 JSS ( dbKBTotal );                  // out: getCounts
 JSS ( dbKBTransaction );            // out: getCounts
 JSS ( debug_signing );              // in: TransactionSign
-JSS ( delivered_amount );           // out: addPaymentDeliveredAmount
+JSS ( delivered_amount );           // out: getDeliveredAmount
 JSS ( deprecated );                 // out: WalletSeed
 JSS ( descending );                 // in: AccountTx*
 JSS ( destination_account );        // in: PathRequest, RipplePathFind
@@ -127,6 +130,7 @@ JSS ( dir_entry );                  // out: DirectoryEntryIterator
 JSS ( dir_index );                  // out: DirectoryEntryIterator
 JSS ( dir_root );                   // out: DirectoryEntryIterator
 JSS ( directory );                  // in: LedgerEntry
+JSS ( dropped );                    // out: NetworkOPs
 JSS ( enabled );                    // out: AmendmentTable
 JSS ( engine_result );              // out: NetworkOPs, TransactionSign, Submit
 JSS ( engine_result_code );         // out: NetworkOPs, TransactionSign, Submit
@@ -221,6 +225,8 @@ JSS ( master_seed );                // out: WalletPropose
 JSS ( master_seed_hex );            // out: WalletPropose
 JSS ( max_ledger );                 // in/out: LedgerCleaner
 JSS ( message );                    // error.
+JSS ( messages_per_read );          // out: PeerImp
+JSS ( messages_read );              // out: PeerImp
 JSS ( meta );                       // out: NetworkOPs, AccountTx*, Tx
 JSS ( metaData );                   // out: LedgerEntrySet, LedgerToJson
 JSS ( metadata );                   // out: TransactionEntry
@@ -243,12 +249,15 @@ JSS ( node_reads_hit );             // out: GetCounts
 JSS ( node_reads_total );           // out: GetCounts
 JSS ( node_writes );                // out: GetCounts
 JSS ( node_written_bytes );         // out: GetCounts
-JSS ( nodes );                      // out: LedgerEntrySet, PathState
+JSS ( nodes );                      // out: LedgerEntrySet, PathState,
+                                    //      InboundLedger
+JSS ( nodes_per_second );           // out: InboundLedger
 JSS ( offer );                      // in: LedgerEntry
 JSS ( offers );                     // out: NetworkOPs, AccountOffers, Subscribe
 JSS ( offline );                    // in: TransactionSign
 JSS ( offset );                     // in/out: AccountTxOld
 JSS ( open );                       // out: handlers/Ledger
+JSS ( outstanding );                // out: InboundLedger
 JSS ( owner );                      // in: LedgerEntry, out: NetworkOPs
 JSS ( owner_funds );                // out: NetworkOPs, AcceptedLedgerTx
 JSS ( params );                     // RPC
@@ -278,8 +287,10 @@ JSS ( published_ledger );           // out: NetworkOPs
 JSS ( quality );                    // out: NetworkOPs
 JSS ( quality_in );                 // out: AccountLines
 JSS ( quality_out );                // out: AccountLines
+JSS ( queued );                     // out: NetworkOPs
 JSS ( random );                     // out: Random
 JSS ( raw_meta );                   // out: AcceptedLedgerTx
+JSS ( reads );                      // out: PeerImp
 JSS ( receive_currencies );         // out: AccountCurrencies
 JSS ( regular_seed );               // in/out: LedgerEntry
 JSS ( remote );                     // out: Logic.h
@@ -336,6 +347,7 @@ JSS ( transTreeHash );              // out: ledger/Ledger.cpp
 JSS ( transaction );                // in: Tx
                                     // out: NetworkOPs, AcceptedLedgerTx,
 JSS ( transaction_hash );           // out: LedgerProposal, LedgerToJson
+JSS ( transaction_queue );          // out: NetworkOPs, GetCounts
 JSS ( transactions );               // out: LedgerToJson,
                                     // in: AccountTx*, Unsubscribe
 JSS ( treenode_cache_size );        // out: GetCounts
@@ -294,6 +294,11 @@ struct KeyPair
     RippleAddress publicKey;
 };
 
+/** Returns `true` if the S half of an ed25519 signature is below the
+    subgroup order, so that the signature is not malleable.
+*/
+bool isCanonicalEd25519Signature (std::uint8_t const* signature);
+
 uint256 keyFromSeed (uint128 const& seed);
 
 RippleAddress getSeedFromRPC (Json::Value const& params);
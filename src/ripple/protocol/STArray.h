@@ -24,6 +24,10 @@
 #include <ripple/protocol/STObject.h>
 #include <boost/ptr_container/ptr_vector.hpp>
 
+namespace Json {
+class Array;
+}
+
 namespace ripple {
 
 class STArray final
@@ -179,6 +183,9 @@ public:
     virtual std::string getText () const override;
 
     virtual Json::Value getJson (int index) const override;
+
+    /** Write the elements getJson would return into a streaming array. */
+    void writeJson (Json::Array&, int options) const;
     virtual void add (Serializer & s) const override;
 
     void sort (bool (*compare) (const STObject & o1, const STObject & o2));
@@ -48,6 +48,7 @@ public:
     std::string getFullText () const override;
     std::string getText () const override;
     Json::Value getJson (int options) const override;
+    void writeJson (Json::Object&, int options) const override;
 
     uint256 const& getIndex () const
     {
@@ -27,6 +27,10 @@
 #include <ripple/protocol/SOTemplate.h>
 #include <boost/ptr_container/ptr_vector.hpp>
 
+namespace Json {
+class Object;
+}
+
 namespace ripple {
 
 class STArray;
@@ -123,6 +127,14 @@ public:
     // TODO(tom): options should be an enum.
     virtual Json::Value getJson (int options) const override;
 
+    /** Write the fields getJson would return into a streaming object.
+
+        Nested objects and arrays are written as they are visited, so no
+        Json::Value is built for them. Fields appear in their canonical
+        order rather than sorted by name.
+    */
+    virtual void writeJson (Json::Object&, int options) const;
+
     int addObject (const STBase & t)
     {
         mData.push_back (t.duplicate ().release ());
@@ -429,6 +441,16 @@ private:
     const SOTemplate* mType;
 };
 
+//------------------------------------------------------------------------------
+
+/** Write an object's fields into a generic JSON object.
+
+    The target may be a Json::Value or a streaming Json::Object, so code
+    templated on the kind of object it produces can write either.
+*/
+void writeJson (Json::Value&, STObject const&, int options);
+void writeJson (Json::Object&, STObject const&, int options);
+
 } // ripple
 
 #endif
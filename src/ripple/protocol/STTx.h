@@ -107,6 +107,7 @@ public:
 
     virtual Json::Value getJson (int options) const override;
     virtual Json::Value getJson (int options, bool binary) const;
+    virtual void writeJson (Json::Object&, int options) const override;
 
     void sign (RippleAddress const& private_key);
 
@@ -155,6 +156,15 @@ private:
     mutable boost::tribool sig_state_;
 };
 
+/** Check the signatures of a group of transactions.
+
+    Transactions signed with ed25519 keys are verified together in one
+    batch, falling back to individual verification if the batch fails.
+    Other transactions are checked one at a time. On return every
+    transaction's signature state is known, so checkSign() returns at once.
+*/
+void checkSigns (std::vector<STTx::pointer> const& txns);
+
 bool passesLocalChecks (STObject const& st, std::string&);
 bool passesLocalChecks (STObject const& st);
 
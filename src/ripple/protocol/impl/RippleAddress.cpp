@@ -38,7 +38,6 @@
 
 namespace ripple {
 
-static
 bool isCanonicalEd25519Signature (std::uint8_t const* signature)
 {
     using std::uint8_t;
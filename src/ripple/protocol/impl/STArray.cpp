@@ -19,6 +19,7 @@
 
 #include <BeastConfig.h>
 #include <ripple/basics/Log.h>
+#include <ripple/json/Object.h>
 #include <ripple/protocol/STBase.h>
 #include <ripple/protocol/STArray.h>
 
@@ -121,6 +122,23 @@ Json::Value STArray::getJson (int p) const
     return v;
 }
 
+void STArray::writeJson (Json::Array& json, int p) const
+{
+    int index = 1;
+    for (auto const& object: value)
+    {
+        if (object.getSType () != STI_NOTPRESENT)
+        {
+            auto inner = json.appendObject ();
+            auto const& fname = object.getFName ();
+            auto k = fname.hasName () ? fname.fieldName : std::to_string(index);
+            auto child = inner.setObject (k);
+            object.writeJson (child, p);
+            index++;
+        }
+    }
+}
+
 void STArray::add (Serializer& s) const
 {
     for (STObject const& object : value)
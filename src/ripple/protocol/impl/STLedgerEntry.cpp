@@ -19,6 +19,7 @@
 
 #include <BeastConfig.h>
 #include <ripple/basics/Log.h>
+#include <ripple/json/Object.h>
 #include <ripple/json/to_string.h>
 #include <ripple/protocol/Indexes.h>
 #include <ripple/protocol/JsonFields.h>
@@ -119,6 +120,12 @@ Json::Value STLedgerEntry::getJson (int options) const
     return ret;
 }
 
+void STLedgerEntry::writeJson (Json::Object& json, int options) const
+{
+    STObject::writeJson (json, options);
+    json[jss::index] = to_string (mIndex);
+}
+
 bool STLedgerEntry::isThreadedType ()
 {
     return getFieldIndex (sfPreviousTxnID) != -1;
@@ -19,6 +19,7 @@
 
 #include <BeastConfig.h>
 #include <ripple/basics/Log.h>
+#include <ripple/json/Object.h>
 #include <ripple/json/json_reader.h>
 #include <ripple/json/to_string.h>
 #include <ripple/protocol/STBase.h>
@@ -872,6 +873,41 @@ Json::Value STObject::getJson (int options) const
     return ret;
 }
 
+void STObject::writeJson (Json::Object& json, int options) const
+{
+    // Matches getJson, which also never advances the index
+    int index = 1;
+    for (auto const& it: mData)
+    {
+        if (it.getSType () == STI_NOTPRESENT)
+            continue;
+
+        auto const& n = it.getFName ();
+        auto key = n.hasName () ? std::string(n.getJsonName ()) :
+                std::to_string (index);
+
+        switch (it.getSType ())
+        {
+        case STI_OBJECT:
+        {
+            auto object = json.setObject (key);
+            static_cast <STObject const&> (it).writeJson (object, options);
+            break;
+        }
+
+        case STI_ARRAY:
+        {
+            auto array = json.setArray (key);
+            static_cast <STArray const&> (it).writeJson (array, options);
+            break;
+        }
+
+        default:
+            json.set (key, it.getJson (options));
+        }
+    }
+}
+
 bool STObject::operator== (const STObject& obj) const
 {
     // This is not particularly efficient, and only compares data elements
@@ -923,4 +959,16 @@ bool STObject::operator== (const STObject& obj) const
     return true;
 }
 
+//------------------------------------------------------------------------------
+
+void writeJson (Json::Value& json, STObject const& object, int options)
+{
+    Json::copyFrom (json, object.getJson (options));
+}
+
+void writeJson (Json::Object& json, STObject const& object, int options)
+{
+    object.writeJson (json, options);
+}
+
 } // ripple
@@ -28,8 +28,10 @@
 #include <ripple/protocol/STParsedJSON.h>
 #include <ripple/protocol/TxFlags.h>
 #include <ripple/basics/StringUtilities.h>
+#include <ripple/json/Object.h>
 #include <ripple/json/to_string.h>
 #include <beast/unit_test/suite.h>
+#include <ed25519-donna/ed25519.h>
 #include <boost/format.hpp>
 #include <array>
 
@@ -217,6 +219,73 @@ bool STTx::checkSign () const
     return static_cast<bool> (sig_state_);
 }
 
+void checkSigns (std::vector<STTx::pointer> const& txns)
+{
+    // Signatures made with ed25519 keys, to be verified together
+    std::vector<STTx const*> batch;
+    std::vector<Blob> messages;
+    std::vector<Blob> keys;
+    std::vector<Blob> signatures;
+
+    for (auto const& txn : txns)
+    {
+        if (txn->isKnownGood () || txn->isKnownBad ())
+            continue;
+
+        try
+        {
+            Blob key = txn->getFieldVL (sfSigningPubKey);
+            Blob signature = txn->getFieldVL (sfTxnSignature);
+
+            if (key.size () == 33 && key[0] == 0xED && signature.size () == 64)
+            {
+                batch.push_back (txn.get ());
+                messages.push_back (getSigningData (*txn));
+                keys.push_back (std::move (key));
+                signatures.push_back (std::move (signature));
+                continue;
+            }
+        }
+        catch (...)
+        {
+            txn->setBad ();
+            continue;
+        }
+
+        txn->checkSign ();
+    }
+
+    if (batch.empty ())
+        return;
+
+    std::vector<unsigned char const*> m, pk, rs;
+    std::vector<std::size_t> mlen;
+    m.reserve (batch.size ());
+    mlen.reserve (batch.size ());
+    pk.reserve (batch.size ());
+    rs.reserve (batch.size ());
+
+    for (std::size_t i = 0; i < batch.size (); ++i)
+    {
+        m.push_back (messages[i].data ());
+        mlen.push_back (messages[i].size ());
+        pk.push_back (&keys[i][1]);
+        rs.push_back (signatures[i].data ());
+    }
+
+    std::vector<int> valid (batch.size ());
+    ed25519_sign_open_batch (m.data (), mlen.data (), pk.data (),
+        rs.data (), batch.size (), valid.data ());
+
+    for (std::size_t i = 0; i < batch.size (); ++i)
+    {
+        if (valid[i] && isCanonicalEd25519Signature (signatures[i].data ()))
+            batch[i]->setGood ();
+        else
+            batch[i]->setBad ();
+    }
+}
+
 void STTx::setSigningPubKey (RippleAddress const& naSignPubKey)
 {
     setFieldVL (sfSigningPubKey, naSignPubKey.getAccountPublic ());
@@ -234,6 +303,12 @@ Json::Value STTx::getJson (int) const
     return ret;
 }
 
+void STTx::writeJson (Json::Object& json, int) const
+{
+    STObject::writeJson (json, 0);
+    json[jss::hash] = to_string (getTransactionID ());
+}
+
 Json::Value STTx::getJson (int options, bool binary) const
 {
     if (binary)
@@ -19,9 +19,14 @@
 
 #include <BeastConfig.h>
 #include <ripple/basics/Log.h>
+#include <ripple/basics/mulDiv.h>
+#include <ripple/basics/tests/benchmark.h>
 #include <ripple/crypto/CBigNum.h>
 #include <ripple/protocol/STAmount.h>
 #include <beast/unit_test/suite.h>
+#include <random>
+#include <string>
+#include <vector>
 
 namespace ripple {
 
@@ -560,6 +565,113 @@ public:
 
     //--------------------------------------------------------------------------
 
+    // The BIGNUM computation that mulDiv replaced in STAmount arithmetic
+    static std::uint64_t bnMulDiv (std::uint64_t a, std::uint64_t b,
+        std::uint64_t c, std::uint64_t d)
+    {
+        CBigNum v;
+
+        if ((BN_add_word64 (&v, a) != 1) || (BN_mul_word64 (&v, b) != 1))
+            throw std::runtime_error ("internal bn error");
+
+        if (c != 0)
+            BN_add_word64 (&v, c);
+
+        if (BN_div_word64 (&v, d) == ((std::uint64_t) - 1))
+            throw std::runtime_error ("internal bn error");
+
+        return v.getuint64 ();
+    }
+
+    void testMulDiv ()
+    {
+        testcase ("mulDiv");
+
+        std::uint64_t const tenTo14 = 100000000000000ull;
+        std::uint64_t const tenTo17 = tenTo14 * 1000;
+
+        // Mantissas as they reach the arithmetic: IOU values and native
+        // values scaled up to at least cMinValue.
+        std::mt19937_64 gen (42);
+        std::uniform_int_distribution <std::uint64_t> mantissa (
+            STAmount::cMinValue, STAmount::cMaxNativeN);
+
+        std::vector <std::uint64_t> edges = {
+            STAmount::cMinValue, STAmount::cMaxValue,
+            STAmount::cMaxNativeN };
+
+        auto check = [&](std::uint64_t a, std::uint64_t b,
+            std::uint64_t c, std::uint64_t d)
+        {
+            auto const expected = bnMulDiv (a, b, c, d);
+            auto const actual = mulDiv (a, b, c, d);
+            auto const portable = detail::mulDivPortable (a, b, c, d);
+            if (actual != expected || portable != expected)
+            {
+                log << a << " * " << b << " + " << c << " / " << d <<
+                    " = " << actual << " (portable " << portable <<
+                    "), expected " << expected;
+                return false;
+            }
+            return true;
+        };
+
+        bool ok = true;
+
+        for (auto a : edges)
+        {
+            for (auto b : edges)
+            {
+                // multiply, mulRound
+                ok = check (a, b, 0, tenTo14) && ok;
+                ok = check (a, b, tenTo14 - 1, tenTo14) && ok;
+                // divide, divRound
+                ok = check (a, tenTo17, 0, b) && ok;
+                ok = check (a, tenTo17, b - 1, b) && ok;
+            }
+        }
+
+        for (int i = 0; i < 100000; ++i)
+        {
+            auto const a = mantissa (gen);
+            auto const b = mantissa (gen);
+
+            ok = check (a, b, 0, tenTo14) && ok;
+            ok = check (a, b, tenTo14 - 1, tenTo14) && ok;
+            ok = check (a, tenTo17, 0, b) && ok;
+            ok = check (a, tenTo17, b - 1, b) && ok;
+        }
+
+        // Arbitrary operands whose quotient fits in 64 bits
+        std::uniform_int_distribution <std::uint64_t> any;
+        for (int i = 0; i < 100000; ++i)
+        {
+            auto const a = any (gen) >> 1;
+            auto const b = any (gen) >> (1 + i % 63);
+            auto const d = std::max<std::uint64_t> (b, 1);
+
+            ok = check (a, b, any (gen), d) && ok;
+        }
+
+        expect (ok, "mulDiv differs from BIGNUM");
+        expect (mulDiv (~0ull, ~0ull, ~0ull, 1) == ~0ull,
+            "quotient should saturate");
+        expect (detail::mulDivPortable (~0ull, ~0ull, ~0ull, 1) == ~0ull,
+            "portable quotient should saturate");
+
+        try
+        {
+            mulDiv (1, 1, 0, 0);
+            fail ("division by zero should throw");
+        }
+        catch (std::runtime_error const&)
+        {
+            pass ();
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
     void run ()
     {
         testSetValue ();
@@ -568,9 +680,87 @@ public:
         testArithmetic ();
         testUnderflow ();
         testRounding ();
+        testMulDiv ();
     }
 };
 
 BEAST_DEFINE_TESTSUITE(STAmount,ripple_data,ripple);
 
+//------------------------------------------------------------------------------
+
+// Measures the IOU arithmetic performed for every offer crossed, using
+// the 128-bit path and the BIGNUM path it replaced.
+class STAmountArithmetic_test : public beast::unit_test::suite
+{
+public:
+    template <class Function>
+    std::string
+    rate (std::size_t n, Function&& f)
+    {
+        auto const start = test::benchmark_clock::now();
+        for (std::size_t i = 0; i < n; ++i)
+            f (i);
+        return test::format_rate (test::per_second (
+            n, test::seconds_since (start)));
+    }
+
+    void
+    run () override
+    {
+        std::size_t const n = 1000000;
+        std::uint64_t const tenTo14 = 100000000000000ull;
+
+        std::mt19937_64 gen (42);
+        std::uniform_int_distribution <std::uint64_t> mantissa (
+            STAmount::cMinValue, STAmount::cMaxValue);
+        std::uniform_int_distribution <int> exponent (-20, 20);
+
+        std::vector <STAmount> amounts;
+        amounts.reserve (n + 1);
+        for (std::size_t i = 0; i <= n; ++i)
+            amounts.emplace_back (noIssue(), mantissa (gen),
+                exponent (gen));
+
+        std::uint64_t sink = 0;
+
+        testcase ("mulDiv");
+        log << "BIGNUM: " << rate (n, [&](std::size_t i)
+            {
+                sink += STAmount_test::bnMulDiv (amounts[i].mantissa(),
+                    amounts[i + 1].mantissa(), tenTo14 - 1, tenTo14);
+            }) << " ops/s";
+        log << "128-bit: " << rate (n, [&](std::size_t i)
+            {
+                sink += mulDiv (amounts[i].mantissa(),
+                    amounts[i + 1].mantissa(), tenTo14 - 1, tenTo14);
+            }) << " ops/s";
+
+        testcase ("STAmount");
+        log << "multiply: " << rate (n, [&](std::size_t i)
+            {
+                sink += multiply (amounts[i], amounts[i + 1],
+                    noIssue()).mantissa();
+            }) << " ops/s";
+        log << "divide: " << rate (n, [&](std::size_t i)
+            {
+                sink += divide (amounts[i], amounts[i + 1],
+                    noIssue()).mantissa();
+            }) << " ops/s";
+        log << "mulRound: " << rate (n, [&](std::size_t i)
+            {
+                sink += mulRound (amounts[i], amounts[i + 1],
+                    noIssue(), true).mantissa();
+            }) << " ops/s";
+        log << "divRound: " << rate (n, [&](std::size_t i)
+            {
+                sink += divRound (amounts[i], amounts[i + 1],
+                    noIssue(), true).mantissa();
+            }) << " ops/s";
+
+        expect (sink != 0);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(STAmountArithmetic,ripple_data,ripple);
+
 } // ripple
@@ -18,8 +18,12 @@
 //==============================================================================
 
 #include <BeastConfig.h>
+#include <ripple/basics/tests/benchmark.h>
 #include <ripple/protocol/STTx.h>
 #include <ripple/protocol/STParsedJSON.h>
+#include <ripple/protocol/RippleAddress.h>
+#include <ripple/json/json_reader.h>
+#include <ripple/json/Object.h>
 #include <ripple/json/to_string.h>
 #include <beast/unit_test/suite.h>
 
@@ -28,8 +32,10 @@ namespace ripple {
 class STTx_test : public beast::unit_test::suite
 {
 public:
-    void run()
+    void testSerialization()
     {
+        testcase ("serialization");
+
         RippleAddress seed;
         seed.setSeedRandom ();
         RippleAddress generator = RippleAddress::createGeneratorPublic (seed);
@@ -77,8 +83,158 @@ public:
             pass ();
         }
     }
+
+    STTx::pointer
+    makeSigned (KeyPair const& keys, std::uint32_t seq)
+    {
+        auto txn = std::make_shared<STTx> (ttACCOUNT_SET);
+        txn->setSourceAccount (keys.publicKey);
+        txn->setSigningPubKey (keys.publicKey);
+        txn->setSequence (seq);
+        txn->sign (keys.secretKey);
+        return txn;
+    }
+
+    void testCheckSigns()
+    {
+        testcase ("checkSigns");
+
+        RippleAddress seed;
+        seed.setSeedRandom ();
+        KeyPair const ed = generateKeysFromSeed (KeyType::ed25519, seed);
+        KeyPair const secp = generateKeysFromSeed (KeyType::secp256k1, seed);
+
+        std::vector<STTx::pointer> txns;
+        for (std::uint32_t i = 1; i <= 10; ++i)
+            txns.push_back (makeSigned (ed, i));
+        txns.push_back (makeSigned (secp, 11));
+
+        // Invalidate one ed25519 signature after signing
+        auto bad = makeSigned (ed, 12);
+        bad->setSequence (13);
+        txns.push_back (bad);
+
+        checkSigns (txns);
+
+        for (std::size_t i = 0; i + 1 < txns.size (); ++i)
+            expect (txns[i]->isKnownGood (), "Signature should be good");
+        expect (bad->isKnownBad (), "Signature should be bad");
+
+        // The cached state agrees with individual verification
+        for (auto const& txn : txns)
+        {
+            Serializer s;
+            txn->add (s);
+            SerialIter sit (s);
+            STTx copy (sit);
+            expect (txn->checkSign () == copy.checkSign (),
+                "Batch and individual results differ");
+        }
+    }
+
+    static
+    STTx
+    makeWithMemos (int count)
+    {
+        RippleAddress seed;
+        seed.setSeedRandom ();
+        KeyPair const keys = generateKeysFromSeed (KeyType::secp256k1, seed);
+
+        STTx txn (ttACCOUNT_SET);
+        txn.setSourceAccount (keys.publicKey);
+        txn.setSigningPubKey (keys.publicKey);
+
+        STArray memos;
+        for (int i = 0; i < count; ++i)
+        {
+            STObject memo (sfMemo);
+            memo.setFieldVL (sfMemoType, Blob (8, i));
+            memo.setFieldVL (sfMemoData, Blob (32, 255 - i));
+            memos.push_back (memo);
+        }
+        txn.setFieldArray (sfMemos, memos);
+        txn.sign (keys.secretKey);
+        return txn;
+    }
+
+    void testWriteJson()
+    {
+        testcase ("writeJson");
+
+        STTx const txn = makeWithMemos (3);
+
+        std::string streamed;
+        {
+            auto object = Json::stringWriterObject (streamed);
+            txn.writeJson (*object, 0);
+        }
+
+        Json::Value parsed;
+        expect (Json::Reader ().parse (streamed, parsed),
+            "Streamed JSON does not parse");
+        expect (to_string (parsed) == to_string (txn.getJson (0)),
+            "Streamed JSON differs from getJson");
+        expect (parsed[sfMemos.getJsonName ()].size () == 3);
+
+        // The Json::Value overload produces the same tree as getJson
+        Json::Value value (Json::objectValue);
+        writeJson (value, txn, 0);
+        expect (value == txn.getJson (0));
+    }
+
+    void run()
+    {
+        testSerialization();
+        testCheckSigns();
+        testWriteJson();
+    }
 };
 
 BEAST_DEFINE_TESTSUITE(STTx,ripple_app,ripple);
 
+//------------------------------------------------------------------------------
+
+// Compares rendering a transaction through a Json::Value tree with
+// streaming it straight to the output.
+class STTxJson_test : public beast::unit_test::suite
+{
+public:
+    template <class Function>
+    void
+    measure (std::string const& name, std::size_t n, Function&& f)
+    {
+        std::size_t bytes = 0;
+        auto const start = test::benchmark_clock::now();
+        for (std::size_t i = 0; i < n; ++i)
+            bytes += f ();
+        log << name << ": " << test::format_rate (test::per_second (
+            bytes, test::seconds_since (start))) << " bytes/s";
+    }
+
+    void
+    run () override
+    {
+        std::size_t const n = 20000;
+        STTx const txn = STTx_test::makeWithMemos (16);
+
+        testcase ("render");
+        measure ("Json::Value", n, [&]()
+            {
+                return to_string (txn.getJson (0)).size ();
+            });
+        measure ("streaming", n, [&]()
+            {
+                std::string s;
+                {
+                    auto object = Json::stringWriterObject (s);
+                    txn.writeJson (*object, 0);
+                }
+                return s.size ();
+            });
+        pass ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(STTxJson,ripple_app,ripple);
+
 } // ripple
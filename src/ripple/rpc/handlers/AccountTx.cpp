@@ -18,48 +18,52 @@
 //==============================================================================
 
 #include <BeastConfig.h>
+#include <ripple/protocol/ErrorCodes.h>
+#include <ripple/rpc/handlers/AccountTx.h>
 #include <ripple/server/Role.h>
 
 namespace ripple {
+namespace RPC {
 
-// {
-//   account: account,
-//   ledger_index_min: ledger_index  // optional, defaults to earliest
-//   ledger_index_max: ledger_index, // optional, defaults to latest
-//   binary: boolean,                // optional, defaults to false
-//   forward: boolean,               // optional, defaults to false
-//   limit: integer,                 // optional
-//   marker: opaque                  // optional, resume previous query
-// }
-Json::Value doAccountTx (RPC::Context& context)
+AccountTxHandler::AccountTxHandler (Context& context) : context_ (context)
 {
-    auto& params = context.params;
-
-    RippleAddress   raAccount;
-    int limit = params.isMember (jss::limit) ?
-            params[jss::limit].asUInt () : -1;
-    bool bBinary = params.isMember (jss::binary) && params[jss::binary].asBool ();
-    bool bForward = params.isMember (jss::forward) && params[jss::forward].asBool ();
-    std::uint32_t   uLedgerMin;
-    std::uint32_t   uLedgerMax;
-    std::uint32_t   uValidatedMin;
-    std::uint32_t   uValidatedMax;
-    bool bValidated = context.netOps.getValidatedRange (
-        uValidatedMin, uValidatedMax);
-
-    if (!bValidated)
+}
+
+Status AccountTxHandler::check ()
+{
+    auto const& params = context_.params;
+
+    // Temporary switching code until the old account_tx is removed
+    if (params.isMember (jss::offset) ||
+        params.isMember (jss::count) ||
+        params.isMember (jss::descending) ||
+        params.isMember (jss::ledger_max) ||
+        params.isMember (jss::ledger_min))
+    {
+        old_ = true;
+        result_ = doAccountTxOld (context_);
+        return Status::OK;
+    }
+
+    if (params.isMember (jss::limit))
+        limit_ = params[jss::limit].asUInt ();
+    binary_ = params.isMember (jss::binary) && params[jss::binary].asBool ();
+    bool const forward =
+            params.isMember (jss::forward) && params[jss::forward].asBool ();
+
+    if (!context_.netOps.getValidatedRange (validatedMin_, validatedMax_))
     {
         // Don't have a validated ledger range.
-        return rpcError (rpcLGR_IDXS_INVALID);
+        return rpcLGR_IDXS_INVALID;
     }
 
     if (!params.isMember (jss::account))
-        return rpcError (rpcINVALID_PARAMS);
+        return rpcINVALID_PARAMS;
 
-    if (!raAccount.setAccountID (params[jss::account].asString ()))
-        return rpcError (rpcACT_MALFORMED);
+    if (!account_.setAccountID (params[jss::account].asString ()))
+        return rpcACT_MALFORMED;
 
-    context.loadType = Resource::feeMediumBurdenRPC;
+    context_.loadType = Resource::feeMediumBurdenRPC;
 
     if (params.isMember (jss::ledger_index_min) ||
         params.isMember (jss::ledger_index_max))
@@ -69,107 +73,74 @@ Json::Value doAccountTx (RPC::Context& context)
         std::int64_t iLedgerMax  = params.isMember (jss::ledger_index_max)
                 ? params[jss::ledger_index_max].asInt () : -1;
 
-        uLedgerMin  = iLedgerMin == -1 ? uValidatedMin :
-            ((iLedgerMin >= uValidatedMin) ? iLedgerMin : uValidatedMin);
-        uLedgerMax  = iLedgerMax == -1 ? uValidatedMax :
-            ((iLedgerMax <= uValidatedMax) ? iLedgerMax : uValidatedMax);
+        ledgerMin_  = iLedgerMin == -1 ? validatedMin_ :
+            ((iLedgerMin >= validatedMin_) ? iLedgerMin : validatedMin_);
+        ledgerMax_  = iLedgerMax == -1 ? validatedMax_ :
+            ((iLedgerMax <= validatedMax_) ? iLedgerMax : validatedMax_);
 
-        if (uLedgerMax < uLedgerMin)
-            return rpcError (rpcLGR_IDXS_INVALID);
+        if (ledgerMax_ < ledgerMin_)
+            return rpcLGR_IDXS_INVALID;
     }
     else
     {
-        Ledger::pointer l;
-        Json::Value ret = RPC::lookupLedger (params, l, context.netOps);
-
-        if (!l)
-            return ret;
+        Ledger::pointer ledger;
+        Json::Value unused;
+        if (auto s = RPC::lookupLedger (
+                params, ledger, context_.netOps, unused))
+            return s;
 
-        uLedgerMin = uLedgerMax = l->getLedgerSeq ();
+        ledgerMin_ = ledgerMax_ = ledger->getLedgerSeq ();
     }
 
-    Json::Value resumeToken;
-
     if (params.isMember(jss::marker))
-         resumeToken = params[jss::marker];
+         resumeToken_ = params[jss::marker];
+
+    bool const admin = context_.role == Role::ADMIN;
 
 #ifndef BEAST_DEBUG
 
     try
     {
 #endif
-        Json::Value ret (Json::objectValue);
-
-        ret[jss::account] = raAccount.humanAccountID ();
-        Json::Value& jvTxns = (ret[jss::transactions] = Json::arrayValue);
-
-        if (bBinary)
+        if (binary_)
         {
-            auto txns = context.netOps.getTxsAccountB (
-                raAccount, uLedgerMin, uLedgerMax, bForward, resumeToken, limit,
-                context.role == Role::ADMIN);
-
-            for (auto& it: txns)
-            {
-                Json::Value& jvObj = jvTxns.append (Json::objectValue);
-
-                jvObj[jss::tx_blob] = std::get<0> (it);
-                jvObj[jss::meta] = std::get<1> (it);
-
-                std::uint32_t uLedgerIndex = std::get<2> (it);
-
-                jvObj[jss::ledger_index] = uLedgerIndex;
-                jvObj[jss::validated] = bValidated &&
-                    uValidatedMin <= uLedgerIndex &&
-                    uValidatedMax >= uLedgerIndex;
-            }
+            txnsBinary_ = context_.netOps.getTxsAccountB (
+                account_, ledgerMin_, ledgerMax_, forward, resumeToken_,
+                limit_, admin);
         }
         else
         {
-            auto txns = context.netOps.getTxsAccount (
-                raAccount, uLedgerMin, uLedgerMax, bForward, resumeToken, limit,
-                context.role == Role::ADMIN);
-
-            for (auto& it: txns)
+            txns_ = context_.netOps.getTxsAccount (
+                account_, ledgerMin_, ledgerMax_, forward, resumeToken_,
+                limit_, admin);
+
+            // Work out the delivered amounts up front, so that writeResult
+            // has nothing left to look up while it streams.
+            deliveredAmounts_.reserve (txns_.size ());
+            for (auto const& it: txns_)
             {
-                Json::Value& jvObj = jvTxns.append (Json::objectValue);
-
-                if (it.first)
-                    jvObj[jss::tx] = it.first->getJson (1);
-
                 if (it.second)
                 {
-                    auto meta = it.second->getJson (1);
-                    addPaymentDeliveredAmount (meta, context, it.first, it.second);
-                    jvObj[jss::meta] = meta;
-
-                    std::uint32_t uLedgerIndex = it.second->getLgrSeq ();
-
-                    jvObj[jss::validated] = bValidated &&
-                        uValidatedMin <= uLedgerIndex &&
-                        uValidatedMax >= uLedgerIndex;
+                    deliveredAmounts_.push_back (getDeliveredAmount (
+                        context_, it.first, it.second));
+                }
+                else
+                {
+                    deliveredAmounts_.emplace_back ();
                 }
-
             }
         }
-
-        //Add information about the original query
-        ret[jss::ledger_index_min] = uLedgerMin;
-        ret[jss::ledger_index_max] = uLedgerMax;
-        if (params.isMember (jss::limit))
-            ret[jss::limit]        = limit;
-        if (!resumeToken.isNull())
-            ret[jss::marker] = resumeToken;
-
-        return ret;
 #ifndef BEAST_DEBUG
     }
     catch (...)
     {
-        return rpcError (rpcINTERNAL);
+        return rpcINTERNAL;
     }
 
 #endif
+
+    return Status::OK;
 }
 
+} // RPC
 } // ripple
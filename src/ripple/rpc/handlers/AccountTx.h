@@ -0,0 +1,169 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_RPC_HANDLERS_ACCOUNTTX_H_INCLUDED
+#define RIPPLE_RPC_HANDLERS_ACCOUNTTX_H_INCLUDED
+
+#include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/json/Object.h>
+#include <ripple/server/Role.h>
+
+namespace ripple {
+namespace RPC {
+
+// {
+//   account: account,
+//   ledger_index_min: ledger_index  // optional, defaults to earliest
+//   ledger_index_max: ledger_index, // optional, defaults to latest
+//   binary: boolean,                // optional, defaults to false
+//   forward: boolean,               // optional, defaults to false
+//   limit: integer,                 // optional
+//   marker: opaque                  // optional, resume previous query
+// }
+//
+// Requests using the parameters of the old interface (offset, count,
+// descending, ledger_min or ledger_max) are answered by doAccountTxOld.
+
+class AccountTxHandler
+{
+public:
+    explicit AccountTxHandler (Context&);
+
+    Status check ();
+
+    template <class Object>
+    void writeResult (Object&);
+
+    static const char* const name()
+    {
+        return "account_tx";
+    }
+
+    static Role role()
+    {
+        return Role::USER;
+    }
+
+    static Condition condition()
+    {
+        return NEEDS_NETWORK_CONNECTION;
+    }
+
+private:
+    bool isValidated (std::uint32_t ledgerIndex) const
+    {
+        return validatedMin_ <= ledgerIndex && validatedMax_ >= ledgerIndex;
+    }
+
+    Context& context_;
+    Json::Value result_;
+    bool old_ = false;
+
+    RippleAddress account_;
+    std::uint32_t ledgerMin_ = 0;
+    std::uint32_t ledgerMax_ = 0;
+    std::uint32_t validatedMin_ = 0;
+    std::uint32_t validatedMax_ = 0;
+    int limit_ = -1;
+    bool binary_ = false;
+    Json::Value resumeToken_;
+
+    NetworkOPs::AccountTxs txns_;
+    std::vector <Json::Value> deliveredAmounts_;
+    NetworkOPs::MetaTxsList txnsBinary_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation.
+
+template <class Object>
+void AccountTxHandler::writeResult (Object& value)
+{
+    if (old_)
+    {
+        Json::copyFrom (value, result_);
+        return;
+    }
+
+    value[jss::account] = account_.humanAccountID ();
+
+    {
+        auto&& transactions = Json::setArray (value, jss::transactions);
+
+        if (binary_)
+        {
+            for (auto const& it: txnsBinary_)
+            {
+                auto&& txJson = Json::appendObject (transactions);
+
+                txJson[jss::tx_blob] = std::get<0> (it);
+                txJson[jss::meta] = std::get<1> (it);
+
+                std::uint32_t const ledgerIndex = std::get<2> (it);
+                txJson[jss::ledger_index] = ledgerIndex;
+                txJson[jss::validated] = isValidated (ledgerIndex);
+            }
+        }
+        else
+        {
+            auto delivered = deliveredAmounts_.begin ();
+            for (auto const& it: txns_)
+            {
+                auto&& txJson = Json::appendObject (transactions);
+
+                if (it.first)
+                {
+                    auto&& tx = Json::addObject (txJson, jss::tx);
+                    writeJson (tx, *it.first, 1);
+                }
+
+                if (it.second)
+                {
+                    {
+                        auto&& meta = Json::addObject (txJson, jss::meta);
+                        writeJson (meta, it.second->getAsObject (), 1);
+                        if (!delivered->isNull ())
+                            meta[jss::delivered_amount] = *delivered;
+                    }
+
+                    txJson[jss::validated] =
+                        isValidated (it.second->getLgrSeq ());
+                }
+
+                ++delivered;
+            }
+        }
+    }
+
+    //Add information about the original query
+    value[jss::ledger_index_min] = ledgerMin_;
+    value[jss::ledger_index_max] = ledgerMax_;
+    if (context_.params.isMember (jss::limit))
+        value[jss::limit] = limit_;
+    if (!resumeToken_.isNull())
+        value[jss::marker] = resumeToken_;
+}
+
+} // RPC
+} // ripple
+
+#endif
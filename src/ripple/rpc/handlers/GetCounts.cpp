@@ -70,6 +70,8 @@ Json::Value doGetCounts (RPC::Context& context)
             ret[jss::local_txs] = static_cast<Json::UInt> (c);
     }
 
+    ret[jss::transaction_queue] = app.getOPs().getTransactionQueueJson ();
+
     ret[jss::write_load] = app.getNodeStore ().getWriteLoad ();
 
     ret[jss::SLE_hit_rate] = app.getSLECache ().getHitRate ();
@@ -26,8 +26,6 @@ Json::Value doAccountCurrencies     (RPC::Context&);
 Json::Value doAccountInfo           (RPC::Context&);
 Json::Value doAccountLines          (RPC::Context&);
 Json::Value doAccountOffers         (RPC::Context&);
-Json::Value doAccountTx             (RPC::Context&);
-Json::Value doAccountTxSwitch       (RPC::Context&);
 Json::Value doAccountTxOld          (RPC::Context&);
 Json::Value doBookOffers            (RPC::Context&);
 Json::Value doBlackList             (RPC::Context&);
@@ -65,7 +63,6 @@ Json::Value doStop                  (RPC::Context&);
 Json::Value doSubmit                (RPC::Context&);
 Json::Value doSubscribe             (RPC::Context&);
 Json::Value doTransactionEntry      (RPC::Context&);
-Json::Value doTx                    (RPC::Context&);
 Json::Value doTxHistory             (RPC::Context&);
 Json::Value doUnlAdd                (RPC::Context&);
 Json::Value doUnlDelete             (RPC::Context&);
@@ -77,33 +77,31 @@ Json::Value doLedgerData (RPC::Context& context)
     Json::Value& nodes = (jvResult[jss::state] = Json::arrayValue);
     SHAMap& map = *(lpLedger->peekAccountStateMap ());
 
-    for (;;)
+    for (auto iter = map.upper_bound (resumePoint); iter != map.end (); ++iter)
     {
-       std::shared_ptr<SHAMapItem> item = map.peekNextItem (resumePoint);
-       if (!item)
-           break;
-       resumePoint = item->getTag();
-
-       if (limit-- <= 0)
-       {
-           --resumePoint;
-           jvResult[jss::marker] = to_string (resumePoint);
-           break;
-       }
-
-       if (isBinary)
-       {
-           Json::Value& entry = nodes.append (Json::objectValue);
-           entry[jss::data] = strHex (
-               item->peekData().begin(), item->peekData().size());
-           entry[jss::index] = to_string (item->getTag ());
-       }
-       else
-       {
-           SLE sle (item->peekSerializer(), item->getTag ());
-           Json::Value& entry = nodes.append (sle.getJson (0));
-           entry[jss::index] = to_string (item->getTag ());
-       }
+        std::shared_ptr<SHAMapItem> const& item = *iter;
+
+        if (limit-- <= 0)
+        {
+            resumePoint = item->getTag ();
+            --resumePoint;
+            jvResult[jss::marker] = to_string (resumePoint);
+            break;
+        }
+
+        if (isBinary)
+        {
+            Json::Value& entry = nodes.append (Json::objectValue);
+            entry[jss::data] = strHex (
+                item->peekData().begin(), item->peekData().size());
+            entry[jss::index] = to_string (item->getTag ());
+        }
+        else
+        {
+            SLE sle (item->peekSerializer(), item->getTag ());
+            Json::Value& entry = nodes.append (sle.getJson (0));
+            entry[jss::index] = to_string (item->getTag ());
+        }
     }
 
     return jvResult;
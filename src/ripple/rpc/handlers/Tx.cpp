@@ -19,67 +19,57 @@
 
 #include <BeastConfig.h>
 #include <ripple/app/tx/TransactionMaster.h>
+#include <ripple/protocol/ErrorCodes.h>
+#include <ripple/rpc/handlers/Tx.h>
 
 namespace ripple {
+namespace RPC {
 
-// {
-//   transaction: <hex>
-// }
-Json::Value doTx (RPC::Context& context)
+TxHandler::TxHandler (Context& context) : context_ (context)
 {
-    if (!context.params.isMember (jss::transaction))
-        return rpcError (rpcINVALID_PARAMS);
+}
 
-    bool binary = context.params.isMember (jss::binary)
-            && context.params[jss::binary].asBool ();
+Status TxHandler::check ()
+{
+    auto const& params = context_.params;
 
-    auto const txid  = context.params[jss::transaction].asString ();
+    if (!params.isMember (jss::transaction))
+        return rpcINVALID_PARAMS;
 
-    if (!Transaction::isHexTxID (txid))
-        return rpcError (rpcNOT_IMPL);
+    binary_ = params.isMember (jss::binary) && params[jss::binary].asBool ();
 
-    auto txn = getApp().getMasterTransaction ().fetch (uint256 (txid), true);
+    auto const txid  = params[jss::transaction].asString ();
 
-    if (!txn)
-        return rpcError (rpcTXN_NOT_FOUND);
+    if (!Transaction::isHexTxID (txid))
+        return rpcNOT_IMPL;
 
-    Json::Value ret = txn->getJson (1, binary);
+    transaction_ = getApp().getMasterTransaction ().fetch (uint256 (txid), true);
 
-    if (txn->getLedger () == 0)
-        return ret;
+    if (!transaction_)
+        return rpcTXN_NOT_FOUND;
 
-    if (auto lgr = context.netOps.getLedgerBySeq (txn->getLedger ()))
-    {
-        bool okay = false;
+    if (transaction_->getLedger () == 0)
+        return Status::OK;
 
-        if (binary)
+    if (auto lgr = context_.netOps.getLedgerBySeq (transaction_->getLedger ()))
+    {
+        if (binary_)
         {
-            std::string meta;
-
-            if (lgr->getMetaHex (txn->getID (), meta))
-            {
-                ret[jss::meta] = meta;
-                okay = true;
-            }
+            hasMeta_ = lgr->getMetaHex (transaction_->getID (), metaHex_);
         }
-        else
+        else if (lgr->getTransactionMeta (transaction_->getID (), meta_))
         {
-            TransactionMetaSet::pointer txMeta;
-
-            if (lgr->getTransactionMeta (txn->getID (), txMeta))
-            {
-                okay = true;
-                auto meta = txMeta->getJson (0);
-                addPaymentDeliveredAmount (meta, context, txn, txMeta);
-                ret[jss::meta] = meta;
-            }
+            hasMeta_ = true;
+            deliveredAmount_ = getDeliveredAmount (
+                context_, transaction_, meta_);
         }
 
-        if (okay)
-            ret[jss::validated] = context.netOps.isValidated (lgr);
+        if (hasMeta_)
+            validated_ = context_.netOps.isValidated (lgr);
     }
 
-    return ret;
+    return Status::OK;
 }
 
+} // RPC
 } // ripple
@@ -0,0 +1,103 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_RPC_HANDLERS_TX_H_INCLUDED
+#define RIPPLE_RPC_HANDLERS_TX_H_INCLUDED
+
+#include <ripple/app/tx/Transaction.h>
+#include <ripple/app/tx/TransactionMeta.h>
+#include <ripple/json/Object.h>
+#include <ripple/server/Role.h>
+
+namespace ripple {
+namespace RPC {
+
+// {
+//   transaction: <hex>
+// }
+
+class TxHandler
+{
+public:
+    explicit TxHandler (Context&);
+
+    Status check ();
+
+    template <class Object>
+    void writeResult (Object&);
+
+    static const char* const name()
+    {
+        return "tx";
+    }
+
+    static Role role()
+    {
+        return Role::USER;
+    }
+
+    static Condition condition()
+    {
+        return NEEDS_NETWORK_CONNECTION;
+    }
+
+private:
+    Context& context_;
+    Transaction::pointer transaction_;
+    TransactionMetaSet::pointer meta_;
+    std::string metaHex_;
+    Json::Value deliveredAmount_;
+    bool binary_ = false;
+    bool hasMeta_ = false;
+    bool validated_ = false;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation.
+
+template <class Object>
+void TxHandler::writeResult (Object& value)
+{
+    writeJson (value, *transaction_, 1, binary_);
+
+    if (!hasMeta_)
+        return;
+
+    if (binary_)
+    {
+        value[jss::meta] = metaHex_;
+    }
+    else
+    {
+        auto&& meta = Json::addObject (value, jss::meta);
+        writeJson (meta, meta_->getAsObject (), 0);
+        if (!deliveredAmount_.isNull ())
+            meta[jss::delivered_amount] = deliveredAmount_;
+    }
+
+    value[jss::validated] = validated_;
+}
+
+} // RPC
+} // ripple
+
+#endif
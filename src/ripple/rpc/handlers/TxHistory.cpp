@@ -48,8 +48,8 @@ Json::Value doTxHistory (RPC::Context& context)
                     % startIndex);
 
     {
-        auto db = getApp().getTxnDB ().getDB ();
-        auto sl (getApp().getTxnDB ().lock ());
+        auto reader (getApp().getTxnDB ().read ("tx_history"));
+        auto db = reader.getDB ();
 
         SQL_FOREACH (db, sql)
         {
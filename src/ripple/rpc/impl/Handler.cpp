@@ -20,7 +20,9 @@
 #include <BeastConfig.h>
 #include <ripple/rpc/impl/Handler.h>
 #include <ripple/rpc/handlers/Handlers.h>
+#include <ripple/rpc/handlers/AccountTx.h>
 #include <ripple/rpc/handlers/Ledger.h>
+#include <ripple/rpc/handlers/Tx.h>
 #include <ripple/rpc/handlers/Version.h>
 
 namespace ripple {
@@ -67,7 +69,9 @@ class HandlerTable {
         }
 
         // This is where the new-style handlers are added.
+        addHandler<AccountTxHandler>();
         addHandler<LedgerHandler>();
+        addHandler<TxHandler>();
         addHandler<VersionHandler>();
     }
 
@@ -101,7 +105,6 @@ HandlerTable HANDLERS({
     {   "account_currencies",   byRef (&doAccountCurrencies),   Role::USER,  NEEDS_CURRENT_LEDGER  },
     {   "account_lines",        byRef (&doAccountLines),        Role::USER,  NEEDS_CURRENT_LEDGER  },
     {   "account_offers",       byRef (&doAccountOffers),       Role::USER,  NEEDS_CURRENT_LEDGER  },
-    {   "account_tx",           byRef (&doAccountTxSwitch),     Role::USER,  NEEDS_NETWORK_CONNECTION  },
     {   "blacklist",            byRef (&doBlackList),           Role::ADMIN,   NO_CONDITION     },
     {   "book_offers",          byRef (&doBookOffers),          Role::USER,  NEEDS_CURRENT_LEDGER  },
     {   "can_delete",           byRef (&doCanDelete),           Role::ADMIN,   NO_CONDITION     },
@@ -136,7 +139,6 @@ HandlerTable HANDLERS({
     {   "sms",                  byRef (&doSMS),                 Role::ADMIN,   NO_CONDITION     },
     {   "stop",                 byRef (&doStop),                Role::ADMIN,   NO_CONDITION     },
     {   "transaction_entry",    byRef (&doTransactionEntry),    Role::USER,  NEEDS_CURRENT_LEDGER  },
-    {   "tx",                   byRef (&doTx),                  Role::USER,  NEEDS_NETWORK_CONNECTION  },
     {   "tx_history",           byRef (&doTxHistory),           Role::USER,  NO_CONDITION     },
     {   "unl_add",              byRef (&doUnlAdd),              Role::ADMIN,   NO_CONDITION     },
     {   "unl_delete",           byRef (&doUnlDelete),           Role::ADMIN,   NO_CONDITION     },
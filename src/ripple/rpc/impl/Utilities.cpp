@@ -23,9 +23,8 @@
 namespace ripple {
 namespace RPC {
 
-void
-addPaymentDeliveredAmount (
-    Json::Value& meta,
+Json::Value
+getDeliveredAmount (
     RPC::Context& context,
     Transaction::pointer transaction,
     TransactionMetaSet::pointer transactionMeta)
@@ -42,11 +41,7 @@ addPaymentDeliveredAmount (
         // If the transaction explicitly specifies a DeliveredAmount in the
         // metadata then we use it.
         if (transactionMeta && transactionMeta->hasDeliveredAmount ())
-        {
-            meta[jss::delivered_amount] =
-                transactionMeta->getDeliveredAmount ().getJson (1);
-            return;
-        }
+            return transactionMeta->getDeliveredAmount ().getJson (1);
 
         if (auto ledger = context.netOps.getLedgerBySeq (transaction->getLedger ()))
         {
@@ -60,17 +55,15 @@ addPaymentDeliveredAmount (
                 boost::posix_time::time_from_string ("2014-01-24 04:50:10"));
 
             if (ledger->getCloseTime () >= cutoff)
-            {
-                meta[jss::delivered_amount] =
-                    serializedTx->getFieldAmount (sfAmount).getJson (1);
-                return;
-            }
+                return serializedTx->getFieldAmount (sfAmount).getJson (1);
         }
 
         // Otherwise we report "unavailable" which cannot be parsed into a
         // sensible amount.
-        meta[jss::delivered_amount] = Json::Value ("unavailable");
+        return Json::Value ("unavailable");
     }
+
+    return Json::Value ();
 }
 
 }
@@ -19,7 +19,7 @@
 
 #include <BeastConfig.h>
 #include <ripple/app/main/Application.h>
-#include <ripple/json/json_reader.h>
+#include <ripple/json/FastReader.h>
 #include <ripple/server/JsonWriter.h>
 #include <ripple/server/make_ServerHandler.h>
 #include <ripple/server/impl/JSONRPCUtil.h>
@@ -261,7 +261,7 @@ ServerHandlerImp::processRequest (
 {
     Json::Value jsonRPC;
     {
-        Json::Reader reader;
+        Json::FastReader reader;
         if ((request.size () > 1000000) ||
             ! reader.parse (request, jsonRPC) ||
             jsonRPC.isNull () ||
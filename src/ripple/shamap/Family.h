@@ -23,7 +23,9 @@
 #include <ripple/shamap/FullBelowCache.h>
 #include <ripple/shamap/TreeNodeCache.h>
 #include <ripple/nodestore/Database.h>
+#include <chrono>
 #include <cstdint>
+#include <functional>
 
 namespace ripple {
 namespace shamap {
@@ -60,6 +62,22 @@ public:
     virtual
     void
     missing_node (std::uint32_t refNum) = 0;
+
+    /** Called after a map writes its modified nodes to the database.
+        @param nodes The number of nodes flushed.
+        @param elapsed The time taken to flush and store them.
+    */
+    virtual
+    void
+    on_flush (int nodes, std::chrono::milliseconds elapsed) = 0;
+
+    /** Runs a task on one of the application's worker threads.
+        The task may run on the calling thread, or not until long after
+        the caller has moved on, so it must not rely on either.
+    */
+    virtual
+    void
+    schedule_task (std::function <void()> task) = 0;
 };
 
 } // shamap
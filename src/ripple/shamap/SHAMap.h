@@ -36,7 +36,9 @@
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/shared_lock_guard.hpp>
 #include <boost/thread/shared_mutex.hpp>
+#include <iterator>
 #include <stack>
+#include <vector>
 
 namespace ripple {
 
@@ -88,11 +90,20 @@ private:
     SHAMapType                      type_;
     bool                            backed_ = true; // Map is backed by the database
 
+    // flushDirty shares the subtrees out to worker threads when at least
+    // this many branches of the root are modified inner nodes
+    static int const                flushParallelBranches = 4;
+
+    // The most worker threads one flush asks for
+    static int const                flushHelpers = 3;
+
 public:
     using DeltaItem = std::pair<std::shared_ptr<SHAMapItem>,
                                 std::shared_ptr<SHAMapItem>>;
     using Delta     = std::map<uint256, DeltaItem>;
 
+    class const_iterator;
+
     ~SHAMap ();
     SHAMap(SHAMap const&) = delete;
     SHAMap& operator=(SHAMap const&) = delete;
@@ -143,6 +154,12 @@ public:
     void visitNodes (std::function<bool (SHAMapTreeNode&)> const&) const;
     void visitLeaves(std::function<void (std::shared_ptr<SHAMapItem> const&)> const&) const;
 
+    // iteration over the leaves in key order
+    const_iterator begin () const;
+    const_iterator end () const;
+    /** Returns an iterator to the first item whose key is greater than id */
+    const_iterator upper_bound (uint256 const& id) const;
+
     // comparison/sync functions
     void getMissingNodes (std::vector<SHAMapNodeID>& nodeIDs, std::vector<uint256>& hashes, int max,
                           SHAMapSyncFilter * filter);
@@ -177,8 +194,19 @@ public:
 
     void visitDifferences (SHAMap * have, std::function<bool (SHAMapTreeNode&)>) const;
 
+    /** Starts a task on another thread, or possibly never. */
+    using TaskScheduler = std::function <void (std::function <void ()>)>;
+
+    /** Pass up to max nodes that are in this map but not in have to func.
+        The subtrees below the root are walked by the caller and by up to
+        `helpers` tasks given to `schedule`, and each node's children are
+        read from the node store in one batch. func is never called
+        concurrently.
+    */
     void getFetchPack (SHAMap * have, bool includeLeaves, int max,
-        std::function<void (uint256 const&, const Blob&)>) const;
+        std::function<void (uint256 const&, const Blob&)>,
+        TaskScheduler const& schedule = TaskScheduler (),
+        int helpers = 0) const;
 
     void setUnbacked ();
 
@@ -189,6 +217,8 @@ private:
         std::stack<std::pair<std::shared_ptr<SHAMapTreeNode>, SHAMapNodeID>>;
     using DeltaRef = std::pair<std::shared_ptr<SHAMapItem> const&,
                                std::shared_ptr<SHAMapItem> const&> ;
+    using NodeStack =
+        std::vector<std::pair<SHAMapTreeNode*, SHAMapNodeID>>;
 
     int unshare ();
 
@@ -224,9 +254,9 @@ private:
     /** prepare a node to be modified before flushing */
     void preFlushNode (std::shared_ptr<SHAMapTreeNode>& node) const;
 
-    /** write and canonicalize modified node */
+    /** canonicalize modified node and add it to the batch to write */
     void writeNode (NodeObjectType t, std::uint32_t seq,
-        std::shared_ptr<SHAMapTreeNode>& node) const;
+        std::shared_ptr<SHAMapTreeNode>& node, NodeStore::Batch& batch) const;
 
     SHAMapTreeNode* firstBelow (SHAMapTreeNode*) const;
     SHAMapTreeNode* lastBelow (SHAMapTreeNode*) const;
@@ -250,6 +280,18 @@ private:
     // Does not hook the returned node to its parent
     std::shared_ptr<SHAMapTreeNode> descendNoStore (std::shared_ptr<SHAMapTreeNode> const&, int branch) const;
 
+    /** Hook up the children of an inner node, reading the ones that are
+        not cached from the node store in one batch */
+    void fetchChildren (SHAMapTreeNode*) const;
+
+    /** Visit the children of node that are not in have. Differing leaves
+        are passed to func and differing inner nodes are pushed on stack.
+        Returns false if func asked to stop.
+    */
+    bool visitChildren (SHAMapTreeNode* node, SHAMapNodeID const& nodeID,
+        SHAMap* have, std::function<bool (SHAMapTreeNode&)> const& func,
+        NodeStack& stack) const;
+
     /** If there is only one leaf below this node, get its contents */
     std::shared_ptr<SHAMapItem> onlyBelow (SHAMapTreeNode*) const;
 
@@ -260,6 +302,89 @@ private:
                      std::shared_ptr<SHAMapItem> const& otherMapItem, bool isFirstMap,
                      Delta & differences, int & maxCount) const;
     int walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq);
+    int flushSubTree (std::shared_ptr<SHAMapTreeNode>& node, bool doWrite,
+        NodeObjectType t, std::uint32_t seq, NodeStore::Batch& batch) const;
+    int flushSubTrees (std::shared_ptr<SHAMapTreeNode>* children,
+        NodeStore::Batch* batches, NodeObjectType t, std::uint32_t seq) const;
+};
+
+//------------------------------------------------------------------------------
+
+/** Forward iterator over the items of a SHAMap, in key order.
+
+    The iterator holds the path from the root down to the current leaf, so
+    advancing only climbs as far as the nearest unvisited branch instead of
+    descending from the root again. Nodes fetched along the way are not
+    hooked into the tree, so a full walk of a backed map does not pin it
+    in memory.
+
+    The map must not be modified while it is being iterated.
+    Throws SHAMapMissingNode if a node on the path cannot be fetched.
+*/
+class SHAMap::const_iterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = std::shared_ptr<SHAMapItem>;
+    using difference_type   = std::ptrdiff_t;
+    using reference         = value_type const&;
+    using pointer           = value_type const*;
+
+    const_iterator () = default;
+
+    reference operator* () const
+    {
+        return item_;
+    }
+
+    pointer operator-> () const
+    {
+        return &item_;
+    }
+
+    const_iterator& operator++ ()
+    {
+        increment ();
+        return *this;
+    }
+
+    const_iterator operator++ (int)
+    {
+        const_iterator tmp (*this);
+        increment ();
+        return tmp;
+    }
+
+    friend bool operator== (const_iterator const& lhs, const_iterator const& rhs)
+    {
+        return lhs.item_ == rhs.item_;
+    }
+
+    friend bool operator!= (const_iterator const& lhs, const_iterator const& rhs)
+    {
+        return lhs.item_ != rhs.item_;
+    }
+
+private:
+    friend class SHAMap;
+
+    // An inner node on the path and the branch taken below it
+    using StackEntry = std::pair<std::shared_ptr<SHAMapTreeNode>, int>;
+
+    explicit const_iterator (SHAMap const& map)
+        : map_ (&map)
+    {
+    }
+
+    std::shared_ptr<SHAMapTreeNode> descend (
+        std::shared_ptr<SHAMapTreeNode> const& node, int branch) const;
+    void firstBelow (std::shared_ptr<SHAMapTreeNode> node);
+    void seek (uint256 const& id);
+    void increment ();
+
+    SHAMap const* map_ = nullptr;
+    std::vector<StackEntry> stack_;
+    std::shared_ptr<SHAMapItem> item_;
 };
 
 inline
@@ -27,7 +27,6 @@
 
 #include <cstdint>
 #include <memory>
-#include <mutex>
 #include <string>
 
 namespace ripple {
@@ -54,6 +53,8 @@ public:
 private:
     uint256                         mHash;
     uint256                         mHashes[16];
+    // Child pointers are published and read with the std::atomic_*
+    // shared_ptr functions so traversals never contend on a shared lock.
     std::shared_ptr<SHAMapTreeNode> mChildren[16];
     std::shared_ptr<SHAMapItem>     mItem;
     std::uint32_t                   mSeq;
@@ -61,8 +62,6 @@ private:
     int                             mIsBranch;
     std::uint32_t                   mFullBelowGen;
 
-    static std::mutex               childLock;
-
 public:
     SHAMapTreeNode (const SHAMapTreeNode&) = delete;
     SHAMapTreeNode& operator= (const SHAMapTreeNode&) = delete;
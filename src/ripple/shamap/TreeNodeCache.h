@@ -20,13 +20,13 @@
 #ifndef RIPPLE_SHAMAP_TREENODECACHE_H_INCLUDED
 #define RIPPLE_SHAMAP_TREENODECACHE_H_INCLUDED
 
-#include <ripple/basics/TaggedCache.h>
+#include <ripple/basics/ShardedTaggedCache.h>
 
 namespace ripple {
 
 class SHAMapTreeNode;
 
-using TreeNodeCache = TaggedCache <uint256, SHAMapTreeNode>;
+using TreeNodeCache = ShardedTaggedCache <uint256, SHAMapTreeNode>;
 
 } // ripple
 
@@ -19,8 +19,11 @@
 
 #include <BeastConfig.h>
 #include <ripple/shamap/SHAMap.h>
+#include <ripple/basics/parallel_for.h>
 #include <beast/unit_test/suite.h>
 #include <beast/chrono/manual_clock.h>
+#include <atomic>
+#include <chrono>
 
 namespace ripple {
 
@@ -629,6 +632,118 @@ std::shared_ptr<SHAMapItem> SHAMap::peekPrevItem (uint256 const& id) const
     return no_item;
 }
 
+SHAMap::const_iterator SHAMap::begin () const
+{
+    const_iterator it (*this);
+    it.firstBelow (root_);
+    return it;
+}
+
+SHAMap::const_iterator SHAMap::end () const
+{
+    return const_iterator (*this);
+}
+
+SHAMap::const_iterator SHAMap::upper_bound (uint256 const& id) const
+{
+    const_iterator it (*this);
+    it.seek (id);
+    return it;
+}
+
+// Get the child on this branch without hooking it up, throwing if the
+// map can't supply it
+std::shared_ptr<SHAMapTreeNode>
+SHAMap::const_iterator::descend (
+    std::shared_ptr<SHAMapTreeNode> const& node, int branch) const
+{
+    std::shared_ptr<SHAMapTreeNode> child = map_->descendNoStore (node, branch);
+    if (!child)
+        throw SHAMapMissingNode (map_->type_, node->getChildHash (branch));
+    return child;
+}
+
+// Descend along the lowest branches to the first leaf below node
+void SHAMap::const_iterator::firstBelow (std::shared_ptr<SHAMapTreeNode> node)
+{
+    while (node->isInner ())
+    {
+        int branch = 0;
+        while ((branch < 16) && node->isEmptyBranch (branch))
+            ++branch;
+
+        if (branch == 16)
+        {
+            // Only an empty root has no children
+            if (!stack_.empty ())
+                throw SHAMapMissingNode (map_->type_, node->getNodeHash ());
+            item_.reset ();
+            return;
+        }
+
+        std::shared_ptr<SHAMapTreeNode> child = descend (node, branch);
+        stack_.emplace_back (std::move (node), branch);
+        node = std::move (child);
+    }
+
+    item_ = node->peekItem ();
+}
+
+// Position on the first item after id, which need not be in the map
+void SHAMap::const_iterator::seek (uint256 const& id)
+{
+    stack_.clear ();
+    item_.reset ();
+
+    std::shared_ptr<SHAMapTreeNode> node = map_->root_;
+    SHAMapNodeID nodeID;
+
+    while (node->isInner ())
+    {
+        int const branch = nodeID.selectBranch (id);
+        stack_.emplace_back (node, branch);
+
+        if (node->isEmptyBranch (branch))
+        {
+            // Nothing at or below id here, continue with the next branch
+            increment ();
+            return;
+        }
+
+        node = descend (node, branch);
+        nodeID = nodeID.getChildNodeID (branch);
+    }
+
+    if (node->peekItem ()->getTag () > id)
+        item_ = node->peekItem ();
+    else
+        increment ();
+}
+
+void SHAMap::const_iterator::increment ()
+{
+    while (!stack_.empty ())
+    {
+        StackEntry& top = stack_.back ();
+
+        int branch = top.second + 1;
+        while ((branch < 16) && top.first->isEmptyBranch (branch))
+            ++branch;
+
+        if (branch < 16)
+        {
+            top.second = branch;
+            firstBelow (descend (top.first, branch));
+            return;
+        }
+
+        stack_.pop_back ();
+    }
+
+    // past the last item
+    item_.reset ();
+}
+
 std::shared_ptr<SHAMapItem> SHAMap::peekItem (uint256 const& id) const
 {
     SHAMapTreeNode* leaf = walkToPointer (id);
@@ -924,8 +1039,8 @@ bool SHAMap::fetchRoot (uint256 const& hash, SHAMapSyncFilter* filter)
 //
 // 2) An unshareable node is shared. This happens when you make
 // a mutable snapshot of a mutable SHAMap.
-void SHAMap::writeNode (
-    NodeObjectType t, std::uint32_t seq, std::shared_ptr<SHAMapTreeNode>& node) const
+void SHAMap::writeNode (NodeObjectType t, std::uint32_t seq,
+    std::shared_ptr<SHAMapTreeNode>& node, NodeStore::Batch& batch) const
 {
     // Node is ours, so we can just make it shareable
     assert (node->getSeq() == seq_);
@@ -936,8 +1051,8 @@ void SHAMap::writeNode (
 
     Serializer s;
     node->addRaw (s, snfPREFIX);
-    f_.db().store (t,
-        std::move (s.modData ()), node->getNodeHash ());
+    batch.push_back (NodeObject::createObject (t,
+        std::move (s.modData ()), node->getNodeHash ()));
 }
 
 // We can't modify an inner node someone else might have a
@@ -966,33 +1081,175 @@ int SHAMap::unshare ()
 // If requested, write them to the node store
 int SHAMap::flushDirty (NodeObjectType t, std::uint32_t seq)
 {
-    return walkSubTree (true, t, seq);
+    auto const start = std::chrono::steady_clock::now ();
+
+    int const flushed = walkSubTree (true, t, seq);
+
+    if (backed_ && (flushed != 0))
+    {
+        f_.on_flush (flushed, std::chrono::duration_cast <
+            std::chrono::milliseconds> (
+                std::chrono::steady_clock::now () - start));
+    }
+
+    return flushed;
 }
 
 int
 SHAMap::walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq)
 {
-    int flushed = 0;
-    Serializer s;
-
     if (!root_ || (root_->getSeq() == 0) || root_->isEmpty ())
-        return flushed;
+        return 0;
+
+    doWrite = doWrite && backed_;
 
     if (root_->isLeaf())
     { // special case -- root_ is leaf
         preFlushNode (root_);
-        if (doWrite && backed_)
-            writeNode (t, seq, root_);
+        if (doWrite)
+        {
+            NodeStore::Batch batch;
+            writeNode (t, seq, root_, batch);
+            f_.db().storeBatch (batch);
+        }
         return 1;
     }
 
+    std::shared_ptr<SHAMapTreeNode> node = root_;
+    preFlushNode (node);
+
+    // The children of the root that must be flushed. Inner children
+    // are the roots of independent subtrees.
+    std::shared_ptr<SHAMapTreeNode> children[16];
+    int innerCount = 0;
+
+    for (int branch = 0; branch < 16; ++branch)
+    {
+        if (node->isEmptyBranch (branch))
+            continue;
+
+        // No need to do I/O. If the node isn't linked,
+        // it can't need to be flushed
+        std::shared_ptr<SHAMapTreeNode> child = node->getChild (branch);
+
+        if (child && (child->getSeq() != 0))
+        {
+            preFlushNode (child);
+            if (child->isInner ())
+                ++innerCount;
+            children[branch] = std::move (child);
+        }
+    }
+
+    int flushed = 0;
+    NodeStore::Batch batches[16];
+
+    if (doWrite && (innerCount >= flushParallelBranches))
+    {
+        flushed += flushSubTrees (children, batches, t, seq);
+    }
+    else
+    {
+        for (auto& child : children)
+        {
+            if (child && child->isInner ())
+                flushed += flushSubTree (child, doWrite, t, seq, batches[0]);
+        }
+    }
+
+    NodeStore::Batch& batch = batches[0];
+
+    for (int branch = 0; branch < 16; ++branch)
+    {
+        auto& child = children[branch];
+
+        if (!child)
+            continue;
+
+        if (!child->isInner ())
+        {
+            // flush this leaf
+            ++flushed;
+
+            assert (node->getSeq() == seq_);
+
+            if (doWrite)
+                writeNode (t, seq, child, batch);
+        }
+
+        node->shareChild (branch, child);
+    }
+
+    // The root can now be shared
+    if (doWrite)
+        writeNode (t, seq, node, batch);
+
+    ++flushed;
+
+    if (doWrite)
+    {
+        for (int branch = 1; branch < 16; ++branch)
+        {
+            batch.insert (batch.end (),
+                std::make_move_iterator (batches[branch].begin ()),
+                std::make_move_iterator (batches[branch].end ()));
+        }
+
+        f_.db().storeBatch (batch);
+    }
+
+    root_ = std::move (node);
+
+    return flushed;
+}
+
+// Flushes the modified inner children of the root, each into its own
+// batch. Subtrees share no modified nodes, so the only shared state is
+// the caches. The subtrees are claimed by this thread and by up to
+// flushHelpers tasks given to the Family.
+int
+SHAMap::flushSubTrees (std::shared_ptr<SHAMapTreeNode>* children,
+    NodeStore::Batch* batches, NodeObjectType t, std::uint32_t seq) const
+{
+    std::vector <int> branches;
+    for (int branch = 0; branch < 16; ++branch)
+    {
+        if (children[branch] && children[branch]->isInner ())
+            branches.push_back (branch);
+    }
+
+    std::atomic <int> flushed (0);
+    parallel_for (branches.size (), flushHelpers,
+        [this] (std::function <void ()> task)
+        {
+            f_.schedule_task (std::move (task));
+        },
+        [&] (std::size_t i)
+        {
+            int const branch = branches[i];
+            flushed += flushSubTree (children[branch], true,
+                t, seq, batches[branch]);
+            return true;
+        });
+
+    return flushed;
+}
+
+// Flushes the subtree below an inner node that has already been prepared
+// with preFlushNode. On return the node refers to the shareable version.
+int
+SHAMap::flushSubTree (std::shared_ptr<SHAMapTreeNode>& top, bool doWrite,
+    NodeObjectType t, std::uint32_t seq, NodeStore::Batch& batch) const
+{
+    int flushed = 0;
+
     // Stack of {parent,index,child} pointers representing
     // inner nodes we are in the process of flushing
     using StackEntry = std::pair <std::shared_ptr<SHAMapTreeNode>, int>;
     std::stack <StackEntry, std::vector<StackEntry>> stack;
 
-    std::shared_ptr<SHAMapTreeNode> node = root_;
-    preFlushNode (node);
+    std::shared_ptr<SHAMapTreeNode> node = std::move (top);
+    assert (node->isInner () && (node->getSeq() == seq_));
 
     int pos = 0;
 
@@ -1035,8 +1292,8 @@ SHAMap::walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq)
 
                         assert (node->getSeq() == seq_);
 
-                        if (doWrite && backed_)
-                            writeNode (t, seq, child);
+                        if (doWrite)
+                            writeNode (t, seq, child, batch);
 
                         node->shareChild (branch, child);
                     }
@@ -1045,8 +1302,8 @@ SHAMap::walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq)
         }
 
         // This inner node can now be shared
-        if (doWrite && backed_)
-            writeNode (t, seq, node);
+        if (doWrite)
+            writeNode (t, seq, node, batch);
 
         ++flushed;
 
@@ -1066,8 +1323,7 @@ SHAMap::walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq)
         ++pos;
     }
 
-    // Last inner node is the new root_
-    root_ = std::move (node);
+    top = std::move (node);
 
     return flushed;
 }
@@ -20,7 +20,11 @@
 #include <BeastConfig.h>
 #include <ripple/shamap/SHAMap.h>
 #include <ripple/nodestore/Database.h>
+#include <ripple/basics/parallel_for.h>
 #include <beast/unit_test/suite.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
 
 namespace ripple {
 
@@ -28,21 +32,12 @@ namespace ripple {
 
 static const uint256 uZero;
 
-static bool visitLeavesHelper (
-    std::function <void (std::shared_ptr<SHAMapItem> const&)> const& function,
-    SHAMapTreeNode& node)
-{
-    // Adapt visitNodes to visitLeaves
-    if (!node.isInner ())
-        function (node.peekItem ());
-
-    return false;
-}
-
 void SHAMap::visitLeaves (std::function<void (std::shared_ptr<SHAMapItem> const& item)> const& leafFunction) const
 {
-    visitNodes (std::bind (visitLeavesHelper,
-            std::cref (leafFunction), std::placeholders::_1));
+    assert (root_->isValid ());
+
+    for (auto const& item : *this)
+        leafFunction (item);
 }
 
 void SHAMap::visitNodes(std::function<bool (SHAMapTreeNode&)> const& function) const
@@ -668,29 +663,176 @@ SHAMap::hasLeafNode (uint256 const& tag, uint256 const& targetNodeHash) const
 @param includeLeaves True if leaf nodes should be included.
 @param max The maximum number of nodes to return.
 @param func The functor to call for each node added to the FetchPack.
+@param schedule Starts a helper task; may be empty if helpers is zero.
+@param helpers The most subtrees to walk on helper tasks at once.
 
 Note: a caller should set includeLeaves to false for transaction trees.
 There's no point in including the leaves of transaction trees.
 */
 void SHAMap::getFetchPack (SHAMap* have, bool includeLeaves, int max,
-                           std::function<void (uint256 const&, const Blob&)> func) const
+    std::function<void (uint256 const&, const Blob&)> func,
+    TaskScheduler const& schedule, int helpers) const
 {
-    visitDifferences (have,
-        [includeLeaves, &max, &func] (SHAMapTreeNode& smn) -> bool
+    if (root_->getNodeHash ().isZero ())
+        return;
+
+    if (have && (root_->getNodeHash () == have->root_->getNodeHash ()))
+        return;
+
+    std::mutex mutex;
+    std::atomic<bool> stop (max <= 0);
+
+    // Serialize outside the lock, then pass the node on.
+    // Returns false once max nodes have been passed on.
+    std::function<bool (SHAMapTreeNode&)> const add =
+        [includeLeaves, &max, &func, &mutex, &stop] (SHAMapTreeNode& smn) -> bool
         {
-            if (includeLeaves || smn.isInner ())
+            if (!includeLeaves && !smn.isInner ())
+                return true;
+
+            if (stop)
+                return false;
+
+            Serializer s;
+            smn.addRaw (s, snfPREFIX);
+
+            std::lock_guard<std::mutex> lock (mutex);
+
+            if (max <= 0)
+                return false;
+
+            func (smn.getNodeHash (), s.peekData ());
+
+            if (--max <= 0)
             {
-                Serializer s;
-                smn.addRaw (s, snfPREFIX);
-                func (smn.getNodeHash(), s.peekData());
+                stop = true;
+                return false;
+            }
+            return true;
+        };
 
-                if (--max <= 0)
+    if (root_->isLeaf ())
+    {
+        if (! have || ! have->hasLeafNode (root_->peekItem()->getTag (), root_->getNodeHash ()))
+            add (*root_);
+
+        return;
+    }
+
+    // Each differing inner node below the root is the top of a subtree
+    // that is walked on its own, by this job or by a helper
+    NodeStack subtrees;
+
+    if (!add (*root_) ||
+        !visitChildren (root_.get (), SHAMapNodeID (), have, add, subtrees))
+        return;
+
+    parallel_for (subtrees.size (),
+        schedule ? std::max (helpers, 0) : 0,
+        [&schedule] (std::function <void ()> task)
+        {
+            schedule (std::move (task));
+        },
+        [this, have, &add, &subtrees] (std::size_t i)
+        {
+            NodeStack stack;
+            stack.push_back (subtrees[i]);
+
+            while (!stack.empty ())
+            {
+                auto const entry = stack.back ();
+                stack.pop_back ();
+
+                if (!add (*entry.first) ||
+                    !visitChildren (entry.first, entry.second, have, add, stack))
                     return false;
             }
             return true;
         });
 }
 
+void SHAMap::fetchChildren (SHAMapTreeNode* node) const
+{
+    if (!backed_)
+        return;
+
+    std::vector<int> branches;
+    std::vector<uint256> hashes;
+
+    for (int i = 0; i < 16; ++i)
+    {
+        if (node->isEmptyBranch (i) || node->getChildPointer (i))
+            continue;
+
+        uint256 const& hash = node->getChildHash (i);
+        std::shared_ptr<SHAMapTreeNode> child = getCache (hash);
+
+        if (child)
+        {
+            node->canonicalizeChild (i, child);
+            continue;
+        }
+
+        branches.push_back (i);
+        hashes.push_back (hash);
+    }
+
+    if (hashes.size () < 2)
+        return;
+
+    // Missing or invalid nodes are left for descendThrow to report
+    auto const objects = f_.db ().fetchBatch (hashes);
+
+    for (std::size_t i = 0; i < objects.size (); ++i)
+    {
+        if (!objects[i])
+            continue;
+
+        try
+        {
+            auto child = std::make_shared <SHAMapTreeNode> (
+                objects[i]->getData (), 0, snfPREFIX, hashes[i], true);
+            canonicalize (hashes[i], child);
+            node->canonicalizeChild (branches[i], child);
+        }
+        catch (...)
+        {
+            if (journal_.warning) journal_.warning <<
+                "Invalid DB node " << hashes[i];
+        }
+    }
+}
+
+bool SHAMap::visitChildren (SHAMapTreeNode* node, SHAMapNodeID const& nodeID,
+    SHAMap* have, std::function<bool (SHAMapTreeNode&)> const& func,
+    NodeStack& stack) const
+{
+    fetchChildren (node);
+
+    for (int i = 0; i < 16; ++i)
+    {
+        if (!node->isEmptyBranch (i))
+        {
+            uint256 const& childHash = node->getChildHash (i);
+            SHAMapNodeID childID = nodeID.getChildNodeID (i);
+            SHAMapTreeNode* next = descendThrow (node, i);
+
+            if (next->isInner ())
+            {
+                if (! have || ! have->hasInnerNode (childID, childHash))
+                    stack.push_back ({next, childID});
+            }
+            else if (! have || ! have->hasLeafNode (next->peekItem()->getTag(), childHash))
+            {
+                if (! func (*next))
+                    return false;
+            }
+        }
+    }
+
+    return true;
+}
+
 void SHAMap::visitDifferences (SHAMap* have, std::function <bool (SHAMapTreeNode&)> func) const
 {
     // Visit every node in this SHAMap that is not present
@@ -710,43 +852,22 @@ void SHAMap::visitDifferences (SHAMap* have, std::function <bool (SHAMapTreeNode
         return;
     }
     // contains unexplored non-matching inner node entries
-    using StackEntry = std::pair <SHAMapTreeNode*, SHAMapNodeID>;
-    std::stack <StackEntry, std::vector<StackEntry>> stack;
+    NodeStack stack;
 
-    stack.push ({root_.get(), SHAMapNodeID{}});
+    stack.push_back ({root_.get(), SHAMapNodeID{}});
 
     while (!stack.empty())
     {
-        SHAMapTreeNode* node;
-        SHAMapNodeID nodeID;
-        std::tie (node, nodeID) = stack.top ();
-        stack.pop ();
+        auto const entry = stack.back ();
+        stack.pop_back ();
 
         // 1) Add this node to the pack
-        if (!func (*node))
+        if (!func (*entry.first))
             return;
 
         // 2) push non-matching child inner nodes
-        for (int i = 0; i < 16; ++i)
-        {
-            if (!node->isEmptyBranch (i))
-            {
-                uint256 const& childHash = node->getChildHash (i);
-                SHAMapNodeID childID = nodeID.getChildNodeID (i);
-                SHAMapTreeNode* next = descendThrow (node, i);
-
-                if (next->isInner ())
-                {
-                    if (! have || ! have->hasInnerNode (childID, childHash))
-                        stack.push ({next, childID});
-                }
-                else if (! have || ! have->hasLeafNode (next->peekItem()->getTag(), childHash))
-                {
-                    if (! func (*next))
-                        return;
-                }
-            }
-        }
+        if (!visitChildren (entry.first, entry.second, have, func, stack))
+            return;
     }
 }
 
@@ -23,12 +23,10 @@
 #include <ripple/basics/StringUtilities.h>
 #include <ripple/protocol/HashPrefix.h>
 #include <beast/module/core/text/LexicalCast.h>
-#include <mutex>
+#include <atomic>
 
 namespace ripple {
 
-std::mutex SHAMapTreeNode::childLock;
-
 SHAMapTreeNode::SHAMapTreeNode (std::uint32_t seq)
     : mSeq (seq)
     , mType (tnERROR)
@@ -50,10 +48,8 @@ SHAMapTreeNode::SHAMapTreeNode (const SHAMapTreeNode& node, std::uint32_t seq)
     {
         memcpy (mHashes, node.mHashes, sizeof (mHashes));
 
-        std::unique_lock <std::mutex> lock (childLock);
-
         for (int i = 0; i < 16; ++i)
-            mChildren[i] = node.mChildren[i];
+            mChildren[i] = std::atomic_load (&node.mChildren[i]);
     }
 }
 
@@ -513,7 +509,7 @@ bool SHAMapTreeNode::setChild (int m, uint256 const& hash, std::shared_ptr<SHAMa
         mIsBranch &= ~ (1 << m);
     }
 
-    mChildren[m] = child;
+    std::atomic_store (&mChildren[m], child);
 
     return updateHash ();
 }
@@ -528,7 +524,7 @@ void SHAMapTreeNode::shareChild (int m, std::shared_ptr<SHAMapTreeNode> const& c
     assert (child.get() != this);
     assert (child->getNodeHash() == mHashes[m]);
 
-    mChildren[m] = child;
+    std::atomic_store (&mChildren[m], child);
 }
 
 SHAMapTreeNode* SHAMapTreeNode::getChildPointer (int branch)
@@ -536,8 +532,7 @@ SHAMapTreeNode* SHAMapTreeNode::getChildPointer (int branch)
     assert (branch >= 0 && branch < 16);
     assert (isInnerNode ());
 
-    std::unique_lock <std::mutex> lock (childLock);
-    return mChildren[branch].get ();
+    return std::atomic_load (&mChildren[branch]).get ();
 }
 
 std::shared_ptr<SHAMapTreeNode> SHAMapTreeNode::getChild (int branch)
@@ -545,9 +540,9 @@ std::shared_ptr<SHAMapTreeNode> SHAMapTreeNode::getChild (int branch)
     assert (branch >= 0 && branch < 16);
     assert (isInnerNode ());
 
-    std::unique_lock <std::mutex> lock (childLock);
-    assert (!mChildren[branch] || (mHashes[branch] == mChildren[branch]->getNodeHash()));
-    return mChildren[branch];
+    auto child = std::atomic_load (&mChildren[branch]);
+    assert (!child || (mHashes[branch] == child->getNodeHash()));
+    return child;
 }
 
 void SHAMapTreeNode::canonicalizeChild (int branch, std::shared_ptr<SHAMapTreeNode>& node)
@@ -557,17 +552,12 @@ void SHAMapTreeNode::canonicalizeChild (int branch, std::shared_ptr<SHAMapTreeNo
     assert (node);
     assert (node->getNodeHash() == mHashes[branch]);
 
-    std::unique_lock <std::mutex> lock (childLock);
-    if (mChildren[branch])
-    {
-        // There is already a node hooked up, return it
-        node = mChildren[branch];
-    }
-    else
-    {
-        // Hook this node up
-        mChildren[branch] = node;
-    }
+    // Hook this node up unless another thread got there first,
+    // in which case the compare-exchange hands back the winner.
+    std::shared_ptr<SHAMapTreeNode> expected;
+    if (! std::atomic_compare_exchange_strong (
+            &mChildren[branch], &expected, node))
+        node = std::move (expected);
 }
 
 
@@ -25,8 +25,10 @@
 #include <ripple/protocol/UInt160.h>
 #include <beast/module/core/maths/Random.h>
 #include <beast/unit_test/suite.h>
+#include <beast/unit_test/thread.h>
 #include <functional>
 #include <stdexcept>
+#include <vector>
 
 namespace ripple {
 namespace shamap {
@@ -112,6 +114,76 @@ public:
         map.emplace (hash, blob);
     }
 
+    // Returns the fetch pack that turns have into the map stored under
+    // hash, read back from the node store, with up to helpers threads
+    // walking it alongside the caller
+    Map
+    fetch_stored (TestFamily& f, uint256 const& hash, uint256 const& haveHash,
+        int max, int helpers)
+    {
+        std::vector <beast::unit_test::thread> threads;
+        threads.reserve (helpers);
+        auto const schedule = [this, &threads] (std::function <void ()> task)
+        {
+            threads.emplace_back (*this, std::move (task));
+        };
+
+        f.treecache ().clear ();
+        Table want (SHAMapType::FREE, hash, f, beast::Journal());
+        Table have (SHAMapType::FREE, haveHash, f, beast::Journal());
+        expect (want.fetchRoot (hash, nullptr), "missing root");
+        expect (have.fetchRoot (haveHash, nullptr), "missing root");
+
+        Map map;
+        want.getFetchPack (&have, true, max, std::bind (
+            &FetchPack_test::on_fetch, this, std::ref (map),
+                std::placeholders::_1, std::placeholders::_2),
+                    schedule, helpers);
+        for (auto& t : threads)
+            t.join ();
+        return map;
+    }
+
+    void
+    testStored (TestFamily& f)
+    {
+        testcase ("stored");
+
+        beast::Random r;
+        Table t1 (SHAMapType::FREE, f, beast::Journal());
+        add_random_items (2000, t1, r);
+        t1.flushDirty (hotACCOUNT_NODE, 1);
+
+        auto t2 = t1.snapShot (true);
+        add_random_items (200, *t2, r);
+        t2->flushDirty (hotACCOUNT_NODE, 2);
+
+        // The nodes of t2 that t1 does not have
+        std::size_t differences = 0;
+        t2->visitDifferences (&t1,
+            [&differences](SHAMapTreeNode&)
+            {
+                ++differences;
+                return true;
+            });
+        expect (differences > 200, "too few differences");
+
+        auto const serial = fetch_stored (
+            f, t2->getHash (), t1.getHash (), 1000000, 0);
+        auto const parallel = fetch_stored (
+            f, t2->getHash (), t1.getHash (), 1000000, 3);
+        expect (serial.size () == differences, "bad serial pack");
+        expect (parallel.size () == differences, "bad parallel pack");
+
+        bool same = true;
+        for (auto const& node : serial)
+            same = same && (parallel.count (node.first) != 0);
+        expect (same, "packs differ");
+
+        expect (fetch_stored (f, t2->getHash (), t1.getHash (), 50, 3).size ()
+            == 50, "bad limit");
+    }
+
     void run ()
     {
         beast::Journal const j;                            // debug journal
@@ -121,6 +193,8 @@ public:
 
         pass ();
 
+        testStored (f);
+
 //         beast::Random r;
 //         add_random_items (tableItems, *t1, r);
 //         std::shared_ptr <Table> t2 (t1->snapShot (true));
@@ -22,6 +22,8 @@
 #include <ripple/shamap/tests/common.h>
 #include <ripple/basics/Blob.h>
 #include <ripple/basics/StringUtilities.h>
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/protocol/Serializer.h>
 #include <beast/unit_test/suite.h>
 #include <beast/utility/Journal.h>
 
@@ -95,6 +97,184 @@ public:
         unexpected (!sMap.delItem (sMap.peekFirstItem ()->getTag ()), "bad mod");
         unexpected (sMap.getHash () == mapHash, "bad snapshot");
         unexpected (map2->getHash () != mapHash, "bad snapshot");
+
+        testFlush (f);
+        testIterator (f);
+    }
+
+    // Returns the number of leaves in the map stored under hash
+    int countStored (TestFamily& f, uint256 const& hash)
+    {
+        f.treecache ().clear ();
+        SHAMap map (SHAMapType::FREE, hash, f, beast::Journal());
+        if (!map.fetchRoot (hash, nullptr))
+            return -1;
+        int count = 0;
+        map.visitLeaves (
+            [&count](std::shared_ptr<SHAMapItem> const&)
+            {
+                ++count;
+            });
+        return count;
+    }
+
+    // Returns the number of nodes in the map, or -1 if any of them is
+    // missing from the backend
+    int countNodes (TestFamily& f, SHAMap const& map)
+    {
+        hash_set <uint256> nodes;
+        bool missing = false;
+        map.visitNodes (
+            [&](SHAMapTreeNode& node)
+            {
+                nodes.insert (node.getNodeHash ());
+                missing = missing || ! f.db ().fetch (node.getNodeHash ());
+                return false;
+            });
+        return missing ? -1 : static_cast <int> (nodes.size ());
+    }
+
+    // Flushes the map, checking that it was stored once per flushed node
+    int flush (TestFamily& f, SHAMap& map, std::uint32_t seq)
+    {
+        std::uint32_t const stores = f.db ().getStoreCount ();
+        int const flushes = f.flushes ();
+        int const reported = f.flushed ();
+
+        int const flushed = map.flushDirty (hotACCOUNT_NODE, seq);
+        f.join ();
+
+        expect (f.flushes () == flushes + 1, "flush not reported");
+        expect (f.flushed () == reported + flushed, "bad reported count");
+        expect (f.db ().getStoreCount () == stores + flushed,
+            "bad store count");
+        return flushed;
+    }
+
+    void testFlush (TestFamily& f)
+    {
+        testcase ("flush");
+
+        // Enough items that every branch of the root is an inner node,
+        // so the subtrees are flushed in parallel
+        int const items = 1000;
+
+        SHAMap map (SHAMapType::FREE, f, beast::Journal());
+        for (int i = 0; i < items; ++i)
+        {
+            Serializer s;
+            s.add32 (i);
+            map.addItem (SHAMapItem (s.getSHA512Half (), s.peekData ()),
+                false, false);
+        }
+
+        uint256 const hash = map.getHash ();
+        int const flushed = flush (f, map, 1);
+        expect (flushed > items, "bad flush count");
+        expect (f.tasks () > 0, "no flush task ran");
+
+        // Every node was new, so each reached the backend exactly once
+        expect (countNodes (f, map) == flushed, "bad stored nodes");
+        expect (map.getHash () == hash, "flush changed hash");
+        expect (map.flushDirty (hotACCOUNT_NODE, 1) == 0, "nodes still dirty");
+        expect (countStored (f, hash) == items, "bad stored map");
+
+        // Modify some items in a later snapshot and flush again
+        auto next = map.snapShot (true);
+        for (int i = 0; i < items; i += 10)
+        {
+            Serializer s;
+            s.add32 (i);
+            expect (next->delItem (s.getSHA512Half ()), "no delete");
+        }
+
+        uint256 const nextHash = next->getHash ();
+        expect (flush (f, *next, 2) > 0, "bad flush count");
+        expect (next->getHash () == nextHash, "flush changed hash");
+        expect (countStored (f, nextHash) == items - items / 10,
+            "bad stored map");
+        expect (countStored (f, hash) == items, "bad stored map");
+    }
+
+    void testIterator (TestFamily& f)
+    {
+        testcase ("iterator");
+
+        SHAMap map (SHAMapType::FREE, f, beast::Journal());
+        expect (map.begin () == map.end (), "empty map not empty");
+        expect (map.upper_bound (uint256 ()) == map.end (), "bad upper_bound");
+
+        int const items = 2000;
+        for (int i = 0; i < items; ++i)
+        {
+            Serializer s;
+            s.add32 (i);
+            map.addItem (SHAMapItem (s.getSHA512Half (), s.peekData ()),
+                false, false);
+        }
+
+        // Walk the map both ways
+        int count = 0;
+        std::shared_ptr<SHAMapItem> i = map.peekFirstItem ();
+        for (auto const& item : map)
+        {
+            if (! expect (i && (*item == *i), "bad iteration order"))
+                return;
+            i = map.peekNextItem (i->getTag ());
+            ++count;
+        }
+        expect (!i, "iteration ended early");
+        expect (count == items, "bad iteration count");
+
+        // Seek to items in the map and to keys between them
+        for (int n = 0; n < items; n += 7)
+        {
+            Serializer s;
+            s.add32 (n);
+            uint256 key = s.getSHA512Half ();
+
+            for (int j = 0; j < 3; ++j, --key)
+            {
+                auto const next = map.peekNextItem (key);
+                auto const iter = map.upper_bound (key);
+                if (!next)
+                    expect (iter == map.end (), "bad upper_bound");
+                else if (expect (iter != map.end (), "bad upper_bound"))
+                    expect (**iter == *next, "bad upper_bound");
+            }
+        }
+        expect (map.upper_bound (map.peekLastItem ()->getTag ()) == map.end (),
+            "bad upper_bound");
+
+        // An unbacked map holding only the root can't supply the children
+        std::vector<SHAMapNodeID> nodeIDs;
+        std::list<Blob> nodes;
+        expect (map.getNodeFat (SHAMapNodeID (), nodeIDs, nodes, false, false),
+            "no root node");
+
+        SHAMap partial (SHAMapType::FREE, f, beast::Journal());
+        partial.setUnbacked ();
+        partial.setSynching ();
+        expect (partial.addRootNode (nodes.front (), snfWIRE, nullptr).isGood (),
+            "bad root node");
+        try
+        {
+            partial.begin ();
+            fail ("missing node not reported");
+        }
+        catch (SHAMapMissingNode const&)
+        {
+            pass ();
+        }
+        try
+        {
+            partial.upper_bound (uint256 ());
+            fail ("missing node not reported");
+        }
+        catch (SHAMapMissingNode const&)
+        {
+            pass ();
+        }
     }
 };
 
@@ -0,0 +1,198 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/shamap/SHAMap.h>
+#include <ripple/shamap/tests/common.h>
+#include <ripple/basics/tests/benchmark.h>
+#include <ripple/protocol/Serializer.h>
+#include <beast/module/core/maths/Random.h>
+#include <beast/unit_test/suite.h>
+#include <beast/unit_test/thread.h>
+#include <atomic>
+#include <iomanip>
+#include <vector>
+
+namespace ripple {
+namespace shamap {
+namespace tests {
+
+// Measures concurrent read-only traversal of a database-backed SHAMap.
+// Every thread walks the whole map with visitDifferences, which descends
+// through descendThrow, so inner nodes are fetched and hooked up
+// (canonicalizeChild) and read (getChildPointer) under contention.
+class Traverse_test : public beast::unit_test::suite
+{
+public:
+#ifndef NDEBUG
+    static std::size_t const default_items = 20000;
+#else
+    static std::size_t const default_items = 200000; // release
+#endif
+
+    static
+    uint256
+    build (TestFamily& f, std::size_t items)
+    {
+        beast::Random r;
+        SHAMap map (SHAMapType::FREE, f, beast::Journal());
+        for (std::size_t i = 0; i < items; ++i)
+        {
+            Serializer s;
+            for (int d = 0; d < 3; ++d)
+                s.add32 (r.nextInt ());
+            SHAMapItem item (to256 (s.getRIPEMD160 ()), s.peekData ());
+            map.addItem (item, false, false);
+        }
+        map.flushDirty (hotACCOUNT_NODE, 1);
+        return map.getHash ();
+    }
+
+    // Returns leaves visited per second across all threads
+    double
+    do_traverse (TestFamily& f, uint256 const& hash,
+        std::size_t items, std::size_t threads)
+    {
+        f.treecache().clear ();
+
+        SHAMap map (SHAMapType::FREE, hash, f, beast::Journal());
+        expect (map.fetchRoot (hash, nullptr), "missing root");
+        map.setImmutable ();
+
+        std::atomic<std::size_t> visited (0);
+        auto const walk = [&]()
+        {
+            std::size_t n = 0;
+            map.visitDifferences (nullptr,
+                [&n](SHAMapTreeNode& node)
+                {
+                    if (node.isLeaf ())
+                        ++n;
+                    return true;
+                });
+            visited += n;
+        };
+
+        auto const start = ripple::test::benchmark_clock::now();
+        std::vector<beast::unit_test::thread> t;
+        t.reserve (threads);
+        for (std::size_t i = 0; i < threads; ++i)
+            t.emplace_back (*this, walk);
+        for (auto& _ : t)
+            _.join();
+        auto const seconds = ripple::test::seconds_since (start);
+
+        expect (visited == items * threads, "missing leaves");
+        return ripple::test::per_second (visited, seconds);
+    }
+
+    void
+    run () override
+    {
+        std::size_t items = default_items;
+        if (! arg().empty())
+            items = std::stoul (arg());
+
+        beast::Journal const j;
+        TestFamily f (j);
+        auto const hash = build (f, items);
+
+        testcase ("traverse " + std::to_string (items) + " items");
+        for (std::size_t threads : { 1, 2, 4, 8, 16 })
+        {
+            auto const rate = do_traverse (f, hash, items, threads);
+            log << std::setw(3) << threads << " threads: " <<
+                ripple::test::format_rate (rate) << " leaves/s";
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(Traverse,shamap,ripple);
+
+//------------------------------------------------------------------------------
+
+// Measures a single ordered walk of a database-backed SHAMap, comparing
+// repeated peekNextItem calls, which descend from the root for every item,
+// with the stateful iterator. Pass the item count as the argument to
+// measure a multi-million entry map.
+class Iterate_test : public beast::unit_test::suite
+{
+public:
+    template <class Walk>
+    double
+    do_walk (TestFamily& f, uint256 const& hash,
+        std::size_t items, Walk const& walk)
+    {
+        f.treecache().clear ();
+
+        SHAMap map (SHAMapType::FREE, hash, f, beast::Journal());
+        expect (map.fetchRoot (hash, nullptr), "missing root");
+        map.setImmutable ();
+
+        auto const start = ripple::test::benchmark_clock::now();
+        std::size_t const visited = walk (map);
+        auto const seconds = ripple::test::seconds_since (start);
+
+        expect (visited == items, "missing leaves");
+        return ripple::test::per_second (visited, seconds);
+    }
+
+    void
+    run () override
+    {
+        std::size_t items = Traverse_test::default_items;
+        if (! arg().empty())
+            items = std::stoul (arg());
+
+        beast::Journal const j;
+        TestFamily f (j);
+        auto const hash = Traverse_test::build (f, items);
+
+        testcase ("iterate " + std::to_string (items) + " items");
+
+        auto const rateNext = do_walk (f, hash, items,
+            [](SHAMap const& map)
+            {
+                std::size_t n = 0;
+                for (auto item = map.peekFirstItem (); item;
+                        item = map.peekNextItem (item->getTag ()))
+                    ++n;
+                return n;
+            });
+        log << "peekNextItem: " <<
+            ripple::test::format_rate (rateNext) << " items/s";
+
+        auto const rateIter = do_walk (f, hash, items,
+            [](SHAMap const& map)
+            {
+                std::size_t n = 0;
+                for (auto iter = map.begin (); iter != map.end (); ++iter)
+                    ++n;
+                return n;
+            });
+        log << "iterator:     " <<
+            ripple::test::format_rate (rateIter) << " items/s";
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(Iterate,shamap,ripple);
+
+} // tests
+} // shamap
+} // ripple
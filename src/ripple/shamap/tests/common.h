@@ -30,6 +30,10 @@
 #include <ripple/nodestore/Manager.h>
 #include <beast/utility/Journal.h>
 #include <beast/chrono/manual_clock.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace ripple {
 namespace shamap {
@@ -44,6 +48,11 @@ private:
     TreeNodeCache treecache_;
     FullBelowCache fullbelow_;
     std::unique_ptr<NodeStore::Database> db_;
+    std::mutex mutex_;
+    std::vector <std::thread> threads_;
+    std::atomic <int> tasks_;
+    std::atomic <int> flushes_;
+    std::atomic <int> flushed_;
 
 public:
     explicit
@@ -54,9 +63,50 @@ public:
             "test", scheduler_, j, 1,
                 parseDelimitedKeyValueString(
                     "type=memory|Path=SHAMap_test")))
+        , tasks_ (0)
+        , flushes_ (0)
+        , flushed_ (0)
     {
     }
 
+    ~TestFamily ()
+    {
+        join ();
+    }
+
+    /** Wait for every task given to schedule_task to finish. */
+    void
+    join ()
+    {
+        std::vector <std::thread> threads;
+        {
+            std::lock_guard <std::mutex> lock (mutex_);
+            threads.swap (threads_);
+        }
+        for (auto& thread : threads)
+            thread.join ();
+    }
+
+    /** Returns the number of tasks that have run. */
+    int
+    tasks () const
+    {
+        return tasks_;
+    }
+
+    /** Returns the number of flushes reported, and the nodes they wrote. */
+    int
+    flushes () const
+    {
+        return flushes_;
+    }
+
+    int
+    flushed () const
+    {
+        return flushed_;
+    }
+
     beast::manual_clock <std::chrono::steady_clock>
     clock()
     {
@@ -104,6 +154,26 @@ public:
     {
         throw std::runtime_error("missing node");
     }
+
+    void
+    on_flush (int nodes, std::chrono::milliseconds) override
+    {
+        ++flushes_;
+        flushed_ += nodes;
+    }
+
+    // Each task runs on its own thread, so work handed out by the
+    // SHAMap really runs in parallel with the caller
+    void
+    schedule_task (std::function <void()> task) override
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        threads_.emplace_back ([this, task] ()
+        {
+            task ();
+            ++tasks_;
+        });
+    }
 };
 
 } // tests
@@ -28,6 +28,7 @@
 #include <ripple/app/ledger/ConsensusTransSetSF.cpp>
 #include <ripple/app/ledger/LedgerProposal.cpp>
 #include <ripple/app/ledger/OrderBookDB.cpp>
+#include <ripple/app/ledger/OrderBookIndex.cpp>
 #include <ripple/app/ledger/TransactionStateSF.cpp>
 #include <ripple/app/main/LoadManager.cpp>
 #include <ripple/app/misc/CanonicalTXSet.cpp>
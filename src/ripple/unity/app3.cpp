@@ -20,7 +20,15 @@
 #include <BeastConfig.h>
 
 #include <ripple/app/ledger/Ledger.cpp>
+#include <ripple/app/ledger/LedgerSQLWriter.cpp>
 #include <ripple/app/misc/AccountState.cpp>
 
 #include <ripple/app/tests/common_ledger.cpp>
+#include <ripple/app/data/tests/DatabaseCon.test.cpp>
 #include <ripple/app/ledger/tests/Ledger_test.cpp>
+#include <ripple/app/tests/ApplyQueue.test.cpp>
+#include <ripple/app/tests/ApplyTransactions.test.cpp>
+#include <ripple/app/tests/IntakeQueue.test.cpp>
+#include <ripple/app/ledger/tests/LedgerRequestWindow.test.cpp>
+#include <ripple/app/ledger/tests/LedgerSQLWriter.test.cpp>
+#include <ripple/app/ledger/tests/OrderBookIndex.test.cpp>
@@ -23,6 +23,7 @@
 #include <ripple/app/book/tests/Quality.test.cpp>
 #include <ripple/app/book/tests/Taker.test.cpp>
 #include <ripple/app/ledger/InboundLedger.cpp>
+#include <ripple/app/ledger/LedgerRequestWindow.cpp>
 #include <ripple/app/paths/RippleState.cpp>
 #include <ripple/app/peers/UniqueNodeList.cpp>
 #include <ripple/app/transactors/Transactor.h>
@@ -30,4 +30,6 @@
 #include <ripple/app/paths/FindPaths.cpp>
 #include <ripple/app/paths/Pathfinder.cpp>
 #include <ripple/app/misc/AmendmentTableImpl.cpp>
+#include <ripple/app/misc/tests/AccountTxPaging.test.cpp>
 #include <ripple/app/misc/tests/AmendmentTable.test.cpp>
+#include <ripple/app/misc/tests/HashRouter.test.cpp>
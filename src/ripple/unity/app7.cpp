@@ -23,4 +23,5 @@
 #include <ripple/app/ledger/LedgerHistory.cpp>
 #include <ripple/app/tx/TransactionAcquire.cpp>
 #include <ripple/app/tx/LocalTxs.cpp>
+#include <ripple/app/misc/AccountTxPaging.cpp>
 #include <ripple/app/misc/NetworkOPs.cpp>
@@ -37,6 +37,7 @@
 #include <ripple/basics/tests/CheckLibraryVersions.test.cpp>
 #include <ripple/basics/tests/hardened_hash_test.cpp>
 #include <ripple/basics/tests/KeyCache.test.cpp>
+#include <ripple/basics/tests/parallel_for.test.cpp>
 #include <ripple/basics/tests/RangeSet.test.cpp>
 #include <ripple/basics/tests/StringUtilities.test.cpp>
 #include <ripple/basics/tests/TaggedCache.test.cpp>
@@ -28,3 +28,4 @@
 
 #include <ripple/core/tests/LoadFeeTrack.test.cpp>
 #include <ripple/core/tests/Config.test.cpp>
+#include <ripple/core/tests/JobQueue.test.cpp>
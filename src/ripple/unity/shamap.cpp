@@ -28,3 +28,4 @@
 #include <ripple/shamap/tests/FetchPack.test.cpp>
 #include <ripple/shamap/tests/SHAMap.test.cpp>
 #include <ripple/shamap/tests/SHAMapSync.test.cpp>
+#include <ripple/shamap/tests/Traverse.test.cpp>
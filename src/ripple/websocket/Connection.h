@@ -81,7 +81,11 @@ public:
         // Just discards the reference
     }
 
-    void send (Json::Value const& jvObj, bool broadcast);
+    void send (Json::Value const& jvObj, bool broadcast) override;
+
+    // Sends a message that was already serialized for all subscribers
+    void send (Json::Value const& jvObj, std::string const& sObj,
+        bool broadcast) override;
 
     void disconnect ();
     static void handle_disconnect(weak_connection_ptr c);
@@ -327,14 +331,22 @@ void ConnectionImpl <WebSocket>::preDestroy ()
 template <class WebSocket>
 void ConnectionImpl <WebSocket>::send (Json::Value const& jvObj, bool broadcast)
 {
-    WriteLog (lsWARNING, ConnectionImpl)
-            << "WebSocket: sending '" << to_string (jvObj);
     connection_ptr ptr = m_connection.lock ();
 
     if (ptr)
         m_handler.send (ptr, jvObj, broadcast);
 }
 
+template <class WebSocket>
+void ConnectionImpl <WebSocket>::send (
+    Json::Value const&, std::string const& sObj, bool broadcast)
+{
+    connection_ptr ptr = m_connection.lock ();
+
+    if (ptr)
+        m_handler.send (ptr, sObj, broadcast);
+}
+
 template <class WebSocket>
 void ConnectionImpl <WebSocket>::disconnect ()
 {
@@ -25,7 +25,7 @@
 #include <ripple/core/JobQueue.h>
 #include <ripple/protocol/JsonFields.h>
 #include <ripple/server/Port.h>
-#include <ripple/json/json_reader.h>
+#include <ripple/json/FastReader.h>
 #include <ripple/websocket/Connection.h>
 #include <ripple/websocket/WebSocket.h>
 
@@ -378,7 +378,7 @@ public:
                      const wsc_ptr& conn, const message_ptr& mpMessage)
     {
         Json::Value     jvRequest;
-        Json::Reader    jrReader;
+        Json::FastReader jrReader;
 
         try
         {